@@ -4,30 +4,25 @@
 #include <assert.h>
 #include <time.h>
 
-#define MAX_CELL_GRID_WIDTH         100
-#define MAX_CELL_GRID_HEIGHT        100
+#include "../common_src/trace.h"
+#include "../common_src/coverage.h"
+#include "../common_src/coverage_stream.h"
+#include "../common_src/budgets.h"
+#include "../common_src/metrics.h"
 
-#define MAX_TRACE_SIZE              2200000
-#define MAX_NUMBER_OF_VEHICLES      80000
 // max solution size;
 #define MAX_NUMBER_OF_RSUS          1500
 
 #define MAX_INPUT_FILE_PATH_SIZE    100
 
-typedef struct trace_ 
-{
-    int vehicle_id;
-    int time;
-    int grid_x_pos;
-    int grid_y_pos;
-    int r;
-
-} struct_trace;
+#define NUM_POSITIONAL_ARGS         2
 
 typedef struct solution_
 {
     int x;
     int y;
+    // Dense cell of (x, y), see struct_cell_grid;
+    int cell;
 
 } struct_solution;
 
@@ -35,10 +30,26 @@ typedef struct baseline_input_
 {
     int number_of_most_frequent_cells_to_pick;
 
+    // Sweep mode (--budgets): every budget is solved in turn instead of <num of most frequent cells>;
+    int is_sweep;
+    struct_budgets budgets;
+
+    // Only used to count the coverage curve, as n-deployment does (--tau, --contacts);
+    struct_budgets taus;
+    int number_of_contacts;
+
+    // Trace reduced in chunks of about this many MB instead of read whole (--stream), 0 to read it whole;
+    int stream_chunk_size_in_mb;
+
+    // Wall clock time of counting the records of each cell, added to the time of every budget
+    // (0 with --stream, where they come with the reduced trace);
+    double counting_execution_time;
+
 } struct_baseline_input;
 
 typedef struct baseline_output_
 {
+    // Wall clock time of counting the records of each cell and picking;
     double total_execution_time;
     struct_solution solution[MAX_NUMBER_OF_RSUS];
     int solution_size;
@@ -52,20 +63,22 @@ int read_commandline_args(int argc, char **argv, struct_baseline_input *output_b
 char* output_input_file_path, char* output_error_msg);
 int try_to_get_positive_int_from_arg(char* arg, char* var_name, int* output, 
 char* output_error_msg);
-
-// If succeedes, returns 0 and output_trace and output_trace_size can be used;
-// Otherwise, returns 1 and error_msg can be used;
-int read_trace(const char* trace_file_name, struct_trace *output_trace, int *output_trace_size, 
+// Options are "--name value" pairs accepted anywhere among the positional arguments;
+int read_commandline_option(char* name, char* value, struct_baseline_input *output_baseline_input, 
 char* output_error_msg);
 // ==================== INPUT FUNCTIONS ==================== //
 
 
 // ==================== BASELINE FUNTCIONS ================= //
-void baseline(struct_trace* trace, int trace_size, struct_baseline_input baseline_input,
-struct_baseline_output* output_baseline_output);
-int get_num_frequented_cells(int matrix[MAX_CELL_GRID_WIDTH][MAX_CELL_GRID_HEIGHT]);
-void get_max_cell_coords_and_zero_it(int matrix[MAX_CELL_GRID_WIDTH][MAX_CELL_GRID_HEIGHT], 
-int *output_x_coord, int* output_y_coord);
+// cell_records: records of each dense cell of grid, counted once for all budgets;
+// The picking time is added to the construct phase of metrics;
+// If succeedes, returns 0 and output_baseline_output can be used;
+// Otherwise, returns 1 and error_msg can be used;
+int baseline(struct_cell_grid* grid, const int* cell_records, struct_baseline_input baseline_input,
+struct_baseline_output* output_baseline_output, struct_run_metrics *metrics, char* output_error_msg);
+int get_num_frequented_cells(int *matrix, int num_cells);
+// Cells are scanned in row-major order, so ties go to the first (x, y) as in the grid scan;
+int get_max_cell_and_zero_it(int *matrix, int num_cells);
 // ==================== BASELINE FUNCTIONS ================= //
 
 
@@ -74,6 +87,13 @@ int write_summary_to_file(struct_baseline_input baseline_input,
 struct_baseline_output baseline_output, char* output_error_msg);
 int write_rsus_to_file(struct_baseline_input baseline_input, 
 struct_baseline_output baseline_output, char* output_error_msg);
+// Solutions of smaller budgets are prefixes of this one, so the file gives the coverage of every budget
+// up to the solution size;
+int write_coverage_curve_to_file(struct_baseline_input baseline_input, 
+struct_baseline_output baseline_output, struct_coverage_indexes *curve_indexes, char* output_error_msg);
+// Per phase wall and CPU times and counters of the run, n=<budget>_metrics.json;
+int write_baseline_metrics_to_file(struct_baseline_input baseline_input, 
+struct_run_metrics *metrics, char* output_error_msg);
 // ==================== OUTPUT FUNCTIONS ==================== //
 
 
@@ -86,7 +106,10 @@ int main(int argc, char** argv)
 
     // ==================== 1 - READ INPUT ==================== //
 
-    const char* correct_input_format = "USAGE: baseline <num of most frequent cells> <trace file path>";
+    const char* correct_input_format = "USAGE: baseline <num of most frequent cells> <trace file path> "
+    "[--tau <contacts time thresholds, min:max:step or list t1,t2,...>] [--contacts <num of contacts>] "
+    "[--stream <chunk size in MB>]\n"
+    "       baseline --budgets <min:max:step or list b1,b2,...> <trace file path> [...]";
 
     // -------------------- 1.1 COMMAND LINE ------------------ //
 
@@ -103,48 +126,235 @@ int main(int argc, char** argv)
 
     // -------------------- 1.2 TRACE FILE -------------------- //
 
-    struct_trace *trace = (struct_trace *) malloc(sizeof(struct_trace) * MAX_TRACE_SIZE);
-    if (!trace)
+    struct_run_metrics metrics;
+    init_run_metrics(&metrics);
+    baseline_input.counting_execution_time = 0;
+
+    // One index up to the biggest threshold scores all of them;
+    int max_tau = 0;
+    int t;
+    for (t = 0; t < baseline_input.taus.num_budgets; t++)
     {
-        printf("BASELINE: MEMORY ERROR: can't allocate memory"
-        " for %d trace lines (MAX_TRACE_SIZE)\n", MAX_TRACE_SIZE);
-        return 1;
+        if (baseline_input.taus.budgets[t] > max_tau)
+        {
+            max_tau = baseline_input.taus.budgets[t];
+        }
     }
 
-    int trace_size;
-    status = read_trace(input_file_path, trace, &trace_size, error_msg);
-    if (status != 0)
+    // Only the records of each cell are needed, the trace goes once they are counted;
+    struct_cell_grid grid;
+    int* cell_records;
+    struct_coverage_indexes curve_indexes;
+    struct_trace_read_stats trace_read_stats;
+    begin_metrics_phase(&metrics, METRICS_PHASE_LOAD);
+    if (baseline_input.stream_chunk_size_in_mb > 0)
     {
-        printf("BASELINE: INPUT TRACE FILE ERROR: %s\n", error_msg);
-        free(trace);
-        return 1;
+        // The trace is reduced chunk by chunk, it's never whole in memory;
+        struct_reduced_trace reduced_trace;
+        status = reduce_trace_in_chunks(input_file_path, (size_t) baseline_input.stream_chunk_size_in_mb * 1000000,
+        max_tau, &max_tau, 1, &reduced_trace, &trace_read_stats, error_msg);
+        if (status != 0)
+        {
+            printf("BASELINE: INPUT TRACE FILE ERROR: %s\n", error_msg);
+            return 1;
+        }
+
+        printf("BASELINE: TRACE FILE: %lld lines, %.1f MB %s reduced in %d chunks of up to %d lines in %.3f s (%.1f MB/s)\n",
+        reduced_trace.size, trace_read_stats.file_size_in_bytes / 1e6,
+        trace_read_stats.is_binary_format ? "binary" : "text", reduced_trace.num_chunks, reduced_trace.max_chunk_size,
+        trace_read_stats.read_time_in_secs, trace_read_stats.throughput_in_mb_per_sec);
+
+        grid = reduced_trace.grid;
+        cell_records = reduced_trace.cell_records;
+        curve_indexes = reduced_trace.indexes[0];
+        free(reduced_trace.cell_visits);
+        end_metrics_phase(&metrics, METRICS_PHASE_LOAD);
+        add_metrics_counter(&metrics, METRICS_COUNTER_RECORDS_SCANNED, reduced_trace.size);
+    }
+    else
+    {
+        struct_trace trace;
+        status = read_trace(input_file_path, &trace, &trace_read_stats, error_msg);
+        if (status != 0)
+        {
+            printf("BASELINE: INPUT TRACE FILE ERROR: %s\n", error_msg);
+            return 1;
+        }
+
+        printf("BASELINE: TRACE FILE: %d lines, %.1f MB %s read in %.3f s (%.1f MB/s)\n",
+        trace.size, trace_read_stats.file_size_in_bytes / 1e6,
+        trace_read_stats.is_binary_format ? "binary" : "text",
+        trace_read_stats.read_time_in_secs, trace_read_stats.throughput_in_mb_per_sec);
+        end_metrics_phase(&metrics, METRICS_PHASE_LOAD);
+        add_metrics_counter(&metrics, METRICS_COUNTER_RECORDS_SCANNED, trace.size);
+        begin_metrics_phase(&metrics, METRICS_PHASE_INDEX);
+
+        cell_records = (int*) calloc((size_t) (trace.grid.num_cells > 0 ? trace.grid.num_cells : 1), sizeof(int));
+        status = (cell_records == NULL) ? 1 : copy_cell_grid(&(trace.grid), &grid, error_msg);
+        if (status != 0)
+        {
+            printf("BASELINE: MEMORY ERROR: can't allocate memory for the frequency of %d cells\n", trace.grid.num_cells);
+            free(cell_records);
+            free_trace(&trace);
+            return 1;
+        }
+
+        struct_metrics_timer counting_timer;
+        start_metrics_timer(&counting_timer);
+        int i;
+        for (i = 0; i < trace.size; i++)
+        {
+            cell_records[ trace.cell[i] ] += 1;
+        }
+        double counting_cpu_time;
+        read_metrics_timer(&counting_timer, &(baseline_input.counting_execution_time), &counting_cpu_time);
+
+        status = build_coverage_indexes(&trace, max_tau, &curve_indexes, error_msg);
+        free_trace(&trace);
+        if (status != 0)
+        {
+            printf("BASELINE: MEMORY ERROR: %s\n", error_msg);
+            free(cell_records);
+            free_cell_grid(&grid);
+            free_budgets(&(baseline_input.taus));
+            if (baseline_input.is_sweep)
+            {
+                free_budgets(&(baseline_input.budgets));
+            }
+            return 1;
+        }
+        end_metrics_phase(&metrics, METRICS_PHASE_INDEX);
     }
 
-    // ==================== 2 - RUN =========================== //
+    // ==================== 2 - RUN AND WRITE RESULTS ============ //
+
+    // Sweep table: one line per budget;
+    FILE* sweep_file = NULL;
+    if (baseline_input.is_sweep)
+    {
+        char sweep_file_name[MAX_BUDGETS_LABEL_SIZE + 100];
+        sprintf(sweep_file_name, "n=%s_sweep.csv", baseline_input.budgets.label);
+
+        sweep_file = fopen(sweep_file_name, "w");
+        if (sweep_file == NULL)
+        {
+            printf("BASELINE: OUTPUT SWEEP FILE ERROR: can't open file \"%s\"\n", sweep_file_name);
+            free(cell_records);
+            free_cell_grid(&grid);
+            free_coverage_indexes(&curve_indexes);
+            free_budgets(&(baseline_input.budgets));
+            return 1;
+        }
+        fprintf(sweep_file, "budget,n_rsus,execution_time,sweep_wall_clock_time\n");
+    }
 
-    struct_baseline_output baseline_output;
-    baseline(trace, trace_size, baseline_input, &baseline_output);
+    struct timespec sweep_begin_timer;
+    clock_gettime(CLOCK_MONOTONIC, &sweep_begin_timer);
 
-    // ==================== 3 - WRITE RESULTS ================= //
+    int num_budgets = baseline_input.is_sweep ? baseline_input.budgets.num_budgets : 1;
+    int b;
 
-    status = write_summary_to_file(baseline_input, baseline_output, error_msg);
-    if (status != 0)
+    // Smaller solutions are prefixes of the biggest one, so only its coverage curve is written;
+    int curve_budget = baseline_input.number_of_most_frequent_cells_to_pick;
+    if (baseline_input.is_sweep)
     {
-        printf("BASELINE: OUTPUT SUMMARY FILE ERROR: %s\n", error_msg);
-        free(trace);
-        return 1;
+        curve_budget = 0;
+        for (b = 0; b < num_budgets; b++)
+        {
+            if (baseline_input.budgets.budgets[b] > curve_budget)
+            {
+                curve_budget = baseline_input.budgets.budgets[b];
+            }
+        }
     }
 
-    status = write_rsus_to_file(baseline_input, baseline_output, error_msg);
-    if (status != 0)
+    for (b = 0; b < num_budgets; b++)
     {
-        printf("BASELINE: OUTPUT RSUS FILE ERROR: %s\n", error_msg);
-        free(trace);
-        return 1;
+        if (baseline_input.is_sweep)
+        {
+            baseline_input.number_of_most_frequent_cells_to_pick = baseline_input.budgets.budgets[b];
+        }
+
+        // Each budget gets the shared load and index phases, as a run with that budget would;
+        struct_run_metrics budget_metrics = metrics;
+
+        struct_baseline_output baseline_output;
+        status = baseline(&grid, cell_records, baseline_input, &baseline_output, &budget_metrics, error_msg);
+        if (status != 0)
+        {
+            printf("BASELINE: MEMORY ERROR: %s\n", error_msg);
+            free(cell_records);
+            free_cell_grid(&grid);
+            free_coverage_indexes(&curve_indexes);
+            if (baseline_input.is_sweep)
+            {
+                fclose(sweep_file);
+                free_budgets(&(baseline_input.budgets));
+            }
+            return 1;
+        }
+
+        begin_metrics_phase(&budget_metrics, METRICS_PHASE_OUTPUT);
+        status = write_summary_to_file(baseline_input, baseline_output, error_msg);
+        if (status == 0)
+        {
+            status = write_rsus_to_file(baseline_input, baseline_output, error_msg);
+        }
+        if (status == 0 && baseline_input.number_of_most_frequent_cells_to_pick == curve_budget)
+        {
+            status = write_coverage_curve_to_file(baseline_input, baseline_output, &curve_indexes, error_msg);
+            // Once, even if the biggest budget is listed twice;
+            curve_budget = 0;
+        }
+        end_metrics_phase(&budget_metrics, METRICS_PHASE_OUTPUT);
+        if (status == 0)
+        {
+            status = write_baseline_metrics_to_file(baseline_input, &budget_metrics, error_msg);
+        }
+        if (status != 0)
+        {
+            printf("BASELINE: OUTPUT FILE ERROR: %s\n", error_msg);
+            free(cell_records);
+            free_cell_grid(&grid);
+            free_coverage_indexes(&curve_indexes);
+            if (baseline_input.is_sweep)
+            {
+                fclose(sweep_file);
+                free_budgets(&(baseline_input.budgets));
+            }
+            return 1;
+        }
+
+        if (baseline_input.is_sweep)
+        {
+            struct timespec sweep_timer;
+            clock_gettime(CLOCK_MONOTONIC, &sweep_timer);
+
+            fprintf(sweep_file, "%d,%d,%.06f,%.06f\n", baseline_input.number_of_most_frequent_cells_to_pick,
+            baseline_output.solution_size, baseline_output.total_execution_time,
+            (sweep_timer.tv_sec - sweep_begin_timer.tv_sec) + (sweep_timer.tv_nsec - sweep_begin_timer.tv_nsec) / 1e9);
+        }
     }
 
-    // ==================== 4 - FREE REMAINING RESOURCES ====== //
-    free(trace);
+    if (baseline_input.is_sweep)
+    {
+        struct timespec sweep_end_timer;
+        clock_gettime(CLOCK_MONOTONIC, &sweep_end_timer);
+
+        printf("BASELINE: SWEEP: %d budgets solved in %.3f s\n", num_budgets,
+        (sweep_end_timer.tv_sec - sweep_begin_timer.tv_sec) + (sweep_end_timer.tv_nsec - sweep_begin_timer.tv_nsec) / 1e9);
+
+        fclose(sweep_file);
+        free_budgets(&(baseline_input.budgets));
+    }
+
+    printf("BASELINE: PEAK RSS: %.1f MB\n", get_peak_rss_in_mb());
+
+    // ==================== 3 - FREE REMAINING RESOURCES ====== //
+    free(cell_records);
+    free_cell_grid(&grid);
+    free_coverage_indexes(&curve_indexes);
+    free_budgets(&(baseline_input.taus));
     
     return 0;
 }
@@ -152,25 +362,83 @@ int main(int argc, char** argv)
 int read_commandline_args(int argc, char **argv, struct_baseline_input *output_n_deployment_input, 
 char* output_input_file_path, char* output_error_msg)
 {
-    if (argc != 3)
+    int status;
+
+    // ========== Split options from positional arguments; ========== //
+    output_n_deployment_input->is_sweep = 0;
+    output_n_deployment_input->taus.num_budgets = 0;
+    output_n_deployment_input->number_of_contacts = 1;
+    output_n_deployment_input->stream_chunk_size_in_mb = 0;
+
+    // argv-like: program name, then the positional arguments in order;
+    char* positional_args[NUM_POSITIONAL_ARGS + 1];
+    positional_args[0] = argv[0];
+    int num_positional_args = 0;
+    int i;
+    for (i = 1; i < argc; i++)
     {
-        strcpy(output_error_msg, "wrong number of arguments");
-        return 1;
+        if (strncmp(argv[i], "--", 2) == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                sprintf(output_error_msg, "option %s needs a value", argv[i]);
+                return 1;
+            }
+
+            status = read_commandline_option(argv[i], argv[i + 1], output_n_deployment_input, output_error_msg);
+            if (status != 0)
+            {
+                return 1;
+            }
+            i++;
+        }
+        else if (num_positional_args < NUM_POSITIONAL_ARGS)
+        {
+            positional_args[++num_positional_args] = argv[i];
+        }
+        else
+        {
+            strcpy(output_error_msg, "wrong number of arguments");
+            return 1;
+        }
     }
 
-    // ========== Try to convert all arguments to correct numeric values; ========== //
-    int status;
+    // In sweep mode, --budgets takes the place of <num of most frequent cells>;
+    if (output_n_deployment_input->is_sweep)
+    {
+        if (num_positional_args != NUM_POSITIONAL_ARGS - 1)
+        {
+            strcpy(output_error_msg, "wrong number of arguments");
+            return 1;
+        }
 
-    status = try_to_get_positive_int_from_arg(argv[1], "<num of most frequent cells>", 
-    &(output_n_deployment_input->number_of_most_frequent_cells_to_pick), output_error_msg);
-    if (status != 0)
+        for (i = NUM_POSITIONAL_ARGS; i > 1; i--)
+        {
+            positional_args[i] = positional_args[i - 1];
+        }
+        positional_args[1] = NULL;
+    }
+    else if (num_positional_args != NUM_POSITIONAL_ARGS)
     {
+        strcpy(output_error_msg, "wrong number of arguments");
         return 1;
     }
-    if (output_n_deployment_input->number_of_most_frequent_cells_to_pick > MAX_NUMBER_OF_RSUS)
-    {        
-        sprintf(output_error_msg, "number of most frequent cells must be at most %d", MAX_NUMBER_OF_RSUS);
-        return 1;
+    argv = positional_args;
+
+    // ========== Try to convert all arguments to correct numeric values; ========== //
+    if (!output_n_deployment_input->is_sweep)
+    {
+        status = try_to_get_positive_int_from_arg(argv[1], "<num of most frequent cells>", 
+        &(output_n_deployment_input->number_of_most_frequent_cells_to_pick), output_error_msg);
+        if (status != 0)
+        {
+            return 1;
+        }
+        if (output_n_deployment_input->number_of_most_frequent_cells_to_pick > MAX_NUMBER_OF_RSUS)
+        {        
+            sprintf(output_error_msg, "number of most frequent cells must be at most %d", MAX_NUMBER_OF_RSUS);
+            return 1;
+        }
     }
     
     // ========== try to get input file path ========== //
@@ -184,122 +452,108 @@ char* output_input_file_path, char* output_error_msg)
         strcpy(output_input_file_path, argv[2]);
     }
 
-    return 0;
-}
-
-// Get int from command line argument;
-// IMPORTANT: Assumes int is big enough for converted value;
-int try_to_get_positive_int_from_arg(char* arg, char* var_name, int* output, 
-char* output_error_msg)
-{
-    int value = atoi(arg);
-    if (value <= 0)
+    if (output_n_deployment_input->taus.num_budgets == 0)
     {
-        sprintf(output_error_msg, "%s must be a positive integer", var_name);
+        status = parse_taus("30", MAX_TAU_LIST_VALUE, &(output_n_deployment_input->taus), output_error_msg);
+        if (status != 0)
+        {
+            return 1;
+        }
+    }
+    else if (output_n_deployment_input->taus.num_budgets > 1 && output_n_deployment_input->number_of_contacts != 1)
+    {
+        strcpy(output_error_msg, "a list of --tau thresholds needs --contacts 1");
         return 1;
     }
 
-    *output = value;
-
     return 0;
 }
 
-// IMPORTANT: 
-// Assumes, for each vehicle, its trace is composed by adjacent lines,
-// int is big enough for every value, no line is bigger than 200 bytes,
-// and fields are integers separated only by ';' and line ends with ';';
-int read_trace(const char* trace_file_name, struct_trace* output_trace, int *output_trace_size, 
+int read_commandline_option(char* name, char* value, struct_baseline_input *output_baseline_input, 
 char* output_error_msg)
 {
-    int num_seen_vehicles = 0;
-    int last_seen_vehicle_id = -1;
-
-    FILE* f_stream = fopen(trace_file_name, "r");
-
-    if (f_stream == NULL)
+    if (strcmp(name, "--budgets") == 0)
     {
-        sprintf(output_error_msg, "can't open file \"%s\"", trace_file_name);
-        return 1;
-    }
-
-    char line_buffer[201];
-    struct_trace aux;
-    int num_read_lines = 0;
-    while (fgets(line_buffer, sizeof(line_buffer), f_stream) != NULL)
-    {
-        if (num_read_lines == MAX_TRACE_SIZE)
-        {   
-            sprintf(output_error_msg, "file \"%s\" is too big (max is %d lines)", 
-            trace_file_name, MAX_TRACE_SIZE);
-            fclose(f_stream);
+        if (output_baseline_input->is_sweep)
+        {
+            strcpy(output_error_msg, "option --budgets given twice");
             return 1;
         }
 
-        sscanf(line_buffer, "%d;%d;%d;%d;%d;",
-        &(aux.vehicle_id), &(aux.time), &(aux.grid_x_pos), &(aux.grid_y_pos), &(aux.r));
-     
-        if (aux.vehicle_id != last_seen_vehicle_id)
+        int status = parse_budgets(value, MAX_NUMBER_OF_RSUS, &(output_baseline_input->budgets), output_error_msg);
+        if (status != 0)
         {
-            num_seen_vehicles++;
-            last_seen_vehicle_id = aux.vehicle_id;
-        }
-
-        if (num_seen_vehicles > MAX_NUMBER_OF_VEHICLES)
-        {   
-            sprintf(output_error_msg, 
-            "file \"%s\" contains a vehicle with id equal or bigger than %d in line %d (limit is %d vehicles)",
-            trace_file_name, MAX_NUMBER_OF_VEHICLES - 1, num_read_lines + 1, MAX_NUMBER_OF_VEHICLES);
-            fclose(f_stream);
             return 1;
         }
+        output_baseline_input->is_sweep = 1;
+
+        return 0;
+    }
 
-        if (!(
-            ((0 <= aux.grid_x_pos) && (aux.grid_x_pos < MAX_CELL_GRID_WIDTH)) && 
-            ((0 <= aux.grid_y_pos) && (aux.grid_y_pos < MAX_CELL_GRID_HEIGHT))
-            ))
+    if (strcmp(name, "--tau") == 0)
+    {
+        if (output_baseline_input->taus.num_budgets > 0)
         {
-            sprintf(output_error_msg, 
-            "file \"%s\" contains a cell with coordinates out of bounds in line %d." 
-            " Allowed: (0 <= x < %d) (0 <= y < %d)", 
-            trace_file_name, num_read_lines + 1, MAX_CELL_GRID_WIDTH, MAX_CELL_GRID_HEIGHT);
-            fclose(f_stream);
+            strcpy(output_error_msg, "option --tau given twice");
             return 1;
         }
 
-        output_trace[num_read_lines] = aux;
-        num_read_lines++;
+        return parse_taus(value, MAX_TAU_LIST_VALUE, &(output_baseline_input->taus), output_error_msg);
+    }
+
+    if (strcmp(name, "--contacts") == 0)
+    {
+        return try_to_get_positive_int_from_arg(value, "--contacts", 
+        &(output_baseline_input->number_of_contacts), output_error_msg);
+    }
+
+    if (strcmp(name, "--stream") == 0)
+    {
+        return try_to_get_positive_int_from_arg(value, "--stream", 
+        &(output_baseline_input->stream_chunk_size_in_mb), output_error_msg);
     }
 
-    if (num_read_lines == 0)
+    sprintf(output_error_msg, "unknown option %s", name);
+    return 1;
+}
+
+// Get int from command line argument;
+// IMPORTANT: Assumes int is big enough for converted value;
+int try_to_get_positive_int_from_arg(char* arg, char* var_name, int* output, 
+char* output_error_msg)
+{
+    int value = atoi(arg);
+    if (value <= 0)
     {
-        sprintf(output_error_msg, "file \"%s\" is empty", trace_file_name);
-        fclose(f_stream);
+        sprintf(output_error_msg, "%s must be a positive integer", var_name);
         return 1;
     }
 
-    *output_trace_size = num_read_lines;
+    *output = value;
 
-    fclose(f_stream);
     return 0;
 }
 
-void baseline(struct_trace* trace, int trace_size, struct_baseline_input baseline_input,
-struct_baseline_output* output_baseline_output)
+int baseline(struct_cell_grid* grid, const int* cell_records, struct_baseline_input baseline_input,
+struct_baseline_output* output_baseline_output, struct_run_metrics *metrics, char* output_error_msg)
 {
     int number_of_most_frequent_cells_to_pick = baseline_input.number_of_most_frequent_cells_to_pick;
 
-    int cell_frequency[MAX_CELL_GRID_WIDTH][MAX_CELL_GRID_HEIGHT] = {0};
-
-    clock_t begin_timer = clock();
-
-    int i;
-    for (i = 0; i < trace_size; i++)
+    int num_cells = grid->num_cells;
+    int* cell_frequency = (int*) malloc(sizeof(int) * (size_t) (num_cells > 0 ? num_cells : 1));
+    if (cell_frequency == NULL)
     {
-        cell_frequency[trace[i].grid_x_pos][trace[i].grid_y_pos] += 1;
+        sprintf(output_error_msg, "can't allocate memory for the frequency of %d cells", num_cells);
+        return 1;
     }
 
+    struct_metrics_timer timer;
+    start_metrics_timer(&timer);
+
+    memcpy(cell_frequency, cell_records, sizeof(int) * (size_t) num_cells);
+
     int solution_size = 0;
-    int number_of_frequented_cells = get_num_frequented_cells(cell_frequency);
+    int number_of_frequented_cells = get_num_frequented_cells(cell_frequency, num_cells);
     int solution_size_to_achieve = 
     (number_of_most_frequent_cells_to_pick > number_of_frequented_cells) ? 
     number_of_frequented_cells : number_of_most_frequent_cells_to_pick;
@@ -307,58 +561,57 @@ struct_baseline_output* output_baseline_output)
     while (solution_size < solution_size_to_achieve)
     {
         struct_solution chosen_position;
-        get_max_cell_coords_and_zero_it(cell_frequency, &(chosen_position.x), &(chosen_position.y));
+        chosen_position.cell = get_max_cell_and_zero_it(cell_frequency, num_cells);
+        chosen_position.x = grid->cell_x[chosen_position.cell];
+        chosen_position.y = grid->cell_y[chosen_position.cell];
 
         output_baseline_output->solution[solution_size] = chosen_position;
         solution_size += 1;
     }
 
-    clock_t end_timer = clock();
-    double execution_time_in_secs = (double) (end_timer - begin_timer) / CLOCKS_PER_SEC;
+    double execution_time_in_secs;
+    double cpu_time_in_secs;
+    read_metrics_timer(&timer, &execution_time_in_secs, &cpu_time_in_secs);
+    add_metrics_phase_time(metrics, METRICS_PHASE_CONSTRUCT, execution_time_in_secs, cpu_time_in_secs, 1);
+
+    free(cell_frequency);
 
-    output_baseline_output->total_execution_time = execution_time_in_secs;
+    output_baseline_output->total_execution_time = baseline_input.counting_execution_time + execution_time_in_secs;
     output_baseline_output->solution_size = solution_size;
+
+    return 0;
 }
 
-int get_num_frequented_cells(int matrix[MAX_CELL_GRID_WIDTH][MAX_CELL_GRID_HEIGHT])
+int get_num_frequented_cells(int *matrix, int num_cells)
 {
     int num_frequented_cells = 0;
-    int i, j;
-    for (i = 0; i < MAX_CELL_GRID_WIDTH; i++)
+    int i;
+    for (i = 0; i < num_cells; i++)
     {
-        for (j = 0; j < MAX_CELL_GRID_HEIGHT; j++)
+        if (matrix[i] != 0)
         {
-            if (matrix[i][j] != 0)
-            {
-                num_frequented_cells += 1;
-            }
+            num_frequented_cells += 1;
         }
     }
 
     return num_frequented_cells;
 }
 
-void get_max_cell_coords_and_zero_it(int matrix[MAX_CELL_GRID_WIDTH][MAX_CELL_GRID_HEIGHT], 
-int *output_x_coord, int* output_y_coord)
+int get_max_cell_and_zero_it(int *matrix, int num_cells)
 {
-    int max_x = 0;
-	int max_y = 0;
-	int i, j;
-	for (i = 0; i < MAX_CELL_GRID_WIDTH; i++)
+    int max_cell = 0;
+	int i;
+	for (i = 0; i < num_cells; i++)
 	{
-		for (j = 0; j < MAX_CELL_GRID_HEIGHT; j++)
+		if (matrix[i] > matrix[max_cell])
 		{
-			if (matrix[i][j] > matrix[max_x][max_y])
-			{
-				max_x = i;
-				max_y = j;
-			}
+			max_cell = i;
 		}
 	}
 	
-	matrix[max_x][max_y] = 0;
-	*output_x_coord = max_x;
-	*output_y_coord = max_y;
+	matrix[max_cell] = 0;
+
+	return max_cell;
 }
 
 int write_summary_to_file(struct_baseline_input baseline_input, 
@@ -379,7 +632,12 @@ struct_baseline_output baseline_output, char* output_error_msg)
     
     fprintf(output_file, "N. RSUS TO PICK (INPUT): %d\n", baseline_input.number_of_most_frequent_cells_to_pick);
     fprintf(output_file, "N. RSUS (ACTUAL): %d\n", baseline_output.solution_size);
-    fprintf(output_file, "TOTAL EXECUTION TIME: %.06f\n\n", baseline_output.total_execution_time);
+    if (baseline_input.stream_chunk_size_in_mb > 0)
+    {
+        fprintf(output_file, "TRACE STREAM CHUNK SIZE (MB): %d\n", baseline_input.stream_chunk_size_in_mb);
+    }
+    fprintf(output_file, "TOTAL EXECUTION TIME: %.06f\n", baseline_output.total_execution_time);
+    fprintf(output_file, "PEAK RSS SO FAR (MB): %.1f\n\n", get_peak_rss_in_mb());
 
     fclose(output_file);
 
@@ -411,3 +669,70 @@ struct_baseline_output baseline_output, char* output_error_msg)
 
     return 0;
 }
+
+int write_coverage_curve_to_file(struct_baseline_input baseline_input, 
+struct_baseline_output baseline_output, struct_coverage_indexes *curve_indexes, char* output_error_msg)
+{
+    int num_taus = baseline_input.taus.num_budgets;
+    int solution_cells[MAX_NUMBER_OF_RSUS];
+    int* curve = (int*) malloc(sizeof(int) * (size_t) (baseline_output.solution_size > 0 ? baseline_output.solution_size : 1) * num_taus);
+    if (curve == NULL)
+    {
+        sprintf(output_error_msg, "can't allocate memory for the curve of %d RSUs", baseline_output.solution_size);
+        return 1;
+    }
+
+    int i, t;
+    for (i = 0; i < baseline_output.solution_size; i++)
+    {
+        solution_cells[i] = baseline_output.solution[i].cell;
+    }
+
+    int status = fill_coverage_curve_by_tau(curve_indexes, baseline_input.number_of_contacts,
+    baseline_input.taus.budgets, num_taus, solution_cells, baseline_output.solution_size, curve, output_error_msg);
+    if (status != 0)
+    {
+        free(curve);
+        return 1;
+    }
+
+    char output_file_name[MAX_INPUT_FILE_PATH_SIZE + MAX_BUDGETS_LABEL_SIZE + 100];
+    sprintf(output_file_name, "n=%d_tau=%s_cont=%d_curve.csv", 
+    baseline_input.number_of_most_frequent_cells_to_pick,
+    baseline_input.taus.label, baseline_input.number_of_contacts);
+
+    FILE *output_file = fopen(output_file_name, "w");
+    if (output_file == NULL)
+    {
+        sprintf(output_error_msg, "can't open file \"%s\"", output_file_name);
+        free(curve);
+        return 1;
+    }
+
+    // One coverage column per threshold, in the order of --tau;
+    for (i = 0; i < baseline_output.solution_size; i++)
+    {
+        struct_solution pos = baseline_output.solution[i];
+        fprintf(output_file, "%d,%d,%d", i + 1, pos.x, pos.y);
+        for (t = 0; t < num_taus; t++)
+        {
+            fprintf(output_file, ",%d", curve[(size_t) i * num_taus + t]);
+        }
+        fprintf(output_file, "\n");
+    }
+
+    fclose(output_file);
+    free(curve);
+
+    return 0;
+}
+
+int write_baseline_metrics_to_file(struct_baseline_input baseline_input, 
+struct_run_metrics *metrics, char* output_error_msg)
+{
+    char output_file_name[MAX_INPUT_FILE_PATH_SIZE + 100];
+    sprintf(output_file_name, "n=%d_metrics.json", 
+    baseline_input.number_of_most_frequent_cells_to_pick);
+
+    return write_metrics_to_file(output_file_name, "baseline", metrics, output_error_msg);
+}
@@ -8,6 +8,15 @@ BASELINE_DIR=.
 INPUT_DIR=..
 INPUT_PATH="${INPUT_DIR}/6_to_8am.csv"
 
+# Convert the text trace once, every run below maps the binary trace instead of parsing it;
+COMMON_DIR=../common_src
+BIN_INPUT_PATH="${INPUT_PATH%.csv}.bin"
+if [ ! -f "$BIN_INPUT_PATH" ] || [ "$INPUT_PATH" -nt "$BIN_INPUT_PATH" ]
+then
+    $COMMON_DIR/trace-convert "$INPUT_PATH" "$BIN_INPUT_PATH" || exit 1
+fi
+INPUT_PATH="$BIN_INPUT_PATH"
+
 RESULTS_DIR=baseline_results
 
 MIN_N_RSUS=43
@@ -19,10 +28,11 @@ mkdir "$RESULTS_DIR"
 
 mkdir "$RESULTS_DIR/rsu=[${MIN_N_RSUS}_${MAX_N_RSUS}_${N_RSUS_STEP}]"
 
-for ((n_rsus = $MIN_N_RSUS; n_rsus <= $MAX_N_RSUS; n_rsus += $N_RSUS_STEP))
-do
-  $BASELINE_DIR/baseline "$n_rsus" "$INPUT_PATH"
+# One process for all budgets, the trace is read once;
+$BASELINE_DIR/baseline "$INPUT_PATH" --budgets "${MIN_N_RSUS}:${MAX_N_RSUS}:${N_RSUS_STEP}" || exit 1
 
-  rm *summary*
-  mv *rsus* "$RESULTS_DIR/rsu=[${MIN_N_RSUS}_${MAX_N_RSUS}_${N_RSUS_STEP}]"
-done
\ No newline at end of file
+rm *summary*
+mv *rsus* "$RESULTS_DIR/rsu=[${MIN_N_RSUS}_${MAX_N_RSUS}_${N_RSUS_STEP}]"
+mv *sweep.csv "$RESULTS_DIR"
+# Coverage of every budget up to MAX_N_RSUS;
+mv *curve.csv "$RESULTS_DIR"
\ No newline at end of file
@@ -0,0 +1,751 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <dirent.h>
+
+// The kernels timed are n-deployment's own functions, not copies of them;
+#define N_DEPLOYMENT_NO_MAIN
+#include "../grasp_src/n-deployment.c"
+
+#define MAX_BENCH_FILE_PATH_SIZE    1000
+
+// <trace file path>;
+#define NUM_BENCH_POSITIONAL_ARGS   1
+
+#define MAX_NUM_FIXTURES            20
+
+#define MAX_REPETITIONS             10000
+
+#define MAX_FIXTURE_VEHICLES        100000000
+
+typedef struct bench_input_
+{
+    // GRASP parameters of the timed iteration, as n-deployment's arguments;
+    struct_n_deployment_input n_deployment_input;
+
+    int num_repetitions;
+
+    // Fixtures are the first vehicles of the trace, one per size, plus the whole trace;
+    struct_budgets fixture_sizes;
+
+    // Fixture files and rsus files are written in a directory made in here, removed at the end (--work-dir);
+    char work_dir[MAX_BENCH_FILE_PATH_SIZE + 1];
+    // --output, "bench.csv" by default;
+    char output_file_path[MAX_BENCH_FILE_PATH_SIZE + 1];
+
+} struct_bench_input;
+
+typedef struct bench_result_
+{
+    const char* kernel_name;
+    int num_vehicles;
+    int num_records;
+    int num_repetitions;
+    double median_time;
+    double min_time;
+    double max_time;
+
+} struct_bench_result;
+
+// Timings of the repetitions of one kernel;
+typedef struct bench_timer_
+{
+    int num_repetitions;
+    double *times;
+    struct timespec begin;
+
+} struct_bench_timer;
+
+// ==================== INPUT FUNCTIONS ==================== //
+// If succeedes, returns 0 and output_bench_input can be used (release it with free_budgets() of fixture_sizes);
+// Otherwise, returns 1 and error_msg can be used;
+int read_bench_args(
+    int argc, char **argv,
+    struct_bench_input *output_bench_input,
+    char* output_input_file_path, char* output_error_msg
+);
+
+// Options are "--name value" pairs accepted anywhere among the positional arguments;
+// If succeedes, returns 0 and the option's value is stored in output_bench_input;
+// Otherwise, returns 1 and error_msg can be used;
+int read_bench_option(
+    char* name, char* value,
+    struct_bench_input *output_bench_input,
+    char* output_error_msg
+);
+// ==================== INPUT FUNCTIONS ==================== //
+
+
+// ==================== FIXTURE FUNCTIONS ==================== //
+// Writes the records of the first num_vehicles vehicles of trace, in the format of the trace file;
+// If succeedes, returns 0;
+// Otherwise, returns 1 and error_msg can be used;
+int write_fixture(
+    const char* fixture_file_path,
+    struct_trace *trace, int num_vehicles,
+    int is_binary_format,
+    char* output_error_msg
+);
+// ==================== FIXTURE FUNCTIONS ==================== //
+
+
+// ==================== BENCH FUNCTIONS ==================== //
+// Times every kernel on the fixture, appending one result per kernel to output_results;
+// rsus files are written in rsus_dir;
+// If succeedes, returns 0;
+// Otherwise, returns 1 and error_msg can be used;
+int bench_fixture(
+    struct_bench_input *bench_input,
+    const char* fixture_file_path,
+    const char* rsus_dir,
+    struct_bench_timer *timer,
+    struct_bench_result *output_results, int *output_num_results,
+    char* output_error_msg
+);
+
+void start_repetition(struct_bench_timer *timer);
+void stop_repetition(struct_bench_timer *timer, int repetition);
+
+// Median, min and max of the timer's repetitions;
+void fill_bench_result(
+    struct_bench_timer *timer,
+    const char* kernel_name,
+    int num_vehicles, int num_records,
+    struct_bench_result *output_result
+);
+
+int compare_times(const void* a, const void* b);
+
+// Removes the files of work_dir, then work_dir;
+// Returns 0 if work_dir is gone;
+int remove_work_dir(const char* work_dir);
+// ==================== BENCH FUNCTIONS ==================== //
+
+
+// ==================== OUTPUT FUNCTIONS ==================== //
+int write_bench_results_to_file(
+    const char* output_file_path,
+    struct_bench_result *results, int num_results,
+    char* output_error_msg
+);
+// ==================== OUTPUT FUNCTIONS ==================== //
+
+
+int main(int argc, char **argv)
+{
+    // In case any specified error below occurs;
+    int status;
+    char error_msg[MAX_BENCH_FILE_PATH_SIZE + 300];
+    error_msg[0] = '\0';
+
+    // ==================== 1 - READ INPUT ==================== //
+
+    const char* correct_input_format = "USAGE: bench <trace file path> "
+    "[--repetitions <num of repetitions>] [--vehicles <fixture sizes, min:max:step or list v1,v2,...>] "
+    "[--rsus <num of rsus>] [--tau <contacts time threshold>] [--rcl <GRASP's rcl length>] "
+    "[--contacts <num of contacts>] [--work-dir <directory>] [--output <output file path>]";
+
+    char input_file_path[MAX_BENCH_FILE_PATH_SIZE + 1];
+    input_file_path[0] = '\0';
+    struct_bench_input bench_input;
+    status = read_bench_args(argc, argv, &bench_input, input_file_path, error_msg);
+    if (status != 0)
+    {
+        fprintf(stderr, "BENCH: COMMAND LINE ERROR: %s\n\n%s\n", error_msg, correct_input_format);
+        return 1;
+    }
+
+    // The whole trace is read once to cut the fixtures from;
+    struct_trace trace;
+    struct_trace_read_stats trace_read_stats;
+    status = read_trace(input_file_path, &trace, &trace_read_stats, error_msg);
+    if (status != 0)
+    {
+        fprintf(stderr, "BENCH: INPUT TRACE FILE ERROR: %s\n", error_msg);
+        free_budgets(&(bench_input.fixture_sizes));
+        return 1;
+    }
+
+    printf("BENCH: TRACE FILE: %d lines, %d vehicles, %.1f MB %s\n", trace.size, trace.num_vehicles,
+    trace_read_stats.file_size_in_bytes / 1e6, trace_read_stats.is_binary_format ? "binary" : "text");
+
+    char fixtures_dir[MAX_BENCH_FILE_PATH_SIZE + 100];
+    sprintf(fixtures_dir, "%s/bench_XXXXXX", bench_input.work_dir);
+    if (mkdtemp(fixtures_dir) == NULL)
+    {
+        fprintf(stderr, "BENCH: OUTPUT FILE ERROR: can't make a directory in %s\n", bench_input.work_dir);
+        free_trace(&trace);
+        free_budgets(&(bench_input.fixture_sizes));
+        return 1;
+    }
+
+    // ==================== 2 - CUT THE FIXTURES ==================== //
+
+    char fixture_file_paths[MAX_NUM_FIXTURES + 1][MAX_BENCH_FILE_PATH_SIZE + 200];
+    int num_fixtures = 0;
+    int f;
+    for (f = 0; f < bench_input.fixture_sizes.num_budgets && status == 0; f++)
+    {
+        int num_vehicles = bench_input.fixture_sizes.budgets[f];
+        if (num_vehicles >= trace.num_vehicles)
+        {
+            printf("BENCH: FIXTURE: %d vehicles skipped, the trace has %d\n", num_vehicles, trace.num_vehicles);
+            continue;
+        }
+
+        sprintf(fixture_file_paths[num_fixtures], "%s/vehicles=%d.%s", fixtures_dir, num_vehicles,
+        trace_read_stats.is_binary_format ? "bin" : "csv");
+        status = write_fixture(fixture_file_paths[num_fixtures], &trace, num_vehicles,
+        trace_read_stats.is_binary_format, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "BENCH: OUTPUT FILE ERROR: %s\n", error_msg);
+            break;
+        }
+        num_fixtures++;
+    }
+    // The whole trace is its own fixture;
+    strcpy(fixture_file_paths[num_fixtures++], input_file_path);
+    free_trace(&trace);
+
+    // ==================== 3 - TIME THE KERNELS ==================== //
+
+    struct_bench_timer timer;
+    timer.num_repetitions = bench_input.num_repetitions;
+    timer.times = (double*) malloc(sizeof(double) * bench_input.num_repetitions);
+    struct_bench_result results[(MAX_NUM_FIXTURES + 1) * 10];
+    int num_results = 0;
+    if (timer.times == NULL && status == 0)
+    {
+        fprintf(stderr, "BENCH: MEMORY ERROR: can't allocate memory for %d repetitions\n", bench_input.num_repetitions);
+        status = 1;
+    }
+
+    for (f = 0; f < num_fixtures && status == 0; f++)
+    {
+        status = bench_fixture(&bench_input, fixture_file_paths[f], fixtures_dir, &timer,
+        results, &num_results, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "BENCH: %s\n", error_msg);
+        }
+    }
+
+    // ==================== 4 - WRITE THE RESULTS ==================== //
+
+    if (status == 0)
+    {
+        int r;
+        printf("BENCH: %-22s %10s %10s %6s %12s %12s %12s %14s\n", "KERNEL", "VEHICLES", "RECORDS", "REPS",
+        "MEDIAN (S)", "MIN (S)", "MAX (S)", "RECORDS/S");
+        for (r = 0; r < num_results; r++)
+        {
+            printf("BENCH: %-22s %10d %10d %6d %12.6f %12.6f %12.6f %14.0f\n", results[r].kernel_name,
+            results[r].num_vehicles, results[r].num_records, results[r].num_repetitions,
+            results[r].median_time, results[r].min_time, results[r].max_time,
+            results[r].num_records / results[r].median_time);
+        }
+
+        status = write_bench_results_to_file(bench_input.output_file_path, results, num_results, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "BENCH: OUTPUT FILE ERROR: %s\n", error_msg);
+        }
+    }
+
+    printf("BENCH: PEAK RSS: %.1f MB\n", get_peak_rss_in_mb());
+
+    // ==================== 5 - FREE REMAINING RESOURCES ====== //
+    remove_work_dir(fixtures_dir);
+    free(timer.times);
+    free_budgets(&(bench_input.fixture_sizes));
+
+    return status;
+}
+
+int read_bench_args(int argc, char **argv, struct_bench_input *output_bench_input,
+char* output_input_file_path, char* output_error_msg)
+{
+    int status;
+
+    // ========== Defaults, those of the n-deployment example; ========== //
+    struct_n_deployment_input* n_deployment_input = &(output_bench_input->n_deployment_input);
+    n_deployment_input->number_of_rsus = 100;
+    n_deployment_input->contacts_time_threshold = 30;
+    n_deployment_input->grasp_rcl_len = 15;
+    n_deployment_input->n_deploy_num_ite = 1;
+    n_deployment_input->number_of_contacts = 1;
+    n_deployment_input->grasp_rng_seed = 123;
+    n_deployment_input->grasp_rng = GRASP_RNG_PHILOX;
+    n_deployment_input->first_iteration = 0;
+    // The construction keeps its coverage, the evaluation is timed on its own;
+    n_deployment_input->eval_kernel = COVERAGE_KERNEL_INCREMENTAL;
+    n_deployment_input->cell_scoring = CELL_SCORING_VISITS;
+    n_deployment_input->local_search = LOCAL_SEARCH_NONE;
+    n_deployment_input->ls_max_moves = 0;
+    n_deployment_input->elite_pool_size = 0;
+    n_deployment_input->time_limit_in_secs = 0;
+    n_deployment_input->target_coverage = 0;
+    n_deployment_input->num_threads = 1;
+    n_deployment_input->stream_chunk_size_in_mb = 0;
+    n_deployment_input->is_sweep = 0;
+    n_deployment_input->taus.num_budgets = 0;
+
+    output_bench_input->num_repetitions = 11;
+    output_bench_input->fixture_sizes.num_budgets = 0;
+    strcpy(output_bench_input->work_dir, "/tmp");
+    strcpy(output_bench_input->output_file_path, "bench.csv");
+
+    char* positional_args[NUM_BENCH_POSITIONAL_ARGS + 1];
+    positional_args[0] = argv[0];
+    int num_positional_args = 0;
+    int i;
+    for (i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--", 2) == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                sprintf(output_error_msg, "option %s needs a value", argv[i]);
+                free_budgets(&(output_bench_input->fixture_sizes));
+                return 1;
+            }
+
+            status = read_bench_option(argv[i], argv[i + 1], output_bench_input, output_error_msg);
+            if (status != 0)
+            {
+                free_budgets(&(output_bench_input->fixture_sizes));
+                return 1;
+            }
+            i++;
+        }
+        else if (num_positional_args < NUM_BENCH_POSITIONAL_ARGS)
+        {
+            positional_args[++num_positional_args] = argv[i];
+        }
+        else
+        {
+            strcpy(output_error_msg, "wrong number of arguments");
+            free_budgets(&(output_bench_input->fixture_sizes));
+            return 1;
+        }
+    }
+
+    if (num_positional_args != NUM_BENCH_POSITIONAL_ARGS)
+    {
+        strcpy(output_error_msg, "wrong number of arguments");
+        free_budgets(&(output_bench_input->fixture_sizes));
+        return 1;
+    }
+
+    if (strlen(positional_args[1]) > MAX_BENCH_FILE_PATH_SIZE)
+    {
+        sprintf(output_error_msg, "file path is bigger than %d bytes", MAX_BENCH_FILE_PATH_SIZE);
+        free_budgets(&(output_bench_input->fixture_sizes));
+        return 1;
+    }
+    strcpy(output_input_file_path, positional_args[1]);
+
+    // The first 10k and 100k vehicles, as the dataset's slices;
+    if (output_bench_input->fixture_sizes.num_budgets == 0)
+    {
+        status = parse_budgets("10000,100000", MAX_FIXTURE_VEHICLES, &(output_bench_input->fixture_sizes), output_error_msg);
+        if (status != 0)
+        {
+            return 1;
+        }
+    }
+    if (output_bench_input->fixture_sizes.num_budgets > MAX_NUM_FIXTURES)
+    {
+        sprintf(output_error_msg, "at most %d fixture sizes", MAX_NUM_FIXTURES);
+        free_budgets(&(output_bench_input->fixture_sizes));
+        return 1;
+    }
+
+    return 0;
+}
+
+int read_bench_option(char* name, char* value,
+struct_bench_input *output_bench_input, char* output_error_msg)
+{
+    struct_n_deployment_input* n_deployment_input = &(output_bench_input->n_deployment_input);
+
+    if (strcmp(name, "--repetitions") == 0)
+    {
+        int status = try_to_get_positive_int_from_arg(value, "--repetitions",
+        &(output_bench_input->num_repetitions), output_error_msg);
+        if (status == 0 && output_bench_input->num_repetitions > MAX_REPETITIONS)
+        {
+            sprintf(output_error_msg, "--repetitions must be at most %d", MAX_REPETITIONS);
+            return 1;
+        }
+
+        return status;
+    }
+
+    if (strcmp(name, "--vehicles") == 0)
+    {
+        if (output_bench_input->fixture_sizes.num_budgets > 0)
+        {
+            strcpy(output_error_msg, "option --vehicles given twice");
+            return 1;
+        }
+
+        return parse_budgets(value, MAX_FIXTURE_VEHICLES, &(output_bench_input->fixture_sizes), output_error_msg);
+    }
+
+    if (strcmp(name, "--rsus") == 0)
+    {
+        int status = try_to_get_positive_int_from_arg(value, "--rsus",
+        &(n_deployment_input->number_of_rsus), output_error_msg);
+        if (status == 0 && n_deployment_input->number_of_rsus > MAX_NUMBER_OF_RSUS)
+        {
+            sprintf(output_error_msg, "number of RSUs must be at most %d", MAX_NUMBER_OF_RSUS);
+            return 1;
+        }
+
+        return status;
+    }
+
+    if (strcmp(name, "--tau") == 0)
+    {
+        return try_to_get_positive_int_from_arg(value, "--tau",
+        &(n_deployment_input->contacts_time_threshold), output_error_msg);
+    }
+
+    if (strcmp(name, "--rcl") == 0)
+    {
+        return try_to_get_positive_int_from_arg(value, "--rcl",
+        &(n_deployment_input->grasp_rcl_len), output_error_msg);
+    }
+
+    if (strcmp(name, "--contacts") == 0)
+    {
+        return try_to_get_positive_int_from_arg(value, "--contacts",
+        &(n_deployment_input->number_of_contacts), output_error_msg);
+    }
+
+    if (strcmp(name, "--work-dir") == 0 || strcmp(name, "--output") == 0)
+    {
+        if (strlen(value) > MAX_BENCH_FILE_PATH_SIZE)
+        {
+            sprintf(output_error_msg, "%s is bigger than %d bytes", name, MAX_BENCH_FILE_PATH_SIZE);
+            return 1;
+        }
+
+        strcpy((strcmp(name, "--work-dir") == 0) ? output_bench_input->work_dir : output_bench_input->output_file_path, value);
+        return 0;
+    }
+
+    sprintf(output_error_msg, "unknown option %s", name);
+    return 1;
+}
+
+int write_fixture(const char* fixture_file_path, struct_trace *trace, int num_vehicles,
+int is_binary_format, char* output_error_msg)
+{
+    int num_records = trace->vehicle_offsets[num_vehicles];
+
+    if (is_binary_format)
+    {
+        // The first records and vehicle offsets are a trace of their own, the grid sides are kept;
+        struct_trace fixture = *trace;
+        fixture.size = num_records;
+        fixture.num_vehicles = num_vehicles;
+
+        return write_binary_trace(fixture_file_path, &fixture, output_error_msg);
+    }
+
+    FILE* fixture_file = fopen(fixture_file_path, "w");
+    if (fixture_file == NULL)
+    {
+        sprintf(output_error_msg, "can't write fixture file %s", fixture_file_path);
+        return 1;
+    }
+
+    int i;
+    for (i = 0; i < num_records; i++)
+    {
+        fprintf(fixture_file, "%d;%d;%d;%d;%d;\n", trace->vehicle_id[i], trace->time[i],
+        trace->grid_x_pos[i], trace->grid_y_pos[i], trace->r[i]);
+    }
+
+    if (fclose(fixture_file) != 0)
+    {
+        sprintf(output_error_msg, "can't write fixture file %s", fixture_file_path);
+        return 1;
+    }
+
+    return 0;
+}
+
+int bench_fixture(struct_bench_input *bench_input, const char* fixture_file_path, const char* rsus_dir,
+struct_bench_timer *timer, struct_bench_result *output_results, int *output_num_results,
+char* output_error_msg)
+{
+    int status;
+    int repetition;
+    struct_trace trace;
+    struct_trace_read_stats trace_read_stats;
+    struct_n_deployment_input n_deployment_input = bench_input->n_deployment_input;
+
+    // -------------------- read_trace ------------------------ //
+    // Untimed first read, so every repetition finds the file in the page cache;
+    status = read_trace(fixture_file_path, &trace, &trace_read_stats, output_error_msg);
+    if (status != 0)
+    {
+        return 1;
+    }
+    for (repetition = 0; repetition < timer->num_repetitions; repetition++)
+    {
+        free_trace(&trace);
+
+        start_repetition(timer);
+        status = read_trace(fixture_file_path, &trace, &trace_read_stats, output_error_msg);
+        stop_repetition(timer, repetition);
+        if (status != 0)
+        {
+            return 1;
+        }
+    }
+    int num_vehicles = trace.num_vehicles;
+    int num_records = trace.size;
+    fill_bench_result(timer, "read_trace", num_vehicles, num_records, &(output_results[(*output_num_results)++]));
+
+    status = init_cells_scores(&(trace.grid), &n_deployment_input, output_error_msg);
+    if (status != 0)
+    {
+        free_trace(&trace);
+        return 1;
+    }
+
+    // -------------------- fill_scores_in_cells -------------- //
+    // Every function gets an untimed first run, as read_trace, so the repetitions find warm caches;
+    fill_scores_in_cells(&trace, trace.size, n_deployment_input.cells,
+    n_deployment_input.contacts_time_threshold, n_deployment_input.number_of_contacts);
+    for (repetition = 0; repetition < timer->num_repetitions; repetition++)
+    {
+        start_repetition(timer);
+        fill_scores_in_cells(&trace, trace.size, n_deployment_input.cells,
+        n_deployment_input.contacts_time_threshold, n_deployment_input.number_of_contacts);
+        stop_repetition(timer, repetition);
+    }
+    fill_bench_result(timer, "fill_scores_in_cells", num_vehicles, num_records, &(output_results[(*output_num_results)++]));
+
+    struct_coverage_indexes indexes;
+    status = build_coverage_indexes(&trace, n_deployment_input.contacts_time_threshold, &indexes, output_error_msg);
+    free_trace(&trace);
+    if (status != 0)
+    {
+        free_cells_scores(&n_deployment_input);
+        return 1;
+    }
+
+    // -------------------- rank_cells_by_score --------------- //
+    // Ranking the scores once replaced taking the highest score cell of the grid for every RCL slot;
+    status = rank_cells_by_score(n_deployment_input.cells, n_deployment_input.grid.num_cells,
+    n_deployment_input.ranked_cells, n_deployment_input.cell_rank, &(n_deployment_input.num_ranked_cells),
+    output_error_msg);
+    for (repetition = 0; repetition < timer->num_repetitions && status == 0; repetition++)
+    {
+        start_repetition(timer);
+        status = rank_cells_by_score(n_deployment_input.cells, n_deployment_input.grid.num_cells,
+        n_deployment_input.ranked_cells, n_deployment_input.cell_rank, &(n_deployment_input.num_ranked_cells),
+        output_error_msg);
+        stop_repetition(timer, repetition);
+    }
+    if (status != 0)
+    {
+        free_coverage_indexes(&indexes);
+        free_cells_scores(&n_deployment_input);
+        return 1;
+    }
+    fill_bench_result(timer, "rank_cells_by_score", num_vehicles, num_records, &(output_results[(*output_num_results)++]));
+    n_deployment_input.padding_cell = get_cell_id(&(n_deployment_input.grid), 0, 0);
+
+    // -------------------- run_grasp_iteration --------------- //
+    // RCLs built from the ranked cells, one pick per RSU, with the incremental coverage of the picks;
+    struct_n_deployment_worker* worker = (struct_n_deployment_worker*) malloc(sizeof(struct_n_deployment_worker));
+    if (worker == NULL)
+    {
+        sprintf(output_error_msg, "MEMORY ERROR: can't allocate memory for the worker");
+        free_coverage_indexes(&indexes);
+        free_cells_scores(&n_deployment_input);
+        return 1;
+    }
+    int next_iteration = 0;
+    struct_iteration_result iteration_result;
+    worker->indexes = &indexes;
+    worker->bitsets = NULL;
+    worker->input = &n_deployment_input;
+    worker->rcl_draws = NULL;
+    worker->round_size = 1;
+    worker->next_iteration = &next_iteration;
+    worker->iteration_results = &iteration_result;
+    worker->elite_pool = NULL;
+    worker->round_solution_cells = NULL;
+    status = init_n_deployment_worker(worker, output_error_msg);
+    if (status != 0)
+    {
+        free(worker);
+        free_coverage_indexes(&indexes);
+        free_cells_scores(&n_deployment_input);
+        return 1;
+    }
+
+    run_grasp_iteration(worker, 0, &iteration_result);
+    for (repetition = 0; repetition < timer->num_repetitions; repetition++)
+    {
+        start_repetition(timer);
+        run_grasp_iteration(worker, repetition, &iteration_result);
+        stop_repetition(timer, repetition);
+    }
+    fill_bench_result(timer, "run_grasp_iteration", num_vehicles, num_records, &(output_results[(*output_num_results)++]));
+
+    // -------------------- check_coverage -------------------- //
+    // Coverage of the last solution read from the vehicle to cells index, as check_coverage() did from the trace;
+    int coverage = evaluate_solution(COVERAGE_KERNEL_INDEX, &(worker->coverage_state), &indexes,
+    &(worker->contact_counters), NULL, NULL, worker->cell_has_rsu, worker->solution_cells,
+    n_deployment_input.number_of_rsus);
+    for (repetition = 0; repetition < timer->num_repetitions; repetition++)
+    {
+        start_repetition(timer);
+        coverage = evaluate_solution(COVERAGE_KERNEL_INDEX, &(worker->coverage_state), &indexes,
+        &(worker->contact_counters), NULL, NULL, worker->cell_has_rsu, worker->solution_cells,
+        n_deployment_input.number_of_rsus);
+        stop_repetition(timer, repetition);
+    }
+    fill_bench_result(timer, "check_coverage", num_vehicles, num_records, &(output_results[(*output_num_results)++]));
+
+    if (coverage != iteration_result.coverage)
+    {
+        sprintf(output_error_msg, "COVERAGE ERROR: %s: check_coverage gives %d vehicles, the iteration %d",
+        fixture_file_path, coverage, iteration_result.coverage);
+        status = 1;
+    }
+
+    // -------------------- write_rsus_to_file ---------------- //
+    // rsus files are written in the working directory, restored right after;
+    char current_dir[MAX_BENCH_FILE_PATH_SIZE + 1];
+    if (status == 0 && (getcwd(current_dir, sizeof(current_dir)) == NULL || chdir(rsus_dir) != 0))
+    {
+        sprintf(output_error_msg, "OUTPUT FILE ERROR: can't go to %s", rsus_dir);
+        status = 1;
+    }
+    else if (status == 0)
+    {
+        status = write_rsus_to_file(n_deployment_input, worker->solution, n_deployment_input.number_of_rsus,
+        output_error_msg);
+        for (repetition = 0; repetition < timer->num_repetitions && status == 0; repetition++)
+        {
+            start_repetition(timer);
+            status = write_rsus_to_file(n_deployment_input, worker->solution, n_deployment_input.number_of_rsus,
+            output_error_msg);
+            stop_repetition(timer, repetition);
+        }
+
+        if (chdir(current_dir) != 0 && status == 0)
+        {
+            sprintf(output_error_msg, "OUTPUT FILE ERROR: can't go back to %s", current_dir);
+            status = 1;
+        }
+        if (status == 0)
+        {
+            fill_bench_result(timer, "write_rsus_to_file", num_vehicles, num_records,
+            &(output_results[(*output_num_results)++]));
+        }
+    }
+
+    free_n_deployment_worker(worker);
+    free(worker);
+    free_coverage_indexes(&indexes);
+    free_cells_scores(&n_deployment_input);
+
+    return status;
+}
+
+void start_repetition(struct_bench_timer *timer)
+{
+    clock_gettime(CLOCK_MONOTONIC, &(timer->begin));
+}
+
+void stop_repetition(struct_bench_timer *timer, int repetition)
+{
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    timer->times[repetition] = (end.tv_sec - timer->begin.tv_sec) + (end.tv_nsec - timer->begin.tv_nsec) / 1e9;
+}
+
+void fill_bench_result(struct_bench_timer *timer, const char* kernel_name,
+int num_vehicles, int num_records, struct_bench_result *output_result)
+{
+    int n = timer->num_repetitions;
+    qsort(timer->times, (size_t) n, sizeof(double), compare_times);
+
+    output_result->kernel_name = kernel_name;
+    output_result->num_vehicles = num_vehicles;
+    output_result->num_records = num_records;
+    output_result->num_repetitions = n;
+    output_result->median_time = (n % 2 == 1) ? timer->times[n / 2] : (timer->times[n / 2 - 1] + timer->times[n / 2]) / 2;
+    output_result->min_time = timer->times[0];
+    output_result->max_time = timer->times[n - 1];
+}
+
+int compare_times(const void* a, const void* b)
+{
+    double time_a = *(const double*) a;
+    double time_b = *(const double*) b;
+
+    return (time_a > time_b) - (time_a < time_b);
+}
+
+int remove_work_dir(const char* work_dir)
+{
+    DIR* dir = opendir(work_dir);
+    if (dir == NULL)
+    {
+        return 1;
+    }
+
+    char file_path[MAX_BENCH_FILE_PATH_SIZE + 400];
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0)
+        {
+            snprintf(file_path, sizeof(file_path), "%s/%s", work_dir, entry->d_name);
+            remove(file_path);
+        }
+    }
+    closedir(dir);
+
+    return rmdir(work_dir) != 0;
+}
+
+int write_bench_results_to_file(const char* output_file_path, struct_bench_result *results, int num_results,
+char* output_error_msg)
+{
+    FILE* output_file = fopen(output_file_path, "w");
+    if (output_file == NULL)
+    {
+        sprintf(output_error_msg, "can't write bench file %s", output_file_path);
+        return 1;
+    }
+
+    fprintf(output_file, "kernel,vehicles,records,repetitions,median_time,min_time,max_time,records_per_sec\n");
+    int r;
+    for (r = 0; r < num_results; r++)
+    {
+        fprintf(output_file, "%s,%d,%d,%d,%.9f,%.9f,%.9f,%.0f\n", results[r].kernel_name,
+        results[r].num_vehicles, results[r].num_records, results[r].num_repetitions,
+        results[r].median_time, results[r].min_time, results[r].max_time,
+        results[r].num_records / results[r].median_time);
+    }
+
+    fclose(output_file);
+
+    return 0;
+}
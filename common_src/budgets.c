@@ -0,0 +1,151 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "budgets.h"
+
+// Reads a positive integer at *cursor and moves the cursor past it;
+// Returns 0 if there is one, otherwise 1;
+static int read_budget(const char** cursor, int* output)
+{
+    char* end;
+    long value = strtol(*cursor, &end, 10);
+    if (end == *cursor || value <= 0 || value > 2147483647L)
+    {
+        return 1;
+    }
+
+    *output = (int) value;
+    *cursor = end;
+    return 0;
+}
+
+// parse_budgets() and parse_taus(), values_name is used in error messages;
+static int parse_positive_int_spec(const char* spec, int max_budget, const char* values_name,
+struct_budgets* output_budgets, char* output_error_msg)
+{
+    if (strlen(spec) + 2 > MAX_BUDGETS_LABEL_SIZE)
+    {
+        sprintf(output_error_msg, "%s are longer than %d characters", values_name, MAX_BUDGETS_LABEL_SIZE - 2);
+        return 1;
+    }
+
+    int num_budgets = 0;
+    int* budgets = NULL;
+    const char* cursor = spec;
+
+    if (strchr(spec, ':') != NULL)
+    {
+        int min_budget, last_budget, step;
+        if (read_budget(&cursor, &min_budget) != 0 || *cursor++ != ':'
+        || read_budget(&cursor, &last_budget) != 0 || *cursor++ != ':'
+        || read_budget(&cursor, &step) != 0 || *cursor != '\0' || last_budget < min_budget)
+        {
+            sprintf(output_error_msg, "%s must be \"min:max:step\" or a list of positive integers", values_name);
+            return 1;
+        }
+        // Before expanding, so a typo in max doesn't allocate a huge range first (step > 0 was read above);
+        if (last_budget > max_budget)
+        {
+            sprintf(output_error_msg, "%s must be at most %d", values_name, max_budget);
+            return 1;
+        }
+
+        num_budgets = (last_budget - min_budget) / step + 1;
+        budgets = (int*) malloc(sizeof(int) * num_budgets);
+        if (budgets == NULL)
+        {
+            sprintf(output_error_msg, "can't allocate memory for %d %s", num_budgets, values_name);
+            return 1;
+        }
+
+        int i;
+        for (i = 0; i < num_budgets; i++)
+        {
+            budgets[i] = min_budget + i * step;
+        }
+    }
+    else
+    {
+        // At most one budget per character;
+        budgets = (int*) malloc(sizeof(int) * (strlen(spec) + 1));
+        if (budgets == NULL)
+        {
+            sprintf(output_error_msg, "can't allocate memory for the %s", values_name);
+            return 1;
+        }
+
+        while (1)
+        {
+            if (read_budget(&cursor, &(budgets[num_budgets])) != 0)
+            {
+                sprintf(output_error_msg, "%s must be \"min:max:step\" or a list of positive integers", values_name);
+                free(budgets);
+                return 1;
+            }
+            num_budgets++;
+
+            if (*cursor == '\0')
+            {
+                break;
+            }
+            if (*cursor++ != ',')
+            {
+                sprintf(output_error_msg, "%s must be \"min:max:step\" or a list of positive integers", values_name);
+                free(budgets);
+                return 1;
+            }
+        }
+    }
+
+    int i;
+    for (i = 0; i < num_budgets; i++)
+    {
+        if (budgets[i] > max_budget)
+        {
+            sprintf(output_error_msg, "%s must be at most %d", values_name, max_budget);
+            free(budgets);
+            return 1;
+        }
+    }
+
+    output_budgets->num_budgets = num_budgets;
+    output_budgets->budgets = budgets;
+
+    // A single value is named by itself, as in the files of a run without a list;
+    if (num_budgets == 1)
+    {
+        sprintf(output_budgets->label, "%d", budgets[0]);
+        return 0;
+    }
+
+    sprintf(output_budgets->label, "[%s]", spec);
+    char* c;
+    for (c = output_budgets->label; *c != '\0'; c++)
+    {
+        if (*c == ':' || *c == ',')
+        {
+            *c = '_';
+        }
+    }
+
+    return 0;
+}
+
+int parse_budgets(const char* spec, int max_budget, struct_budgets* output_budgets, char* output_error_msg)
+{
+    return parse_positive_int_spec(spec, max_budget, "budgets", output_budgets, output_error_msg);
+}
+
+int parse_taus(const char* spec, int max_tau, struct_budgets* output_taus, char* output_error_msg)
+{
+    return parse_positive_int_spec(spec, max_tau, "thresholds", output_taus, output_error_msg);
+}
+
+void free_budgets(struct_budgets* budgets)
+{
+    free(budgets->budgets);
+
+    budgets->budgets = NULL;
+    budgets->num_budgets = 0;
+}
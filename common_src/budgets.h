@@ -0,0 +1,41 @@
+#ifndef COMMON_BUDGETS_H
+#define COMMON_BUDGETS_H
+
+#define MAX_BUDGETS_LABEL_SIZE      100
+
+// Solution sizes solved one after the other by one process (--budgets),
+// also used for the contacts time thresholds a solution is scored against (--tau);
+typedef struct budgets_
+{
+    int num_budgets;
+    int *budgets;
+
+    // Spec in file name form, e.g. "[43_423_10]" for "43:423:10" and "[42_211]" for "42,211",
+    // like the results directories of the run scripts, and "43" for a single value;
+    char label[MAX_BUDGETS_LABEL_SIZE + 1];
+
+} struct_budgets;
+
+// ==================== BUDGETS FUNCTIONS ==================== //
+// spec is "min:max:step" (min, min + step, ... up to max) or a list "b1,b2,...";
+// Every budget must be a positive integer not bigger than max_budget;
+// If succeedes, returns 0 and output_budgets can be used (release it with free_budgets());
+// Otherwise, returns 1 and error_msg can be used;
+int parse_budgets(
+    const char* spec, int max_budget,
+    struct_budgets *output_budgets,
+    char* output_error_msg
+);
+
+// Same specs as parse_budgets(), for a list of contacts time thresholds;
+int parse_taus(
+    const char* spec, int max_tau,
+    struct_budgets *output_taus,
+    char* output_error_msg
+);
+
+// Releases budgets and thresholds;
+void free_budgets(struct_budgets *budgets);
+// ==================== BUDGETS FUNCTIONS ==================== //
+
+#endif
@@ -0,0 +1,547 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "coverage.h"
+
+// Same reduction as ilp_src/get_cells_within_tau.ipynb, but counting records per (vehicle, cell)
+// so number_of_contacts > 1 keeps the semantics of the full trace scan;
+int build_vehicle_cells_index(struct_trace* trace, int time_interval,
+struct_vehicle_cells_index* output_index, char* output_error_msg)
+{
+    int* vehicle_offsets = (int*) malloc(sizeof(int) * ((size_t) trace->num_vehicles + 1));
+    int* cell = (int*) malloc(sizeof(int) * (size_t) trace->size);
+    int* num_records = (int*) malloc(sizeof(int) * (size_t) trace->size);
+    int* first_offset = (int*) malloc(sizeof(int) * (size_t) trace->size);
+    // Entry of each cell for the vehicle being reduced, valid if cell_vehicle[cell] is that vehicle;
+    int num_cells = trace->grid.num_cells;
+    int* cell_entry = (int*) malloc(sizeof(int) * (size_t) num_cells);
+    int* cell_vehicle = (int*) malloc(sizeof(int) * (size_t) num_cells);
+    if (!vehicle_offsets || !cell || !num_records || !first_offset || !cell_entry || !cell_vehicle)
+    {
+        sprintf(output_error_msg, "can't allocate memory for the index of %d trace lines", trace->size);
+        free(vehicle_offsets);
+        free(cell);
+        free(num_records);
+        free(first_offset);
+        free(cell_entry);
+        free(cell_vehicle);
+        return 1;
+    }
+
+    int i;
+    for (i = 0; i < num_cells; i++) cell_vehicle[i] = -1;
+
+    int num_entries = 0;
+    int v;
+    for (v = 0; v < trace->num_vehicles; v++)
+    {
+        vehicle_offsets[v] = num_entries;
+
+        int first_record = trace->vehicle_offsets[v];
+        int first_time = trace->time[first_record];
+        int last_time = first_time + time_interval;
+        for (i = first_record; i < trace->vehicle_offsets[v + 1]; i++)
+        {
+            if (trace->time[i] > last_time)
+            {
+                continue;
+            }
+
+            int c = trace->cell[i];
+            if (cell_vehicle[c] != v)
+            {
+                cell_vehicle[c] = v;
+                cell_entry[c] = num_entries;
+                cell[num_entries] = c;
+                num_records[num_entries] = 0;
+                first_offset[num_entries] = INT_MAX;
+                num_entries++;
+            }
+            num_records[cell_entry[c]]++;
+            if (trace->time[i] - first_time < first_offset[cell_entry[c]])
+            {
+                first_offset[cell_entry[c]] = trace->time[i] - first_time;
+            }
+        }
+    }
+    vehicle_offsets[trace->num_vehicles] = num_entries;
+
+    free(cell_entry);
+    free(cell_vehicle);
+
+    // Give back the space reserved for one entry per record;
+    int* shrunk_cell = (int*) realloc(cell, sizeof(int) * (size_t) (num_entries > 0 ? num_entries : 1));
+    int* shrunk_num_records = (int*) realloc(num_records, sizeof(int) * (size_t) (num_entries > 0 ? num_entries : 1));
+    int* shrunk_first_offset = (int*) realloc(first_offset, sizeof(int) * (size_t) (num_entries > 0 ? num_entries : 1));
+
+    output_index->num_vehicles = trace->num_vehicles;
+    output_index->num_cells = num_cells;
+    output_index->num_entries = num_entries;
+    output_index->time_interval = time_interval;
+    output_index->vehicle_offsets = vehicle_offsets;
+    output_index->cell = shrunk_cell ? shrunk_cell : cell;
+    output_index->num_records = shrunk_num_records ? shrunk_num_records : num_records;
+    output_index->first_offset = shrunk_first_offset ? shrunk_first_offset : first_offset;
+
+    return 0;
+}
+
+void free_vehicle_cells_index(struct_vehicle_cells_index* index)
+{
+    free(index->vehicle_offsets);
+    free(index->cell);
+    free(index->num_records);
+    free(index->first_offset);
+
+    index->vehicle_offsets = NULL;
+    index->cell = NULL;
+    index->num_records = NULL;
+    index->first_offset = NULL;
+    index->num_vehicles = 0;
+    index->num_cells = 0;
+    index->num_entries = 0;
+}
+
+int build_cell_vehicles_index(struct_vehicle_cells_index* vehicle_cells_index,
+struct_cell_vehicles_index* output_index, char* output_error_msg)
+{
+    int num_entries = vehicle_cells_index->num_entries;
+    int num_cells = vehicle_cells_index->num_cells;
+
+    int* cell_offsets = (int*) calloc((size_t) num_cells + 1, sizeof(int));
+    int* vehicle = (int*) malloc(sizeof(int) * (size_t) (num_entries > 0 ? num_entries : 1));
+    int* num_records = (int*) malloc(sizeof(int) * (size_t) (num_entries > 0 ? num_entries : 1));
+    int* first_offset = (int*) malloc(sizeof(int) * (size_t) (num_entries > 0 ? num_entries : 1));
+    if (!cell_offsets || !vehicle || !num_records || !first_offset)
+    {
+        sprintf(output_error_msg, "can't allocate memory for the cells index of %d entries", num_entries);
+        free(cell_offsets);
+        free(vehicle);
+        free(num_records);
+        free(first_offset);
+        return 1;
+    }
+
+    // Counting sort of the entries by cell, vehicles stay in increasing order inside each cell;
+    int c, v, e;
+    for (e = 0; e < num_entries; e++)
+    {
+        cell_offsets[ vehicle_cells_index->cell[e] + 1 ]++;
+    }
+    for (c = 0; c < num_cells; c++)
+    {
+        cell_offsets[c + 1] += cell_offsets[c];
+    }
+
+    for (v = 0; v < vehicle_cells_index->num_vehicles; v++)
+    {
+        for (e = vehicle_cells_index->vehicle_offsets[v]; e < vehicle_cells_index->vehicle_offsets[v + 1]; e++)
+        {
+            // cell_offsets[c] is used as the insert position of cell c and ends at cell_offsets[c + 1];
+            int position = cell_offsets[ vehicle_cells_index->cell[e] ]++;
+            vehicle[position] = v;
+            num_records[position] = vehicle_cells_index->num_records[e];
+            first_offset[position] = vehicle_cells_index->first_offset[e];
+        }
+    }
+
+    // Shift insert positions back into offsets;
+    for (c = num_cells; c > 0; c--)
+    {
+        cell_offsets[c] = cell_offsets[c - 1];
+    }
+    cell_offsets[0] = 0;
+
+    output_index->num_cells = num_cells;
+    output_index->num_entries = num_entries;
+    output_index->cell_offsets = cell_offsets;
+    output_index->vehicle = vehicle;
+    output_index->num_records = num_records;
+    output_index->first_offset = first_offset;
+
+    return 0;
+}
+
+void free_cell_vehicles_index(struct_cell_vehicles_index* index)
+{
+    free(index->cell_offsets);
+    free(index->vehicle);
+    free(index->num_records);
+    free(index->first_offset);
+
+    index->cell_offsets = NULL;
+    index->vehicle = NULL;
+    index->num_records = NULL;
+    index->first_offset = NULL;
+    index->num_cells = 0;
+    index->num_entries = 0;
+}
+
+int build_coverage_indexes(struct_trace* trace, int time_interval,
+struct_coverage_indexes* output_indexes, char* output_error_msg)
+{
+    int status = build_vehicle_cells_index(trace, time_interval, &(output_indexes->vehicle_cells),
+    output_error_msg);
+    if (status != 0)
+    {
+        return 1;
+    }
+
+    status = build_cell_vehicles_index(&(output_indexes->vehicle_cells), &(output_indexes->cell_vehicles),
+    output_error_msg);
+    if (status != 0)
+    {
+        free_vehicle_cells_index(&(output_indexes->vehicle_cells));
+        return 1;
+    }
+
+    return 0;
+}
+
+void free_coverage_indexes(struct_coverage_indexes* indexes)
+{
+    free_vehicle_cells_index(&(indexes->vehicle_cells));
+    free_cell_vehicles_index(&(indexes->cell_vehicles));
+}
+
+int count_covered_vehicles(struct_vehicle_cells_index* index,
+const unsigned char* cell_has_rsu, int number_of_contacts)
+{
+    int covered = 0;
+    int v, e;
+
+    if (number_of_contacts == 1)
+    {
+        // Any RSU cell covers the vehicle, stop at the first one;
+        for (v = 0; v < index->num_vehicles; v++)
+        {
+            for (e = index->vehicle_offsets[v]; e < index->vehicle_offsets[v + 1]; e++)
+            {
+                if (cell_has_rsu[ index->cell[e] ])
+                {
+                    covered++;
+                    break;
+                }
+            }
+        }
+
+        return covered;
+    }
+
+    for (v = 0; v < index->num_vehicles; v++)
+    {
+        int contacts = 0;
+        for (e = index->vehicle_offsets[v]; e < index->vehicle_offsets[v + 1]; e++)
+        {
+            contacts += cell_has_rsu[ index->cell[e] ] * index->num_records[e];
+            if (contacts >= number_of_contacts)
+            {
+                covered++;
+                break;
+            }
+        }
+    }
+
+    return covered;
+}
+
+int init_contact_counters(struct_coverage_indexes* indexes,
+struct_contact_counters* output_counters, char* output_error_msg)
+{
+    int num_vehicles = indexes->vehicle_cells.num_vehicles;
+
+    output_counters->num_vehicles = num_vehicles;
+    output_counters->num_of_contacts = (unsigned char*) calloc((size_t) (num_vehicles > 0 ? num_vehicles : 1), 1);
+    output_counters->cell_is_counted = (unsigned char*) calloc((size_t) indexes->vehicle_cells.num_cells, 1);
+    if (!output_counters->num_of_contacts || !output_counters->cell_is_counted)
+    {
+        sprintf(output_error_msg, "can't allocate memory for the contact counters of %d vehicles", num_vehicles);
+        free_contact_counters(output_counters);
+        return 1;
+    }
+
+    return 0;
+}
+
+void free_contact_counters(struct_contact_counters* counters)
+{
+    free(counters->num_of_contacts);
+    free(counters->cell_is_counted);
+
+    counters->num_of_contacts = NULL;
+    counters->cell_is_counted = NULL;
+    counters->num_vehicles = 0;
+}
+
+int count_covered_vehicles_by_cells(struct_cell_vehicles_index* index, struct_contact_counters* counters,
+const int* cells, int num_cells, int number_of_contacts)
+{
+    unsigned char* num_of_contacts = counters->num_of_contacts;
+    int covered = 0;
+    int i, e;
+
+    for (i = 0; i < num_cells; i++)
+    {
+        int c = cells[i];
+        if (c == NO_CELL || counters->cell_is_counted[c])
+        {
+            continue;
+        }
+        counters->cell_is_counted[c] = 1;
+
+        for (e = index->cell_offsets[c]; e < index->cell_offsets[c + 1]; e++)
+        {
+            int before = num_of_contacts[ index->vehicle[e] ];
+            if (before >= number_of_contacts)
+            {
+                continue;
+            }
+
+            // Counted once, when the vehicle reaches number_of_contacts, where its counter stops;
+            int after = before + index->num_records[e];
+            if (after >= number_of_contacts)
+            {
+                covered++;
+                after = number_of_contacts;
+            }
+            num_of_contacts[ index->vehicle[e] ] = (unsigned char) after;
+        }
+    }
+
+    // Back to all zeros, touching the same entries;
+    for (i = 0; i < num_cells; i++)
+    {
+        int c = cells[i];
+        if (c == NO_CELL || !counters->cell_is_counted[c])
+        {
+            continue;
+        }
+        counters->cell_is_counted[c] = 0;
+
+        for (e = index->cell_offsets[c]; e < index->cell_offsets[c + 1]; e++)
+        {
+            num_of_contacts[ index->vehicle[e] ] = 0;
+        }
+    }
+
+    return covered;
+}
+
+int init_coverage_state(struct_coverage_indexes* indexes,
+int number_of_contacts, struct_coverage_state* output_state, char* output_error_msg)
+{
+    int num_vehicles = indexes->vehicle_cells.num_vehicles;
+
+    output_state->index = &(indexes->cell_vehicles);
+    output_state->number_of_contacts = number_of_contacts;
+    output_state->num_vehicles = num_vehicles;
+    output_state->covered = 0;
+    output_state->num_of_contacts = (int*) calloc((size_t) (num_vehicles > 0 ? num_vehicles : 1), sizeof(int));
+    output_state->cell_num_rsus = (int*) calloc((size_t) indexes->vehicle_cells.num_cells, sizeof(int));
+    if (!output_state->num_of_contacts || !output_state->cell_num_rsus)
+    {
+        sprintf(output_error_msg, "can't allocate memory for the coverage state of %d vehicles", num_vehicles);
+        free_coverage_state(output_state);
+        return 1;
+    }
+
+    return 0;
+}
+
+void free_coverage_state(struct_coverage_state* state)
+{
+    free(state->num_of_contacts);
+    free(state->cell_num_rsus);
+
+    state->num_of_contacts = NULL;
+    state->cell_num_rsus = NULL;
+}
+
+int add_rsu(struct_coverage_state* state, int cell)
+{
+    if (cell == NO_CELL || state->cell_num_rsus[cell]++ > 0)
+    {
+        return 0;
+    }
+
+    struct_cell_vehicles_index* index = state->index;
+    int number_of_contacts = state->number_of_contacts;
+    int gain = 0;
+    int e;
+    for (e = index->cell_offsets[cell]; e < index->cell_offsets[cell + 1]; e++)
+    {
+        int before = state->num_of_contacts[ index->vehicle[e] ];
+        int after = before + index->num_records[e];
+        state->num_of_contacts[ index->vehicle[e] ] = after;
+        gain += (before < number_of_contacts) & (after >= number_of_contacts);
+    }
+
+    state->covered += gain;
+    return gain;
+}
+
+int remove_rsu(struct_coverage_state* state, int cell)
+{
+    if (cell == NO_CELL || --state->cell_num_rsus[cell] > 0)
+    {
+        return 0;
+    }
+
+    struct_cell_vehicles_index* index = state->index;
+    int number_of_contacts = state->number_of_contacts;
+    int loss = 0;
+    int e;
+    for (e = index->cell_offsets[cell]; e < index->cell_offsets[cell + 1]; e++)
+    {
+        int before = state->num_of_contacts[ index->vehicle[e] ];
+        int after = before - index->num_records[e];
+        state->num_of_contacts[ index->vehicle[e] ] = after;
+        loss += (before >= number_of_contacts) & (after < number_of_contacts);
+    }
+
+    state->covered -= loss;
+    return -loss;
+}
+
+int current_coverage(struct_coverage_state* state)
+{
+    return state->covered;
+}
+
+int gain_if_added(struct_coverage_state* state, int cell)
+{
+    if (cell == NO_CELL || state->cell_num_rsus[cell] > 0)
+    {
+        return 0;
+    }
+
+    struct_cell_vehicles_index* index = state->index;
+    int number_of_contacts = state->number_of_contacts;
+    int gain = 0;
+    int e;
+    for (e = index->cell_offsets[cell]; e < index->cell_offsets[cell + 1]; e++)
+    {
+        int before = state->num_of_contacts[ index->vehicle[e] ];
+        gain += (before < number_of_contacts) & (before + index->num_records[e] >= number_of_contacts);
+    }
+
+    return gain;
+}
+
+int loss_if_removed(struct_coverage_state* state, int cell)
+{
+    if (cell == NO_CELL || state->cell_num_rsus[cell] != 1)
+    {
+        return 0;
+    }
+
+    struct_cell_vehicles_index* index = state->index;
+    int number_of_contacts = state->number_of_contacts;
+    int loss = 0;
+    int e;
+    for (e = index->cell_offsets[cell]; e < index->cell_offsets[cell + 1]; e++)
+    {
+        int before = state->num_of_contacts[ index->vehicle[e] ];
+        loss += (before >= number_of_contacts) & (before - index->num_records[e] < number_of_contacts);
+    }
+
+    return loss;
+}
+
+int fill_coverage_curve(struct_coverage_indexes* indexes, int number_of_contacts,
+const int* cells, int num_cells, int* output_curve, char* output_error_msg)
+{
+    struct_coverage_state state;
+    int status = init_coverage_state(indexes, number_of_contacts, &state, output_error_msg);
+    if (status != 0)
+    {
+        return 1;
+    }
+
+    int i;
+    for (i = 0; i < num_cells; i++)
+    {
+        add_rsu(&state, cells[i]);
+        output_curve[i] = current_coverage(&state);
+    }
+
+    free_coverage_state(&state);
+
+    return 0;
+}
+
+int fill_coverage_curve_by_tau(struct_coverage_indexes* indexes, int number_of_contacts,
+const int* taus, int num_taus, const int* cells, int num_cells, int* output_curve, char* output_error_msg)
+{
+    int time_interval = indexes->vehicle_cells.time_interval;
+    int t;
+    for (t = 0; t < num_taus; t++)
+    {
+        if (taus[t] > time_interval)
+        {
+            sprintf(output_error_msg, "threshold %d is bigger than the %d of the index", taus[t], time_interval);
+            return 1;
+        }
+    }
+
+    // Contacts are only counted per record, so each threshold needs its own index;
+    if (number_of_contacts != 1)
+    {
+        if (num_taus != 1 || taus[0] != time_interval)
+        {
+            strcpy(output_error_msg, "several thresholds in one pass need 1 contact");
+            return 1;
+        }
+
+        return fill_coverage_curve(indexes, number_of_contacts, cells, num_cells, output_curve, output_error_msg);
+    }
+
+    // Earliest offset at which each vehicle reaches a cell of the current prefix;
+    int num_vehicles = indexes->vehicle_cells.num_vehicles;
+    int* reach_offset = (int*) malloc(sizeof(int) * (size_t) (num_vehicles > 0 ? num_vehicles : 1));
+    int* covered = (int*) calloc((size_t) num_taus, sizeof(int));
+    if (!reach_offset || !covered)
+    {
+        sprintf(output_error_msg, "can't allocate memory for the offsets of %d vehicles", num_vehicles);
+        free(reach_offset);
+        free(covered);
+        return 1;
+    }
+
+    int v;
+    for (v = 0; v < num_vehicles; v++) reach_offset[v] = INT_MAX;
+
+    struct_cell_vehicles_index* index = &(indexes->cell_vehicles);
+    int i, e;
+    for (i = 0; i < num_cells; i++)
+    {
+        int c = cells[i];
+        int first_entry = (c == NO_CELL) ? 0 : index->cell_offsets[c];
+        int end_entry = (c == NO_CELL) ? 0 : index->cell_offsets[c + 1];
+        for (e = first_entry; e < end_entry; e++)
+        {
+            int vehicle = index->vehicle[e];
+            int offset = index->first_offset[e];
+            if (offset >= reach_offset[vehicle])
+            {
+                continue;
+            }
+
+            // Newly covered for the thresholds in [offset, previous offset);
+            for (t = 0; t < num_taus; t++)
+            {
+                covered[t] += (offset <= taus[t]) & (reach_offset[vehicle] > taus[t]);
+            }
+            reach_offset[vehicle] = offset;
+        }
+
+        memcpy(&(output_curve[(size_t) i * num_taus]), covered, sizeof(int) * num_taus);
+    }
+
+    free(reach_offset);
+    free(covered);
+
+    return 0;
+}
@@ -0,0 +1,207 @@
+#ifndef COMMON_COVERAGE_H
+#define COMMON_COVERAGE_H
+
+#include "trace.h"
+
+// Contact counters of struct_contact_counters are bytes, saturated at the number of contacts;
+#define MAX_SATURATING_CONTACTS     255
+
+// Cell of an RSU placed outside the frequented cells, e.g. GRASP picks padding a short RCL with (0,0)
+// when no record is in that cell, as get_cell_id() returns it; it covers no vehicle and the functions
+// taking cells below skip it;
+#define NO_CELL                     -1
+
+// Most RSUs of a greedy, Lagrangian or evaluated solution, kept in fixed size arrays;
+// An arbitrary cap, not the number of cells: on a trace with more frequented cells a budget
+// can't take all of them;
+#define MAX_SOLUTION_SIZE           10000
+
+// Biggest contacts time threshold of the --tau lists, one day;
+#define MAX_TAU_LIST_VALUE          86400
+
+// Trace reduced to the cells each vehicle visits within the contacts time threshold,
+// i.e. the records with time <= (vehicle's first record time + time_interval);
+// Compressed sparse rows: entries of the v-th vehicle are [vehicle_offsets[v], vehicle_offsets[v + 1]),
+// one entry per distinct cell, in order of first visit;
+// Cells are the dense cells of the trace (see struct_cell_grid), everything indexed by cell has num_cells entries;
+typedef struct vehicle_cells_index_
+{
+    int num_vehicles;
+    int num_cells;
+    int num_entries;
+    int time_interval;
+
+    int *vehicle_offsets;
+    int *cell;
+    // Number of records of the vehicle inside the cell within the threshold,
+    // which is the number of contacts the vehicle makes if the cell has a RSU;
+    int *num_records;
+    // Earliest (record time - vehicle's first record time) inside the cell, so the vehicle reaches the cell
+    // within any threshold tau <= time_interval iff first_offset <= tau;
+    int *first_offset;
+
+} struct_vehicle_cells_index;
+
+// Inverse of struct_vehicle_cells_index: vehicles reaching each cell within the threshold;
+// Entries of cell c are [cell_offsets[c], cell_offsets[c + 1]), in increasing vehicle order;
+typedef struct cell_vehicles_index_
+{
+    int num_cells;
+    int num_entries;
+
+    int *cell_offsets;
+    int *vehicle;
+    int *num_records;
+    int *first_offset;
+
+} struct_cell_vehicles_index;
+
+// Both directions of the reduced trace, built together by build_coverage_indexes();
+typedef struct coverage_indexes_
+{
+    struct_vehicle_cells_index vehicle_cells;
+    struct_cell_vehicles_index cell_vehicles;
+
+} struct_coverage_indexes;
+
+// Coverage of a set of RSUs, kept up to date while RSUs are added and removed;
+// Cost of each update is proportional to the number of vehicles reaching the touched cell;
+// The index is shared and read only, the rest is scratch owned by the state;
+typedef struct coverage_state_
+{
+    struct_cell_vehicles_index *index;
+    int number_of_contacts;
+    int num_vehicles;
+
+    // Contacts each vehicle makes with the current RSUs;
+    int *num_of_contacts;
+    // RSUs placed at each cell, a cell repeated in a solution counts once for coverage;
+    int *cell_num_rsus;
+    int covered;
+
+} struct_coverage_state;
+
+// Scratch of count_covered_vehicles_by_cells(), all zeros between calls;
+typedef struct contact_counters_
+{
+    int num_vehicles;
+
+    // Contacts of each vehicle (dense index of the vehicle to cells index), saturated at the number of contacts;
+    unsigned char *num_of_contacts;
+    // Cells already counted in the current call, so a cell repeated in a solution counts once;
+    unsigned char *cell_is_counted;
+
+} struct_contact_counters;
+
+// ==================== INDEX FUNCTIONS ==================== //
+// If succeedes, returns 0 and output_index can be used (release it with free_vehicle_cells_index());
+// Otherwise, returns 1 and error_msg can be used;
+int build_vehicle_cells_index(
+    struct_trace *trace, int time_interval,
+    struct_vehicle_cells_index *output_index,
+    char* output_error_msg
+);
+
+void free_vehicle_cells_index(struct_vehicle_cells_index *index);
+
+// If succeedes, returns 0 and output_index can be used (release it with free_cell_vehicles_index());
+// Otherwise, returns 1 and error_msg can be used;
+int build_cell_vehicles_index(
+    struct_vehicle_cells_index *vehicle_cells_index,
+    struct_cell_vehicles_index *output_index,
+    char* output_error_msg
+);
+
+void free_cell_vehicles_index(struct_cell_vehicles_index *index);
+
+// Builds the vehicle to cells index and its inverse;
+// If succeedes, returns 0 and output_indexes can be used (release it with free_coverage_indexes());
+// Otherwise, returns 1 and error_msg can be used;
+int build_coverage_indexes(
+    struct_trace *trace, int time_interval,
+    struct_coverage_indexes *output_indexes,
+    char* output_error_msg
+);
+
+void free_coverage_indexes(struct_coverage_indexes *indexes);
+// ==================== INDEX FUNCTIONS ==================== //
+
+// ==================== COVERAGE FUNCTIONS ==================== //
+// Number of vehicles making at least number_of_contacts contacts with the cells marked in cell_has_rsu;
+// Same result as scanning the whole trace, but only the index is touched;
+int count_covered_vehicles(
+    struct_vehicle_cells_index *index,
+    const unsigned char *cell_has_rsu,
+    int number_of_contacts
+);
+
+// If succeedes, returns 0 and output_counters can be used (release it with free_contact_counters());
+// Otherwise, returns 1 and error_msg can be used;
+int init_contact_counters(
+    struct_coverage_indexes *indexes,
+    struct_contact_counters *output_counters,
+    char* output_error_msg
+);
+
+void free_contact_counters(struct_contact_counters *counters);
+
+// Same result as count_covered_vehicles(), but only the vehicles reaching the solution cells are touched,
+// with one byte counter each; number_of_contacts must be at most MAX_SATURATING_CONTACTS;
+int count_covered_vehicles_by_cells(
+    struct_cell_vehicles_index *index,
+    struct_contact_counters *counters,
+    const int *cells, int num_cells,
+    int number_of_contacts
+);
+
+// State starts with no RSUs;
+// If succeedes, returns 0 and output_state can be used (release it with free_coverage_state());
+// Otherwise, returns 1 and error_msg can be used;
+int init_coverage_state(
+    struct_coverage_indexes *indexes,
+    int number_of_contacts,
+    struct_coverage_state *output_state,
+    char* output_error_msg
+);
+
+void free_coverage_state(struct_coverage_state *state);
+
+// Both return the change in the number of covered vehicles;
+int add_rsu(struct_coverage_state *state, int cell);
+int remove_rsu(struct_coverage_state *state, int cell);
+
+int current_coverage(struct_coverage_state *state);
+
+// Number of vehicles add_rsu() would cover / remove_rsu() would uncover, without changing the state;
+int gain_if_added(struct_coverage_state *state, int cell);
+int loss_if_removed(struct_coverage_state *state, int cell);
+
+// Coverage of every prefix of cells, i.e. output_curve[i] is the coverage of cells[0..i],
+// computed in one pass of add_rsu();
+// If succeedes, returns 0 and output_curve (num_cells entries) can be used;
+// Otherwise, returns 1 and error_msg can be used;
+int fill_coverage_curve(
+    struct_coverage_indexes *indexes,
+    int number_of_contacts,
+    const int *cells, int num_cells,
+    int *output_curve,
+    char* output_error_msg
+);
+
+// Same as fill_coverage_curve() for each threshold of taus, every threshold at most the index time_interval;
+// output_curve[i * num_taus + t] is the coverage of cells[0..i] with threshold taus[t];
+// With 1 contact all thresholds are scored in the same pass, from the first_offset of the entries;
+// with more contacts, taus must be the index time_interval alone;
+// If succeedes, returns 0 and output_curve (num_cells * num_taus entries) can be used;
+// Otherwise, returns 1 and error_msg can be used;
+int fill_coverage_curve_by_tau(
+    struct_coverage_indexes *indexes,
+    int number_of_contacts,
+    const int *taus, int num_taus,
+    const int *cells, int num_cells,
+    int *output_curve,
+    char* output_error_msg
+);
+// ==================== COVERAGE FUNCTIONS ==================== //
+
+#endif
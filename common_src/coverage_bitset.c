@@ -0,0 +1,342 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define COVERAGE_BITSET_HAS_AVX2
+#endif
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#define COVERAGE_BITSET_HAS_NEON
+#endif
+
+#include "coverage_bitset.h"
+
+// Bitsets are ORed this many words at a time, so the partial union stays in L1;
+#define BITSET_BLOCK_WORDS          512
+// Words of one AVX2 vector, bitsets are padded to a multiple of it;
+#define BITSET_WORD_ALIGNMENT       4
+
+int build_cell_bitsets(struct_coverage_indexes* indexes, struct_cell_bitsets* output_bitsets,
+char* output_error_msg)
+{
+    struct_cell_vehicles_index* cell_vehicles = &(indexes->cell_vehicles);
+    int num_vehicles = indexes->vehicle_cells.num_vehicles;
+
+    int num_words = (num_vehicles + 63) / 64;
+    num_words = (num_words + BITSET_WORD_ALIGNMENT - 1) / BITSET_WORD_ALIGNMENT * BITSET_WORD_ALIGNMENT;
+    if (num_words == 0)
+    {
+        num_words = BITSET_WORD_ALIGNMENT;
+    }
+
+    int num_cells = cell_vehicles->num_cells;
+    int* cell_row = (int*) malloc(sizeof(int) * (size_t) (num_cells > 0 ? num_cells : 1));
+    if (cell_row == NULL)
+    {
+        sprintf(output_error_msg, "can't allocate memory for the cell bitsets");
+        return 1;
+    }
+
+    int num_frequented_cells = 0;
+    int c;
+    for (c = 0; c < num_cells; c++)
+    {
+        cell_row[c] = (cell_vehicles->cell_offsets[c + 1] > cell_vehicles->cell_offsets[c]) ?
+        num_frequented_cells++ : -1;
+    }
+
+    size_t words_size = sizeof(uint64_t) * (size_t) num_words * (size_t) (num_frequented_cells > 0 ? num_frequented_cells : 1);
+    uint64_t* words = (uint64_t*) aligned_alloc(sizeof(uint64_t) * BITSET_WORD_ALIGNMENT, words_size);
+    if (words == NULL)
+    {
+        sprintf(output_error_msg, "can't allocate %.1f MB for the bitsets of %d cells and %d vehicles",
+        words_size / 1e6, num_frequented_cells, num_vehicles);
+        free(cell_row);
+        return 1;
+    }
+    memset(words, 0, words_size);
+
+    for (c = 0; c < num_cells; c++)
+    {
+        if (cell_row[c] < 0)
+        {
+            continue;
+        }
+
+        uint64_t* row = words + (size_t) cell_row[c] * num_words;
+        int e;
+        for (e = cell_vehicles->cell_offsets[c]; e < cell_vehicles->cell_offsets[c + 1]; e++)
+        {
+            int v = cell_vehicles->vehicle[e];
+            row[v >> 6] |= (uint64_t) 1 << (v & 63);
+        }
+    }
+
+    output_bitsets->num_vehicles = num_vehicles;
+    output_bitsets->num_words = num_words;
+    output_bitsets->num_frequented_cells = num_frequented_cells;
+    output_bitsets->cell_row = cell_row;
+    output_bitsets->words = words;
+
+    return 0;
+}
+
+void free_cell_bitsets(struct_cell_bitsets* bitsets)
+{
+    free(bitsets->cell_row);
+    free(bitsets->words);
+
+    bitsets->cell_row = NULL;
+    bitsets->words = NULL;
+}
+
+// ==================== KERNELS ==================== //
+// Each kernel returns the popcount of the union of num_rows bitsets of num_words words;
+// num_rows > 0 and num_words is a multiple of BITSET_WORD_ALIGNMENT;
+
+static long long union_popcount_scalar(const uint64_t** rows, int num_rows, int num_words)
+{
+    uint64_t block[BITSET_BLOCK_WORDS];
+    long long count = 0;
+    int first_word;
+    for (first_word = 0; first_word < num_words; first_word += BITSET_BLOCK_WORDS)
+    {
+        int block_size = (num_words - first_word < BITSET_BLOCK_WORDS) ?
+        num_words - first_word : BITSET_BLOCK_WORDS;
+
+        memcpy(block, rows[0] + first_word, sizeof(uint64_t) * block_size);
+
+        int r, w;
+        for (r = 1; r < num_rows; r++)
+        {
+            const uint64_t* row = rows[r] + first_word;
+            for (w = 0; w < block_size; w++)
+            {
+                block[w] |= row[w];
+            }
+        }
+
+        for (w = 0; w < block_size; w++)
+        {
+            count += __builtin_popcountll(block[w]);
+        }
+    }
+
+    return count;
+}
+
+#ifdef COVERAGE_BITSET_HAS_AVX2
+// Popcount of 32 bytes with 4 bit lookups (pshufb), summed into 4 lanes of 64 bits;
+__attribute__((target("avx2")))
+static inline __m256i popcount_avx2(__m256i v)
+{
+    const __m256i lookup = _mm256_setr_epi8(
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+
+    __m256i low_nibbles = _mm256_and_si256(v, low_mask);
+    __m256i high_nibbles = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+    __m256i byte_counts = _mm256_add_epi8(
+        _mm256_shuffle_epi8(lookup, low_nibbles),
+        _mm256_shuffle_epi8(lookup, high_nibbles));
+
+    return _mm256_sad_epu8(byte_counts, _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2")))
+static long long union_popcount_avx2(const uint64_t** rows, int num_rows, int num_words)
+{
+    __m256i block[BITSET_BLOCK_WORDS / 4];
+    __m256i counts = _mm256_setzero_si256();
+    int first_word;
+    for (first_word = 0; first_word < num_words; first_word += BITSET_BLOCK_WORDS)
+    {
+        int block_size = (num_words - first_word < BITSET_BLOCK_WORDS) ?
+        num_words - first_word : BITSET_BLOCK_WORDS;
+        int num_vectors = block_size / 4;
+
+        int r, i;
+        const __m256i* row = (const __m256i*) (rows[0] + first_word);
+        for (i = 0; i < num_vectors; i++)
+        {
+            block[i] = _mm256_load_si256(row + i);
+        }
+
+        for (r = 1; r < num_rows; r++)
+        {
+            row = (const __m256i*) (rows[r] + first_word);
+            for (i = 0; i < num_vectors; i++)
+            {
+                block[i] = _mm256_or_si256(block[i], _mm256_load_si256(row + i));
+            }
+        }
+
+        for (i = 0; i < num_vectors; i++)
+        {
+            counts = _mm256_add_epi64(counts, popcount_avx2(block[i]));
+        }
+    }
+
+    return _mm256_extract_epi64(counts, 0) + _mm256_extract_epi64(counts, 1)
+    + _mm256_extract_epi64(counts, 2) + _mm256_extract_epi64(counts, 3);
+}
+#endif
+
+#ifdef COVERAGE_BITSET_HAS_NEON
+static long long union_popcount_neon(const uint64_t** rows, int num_rows, int num_words)
+{
+    uint64x2_t block[BITSET_BLOCK_WORDS / 2];
+    long long count = 0;
+    int first_word;
+    for (first_word = 0; first_word < num_words; first_word += BITSET_BLOCK_WORDS)
+    {
+        int block_size = (num_words - first_word < BITSET_BLOCK_WORDS) ?
+        num_words - first_word : BITSET_BLOCK_WORDS;
+        int num_vectors = block_size / 2;
+
+        int r, i;
+        for (i = 0; i < num_vectors; i++)
+        {
+            block[i] = vld1q_u64(rows[0] + first_word + 2 * i);
+        }
+
+        for (r = 1; r < num_rows; r++)
+        {
+            const uint64_t* row = rows[r] + first_word;
+            for (i = 0; i < num_vectors; i++)
+            {
+                block[i] = vorrq_u64(block[i], vld1q_u64(row + 2 * i));
+            }
+        }
+
+        for (i = 0; i < num_vectors; i++)
+        {
+            count += vaddlvq_u8(vcntq_u8(vreinterpretq_u8_u64(block[i])));
+        }
+    }
+
+    return count;
+}
+#endif
+// ==================== KERNELS ==================== //
+
+int count_covered_vehicles_bitset(struct_cell_bitsets* bitsets, const int* cells, int num_cells,
+enum_coverage_kernel kernel, const uint64_t** rows)
+{
+    // Rows of the cells some vehicle reaches;
+    int num_rows = 0;
+    int i;
+    for (i = 0; i < num_cells; i++)
+    {
+        int row = (cells[i] == NO_CELL) ? -1 : bitsets->cell_row[ cells[i] ];
+        if (row >= 0)
+        {
+            rows[num_rows++] = bitsets->words + (size_t) row * bitsets->num_words;
+        }
+    }
+
+    long long covered = 0;
+    if (num_rows > 0)
+    {
+        switch (kernel)
+        {
+#ifdef COVERAGE_BITSET_HAS_AVX2
+        case COVERAGE_KERNEL_BITSET_AVX2:
+            covered = union_popcount_avx2(rows, num_rows, bitsets->num_words);
+            break;
+#endif
+#ifdef COVERAGE_BITSET_HAS_NEON
+        case COVERAGE_KERNEL_BITSET_NEON:
+            covered = union_popcount_neon(rows, num_rows, bitsets->num_words);
+            break;
+#endif
+        default:
+            covered = union_popcount_scalar(rows, num_rows, bitsets->num_words);
+            break;
+        }
+    }
+
+    return (int) covered;
+}
+
+static int cpu_supports_avx2(void)
+{
+#ifdef COVERAGE_BITSET_HAS_AVX2
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#else
+    return 0;
+#endif
+}
+
+enum_coverage_kernel get_best_bitset_kernel(void)
+{
+#ifdef COVERAGE_BITSET_HAS_NEON
+    return COVERAGE_KERNEL_BITSET_NEON;
+#else
+    return cpu_supports_avx2() ? COVERAGE_KERNEL_BITSET_AVX2 : COVERAGE_KERNEL_BITSET_SCALAR;
+#endif
+}
+
+int get_coverage_kernel_from_name(const char* name, enum_coverage_kernel* output_kernel,
+char* output_error_msg)
+{
+    if (strcmp(name, "auto") == 0) *output_kernel = COVERAGE_KERNEL_AUTO;
+    else if (strcmp(name, "incremental") == 0) *output_kernel = COVERAGE_KERNEL_INCREMENTAL;
+    else if (strcmp(name, "index") == 0) *output_kernel = COVERAGE_KERNEL_INDEX;
+    else if (strcmp(name, "contacts") == 0) *output_kernel = COVERAGE_KERNEL_CONTACTS;
+    else if (strcmp(name, "bitset") == 0) *output_kernel = get_best_bitset_kernel();
+    else if (strcmp(name, "bitset-scalar") == 0) *output_kernel = COVERAGE_KERNEL_BITSET_SCALAR;
+    else if (strcmp(name, "bitset-avx2") == 0)
+    {
+        if (!cpu_supports_avx2())
+        {
+            sprintf(output_error_msg, "evaluation kernel \"%s\" is not supported by this CPU", name);
+            return 1;
+        }
+        *output_kernel = COVERAGE_KERNEL_BITSET_AVX2;
+    }
+    else if (strcmp(name, "bitset-neon") == 0)
+    {
+#ifdef COVERAGE_BITSET_HAS_NEON
+        *output_kernel = COVERAGE_KERNEL_BITSET_NEON;
+#else
+        sprintf(output_error_msg, "evaluation kernel \"%s\" is not supported by this CPU", name);
+        return 1;
+#endif
+    }
+    else
+    {
+        sprintf(output_error_msg, "unknown evaluation kernel \"%s\" (expected auto, incremental, index,"
+        " contacts, bitset, bitset-scalar, bitset-avx2 or bitset-neon)", name);
+        return 1;
+    }
+
+    return 0;
+}
+
+const char* get_coverage_kernel_name(enum_coverage_kernel kernel)
+{
+    switch (kernel)
+    {
+    case COVERAGE_KERNEL_AUTO: return "auto";
+    case COVERAGE_KERNEL_INCREMENTAL: return "incremental";
+    case COVERAGE_KERNEL_INDEX: return "index";
+    case COVERAGE_KERNEL_CONTACTS: return "contacts";
+    case COVERAGE_KERNEL_BITSET_SCALAR: return "bitset-scalar";
+    case COVERAGE_KERNEL_BITSET_AVX2: return "bitset-avx2";
+    case COVERAGE_KERNEL_BITSET_NEON: return "bitset-neon";
+    }
+
+    return "unknown";
+}
+
+int is_bitset_kernel(enum_coverage_kernel kernel)
+{
+    return kernel == COVERAGE_KERNEL_BITSET_SCALAR || kernel == COVERAGE_KERNEL_BITSET_AVX2
+    || kernel == COVERAGE_KERNEL_BITSET_NEON;
+}
@@ -0,0 +1,83 @@
+#ifndef COMMON_COVERAGE_BITSET_H
+#define COMMON_COVERAGE_BITSET_H
+
+#include <stdint.h>
+
+#include "coverage.h"
+
+// How a solver evaluates a solution, chosen at runtime (--eval-kernel);
+typedef enum coverage_kernel_
+{
+    // Let the solver pick: a bitset kernel with 1 contact, otherwise its own default;
+    COVERAGE_KERNEL_AUTO,
+    // Coverage state updated RSU by RSU (see struct_coverage_state);
+    COVERAGE_KERNEL_INCREMENTAL,
+    // Walk of the per-vehicle index (count_covered_vehicles());
+    COVERAGE_KERNEL_INDEX,
+    // Byte contact counters of the vehicles reaching the solution cells (count_covered_vehicles_by_cells()),
+    // at most MAX_SATURATING_CONTACTS contacts;
+    COVERAGE_KERNEL_CONTACTS,
+    // Popcount of the union of the cells vehicle bitsets, only valid with 1 contact;
+    COVERAGE_KERNEL_BITSET_SCALAR,
+    COVERAGE_KERNEL_BITSET_AVX2,
+    COVERAGE_KERNEL_BITSET_NEON
+
+} enum_coverage_kernel;
+
+// One bitset over vehicles (dense indices of the vehicle to cells index) per frequented cell;
+// Bit v of a cell's bitset is set if the v-th vehicle reaches the cell within the threshold;
+typedef struct cell_bitsets_
+{
+    int num_vehicles;
+    // 64 bit words per bitset, rounded up so every SIMD kernel works on whole vectors;
+    int num_words;
+    int num_frequented_cells;
+
+    // Row of each cell in words, -1 if no vehicle reaches the cell;
+    int *cell_row;
+    uint64_t *words;
+
+} struct_cell_bitsets;
+
+// ==================== BITSET FUNCTIONS ==================== //
+// If succeedes, returns 0 and output_bitsets can be used (release it with free_cell_bitsets());
+// Otherwise, returns 1 and error_msg can be used;
+int build_cell_bitsets(
+    struct_coverage_indexes *indexes,
+    struct_cell_bitsets *output_bitsets,
+    char* output_error_msg
+);
+
+void free_cell_bitsets(struct_cell_bitsets *bitsets);
+
+// Number of vehicles reaching at least one of the cells, i.e. coverage with 1 contact;
+// kernel must be one of the COVERAGE_KERNEL_BITSET_* values returned by get_coverage_kernel_from_name();
+// rows is scratch of at least num_cells entries owned by the caller (one per thread), so counting never allocates;
+int count_covered_vehicles_bitset(
+    struct_cell_bitsets *bitsets,
+    const int *cells, int num_cells,
+    enum_coverage_kernel kernel,
+    const uint64_t **rows
+);
+// ==================== BITSET FUNCTIONS ==================== //
+
+// ==================== KERNEL SELECTION ==================== //
+// Accepts "auto", "incremental", "index", "contacts", "bitset" (fastest bitset kernel this CPU supports),
+// "bitset-scalar", "bitset-avx2" and "bitset-neon";
+// If succeedes, returns 0 and output_kernel can be used;
+// Otherwise, returns 1 and error_msg can be used;
+int get_coverage_kernel_from_name(
+    const char* name,
+    enum_coverage_kernel *output_kernel,
+    char* output_error_msg
+);
+
+// Fastest bitset kernel this CPU supports;
+enum_coverage_kernel get_best_bitset_kernel(void);
+
+const char* get_coverage_kernel_name(enum_coverage_kernel kernel);
+
+int is_bitset_kernel(enum_coverage_kernel kernel);
+// ==================== KERNEL SELECTION ==================== //
+
+#endif
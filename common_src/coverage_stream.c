@@ -0,0 +1,510 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+
+#include "coverage_stream.h"
+
+// Cells are keyed by their coordinates until the last chunk is read, then numbered densely;
+// Keys compare as dense cells do, by x then y;
+#define CELL_KEY(x, y)      ((long long) (x) * MAX_CELL_GRID_SIDE + (y))
+
+// Frequented cells of the chunks read so far, by increasing key, with their counts;
+typedef struct cell_counts_
+{
+    int num_cells;
+    long long *key;
+    int *records;
+    int *visits;
+
+} struct_cell_counts;
+
+// Vehicle to cells index growing chunk by chunk, with keyed cells;
+typedef struct keyed_index_
+{
+    int time_interval;
+
+    int num_vehicles;
+    int vehicle_capacity;
+    int *vehicle_offsets;
+
+    int num_entries;
+    int entry_capacity;
+    long long *cell_key;
+    int *num_records;
+    int *first_offset;
+
+} struct_keyed_index;
+
+// Everything kept between chunks;
+typedef struct stream_state_
+{
+    struct_trace_chunk_reader reader;
+    struct_cell_counts counts;
+    int num_indexes;
+    struct_keyed_index keyed_indexes[MAX_REDUCED_TRACE_INDEXES];
+
+} struct_stream_state;
+
+static void free_stream_state(struct_stream_state* state)
+{
+    close_trace_chunk_reader(&(state->reader));
+
+    free(state->counts.key);
+    free(state->counts.records);
+    free(state->counts.visits);
+    state->counts.key = NULL;
+    state->counts.records = NULL;
+    state->counts.visits = NULL;
+
+    int k;
+    for (k = 0; k < state->num_indexes; k++)
+    {
+        struct_keyed_index* keyed_index = &(state->keyed_indexes[k]);
+        free(keyed_index->vehicle_offsets);
+        free(keyed_index->cell_key);
+        free(keyed_index->num_records);
+        free(keyed_index->first_offset);
+        keyed_index->vehicle_offsets = NULL;
+        keyed_index->cell_key = NULL;
+        keyed_index->num_records = NULL;
+        keyed_index->first_offset = NULL;
+    }
+}
+
+// Resizes array to capacity items of item_size bytes;
+// Returns 0 if succeedes, 1 otherwise (and the array is unchanged);
+static int resize_items(void** array, size_t capacity, size_t item_size)
+{
+    void* resized_array = realloc(*array, capacity * item_size);
+    if (resized_array == NULL)
+    {
+        return 1;
+    }
+
+    *array = resized_array;
+    return 0;
+}
+
+// Capacity doubled from current_capacity (1024 at first) until it holds needed items;
+static int get_grown_capacity(int current_capacity, int needed)
+{
+    long long capacity = (current_capacity > 0) ? current_capacity : 1024;
+    while (capacity < needed)
+    {
+        capacity *= 2;
+    }
+
+    return (capacity < INT_MAX) ? (int) capacity : INT_MAX;
+}
+
+// Grows the arrays of keyed_index to hold num_vehicles vehicles and num_entries entries;
+// Returns 0 if succeedes, 1 otherwise;
+static int reserve_keyed_index(struct_keyed_index* keyed_index, int num_vehicles, int num_entries)
+{
+    if (num_vehicles + 1 > keyed_index->vehicle_capacity)
+    {
+        int capacity = get_grown_capacity(keyed_index->vehicle_capacity, num_vehicles + 1);
+        if (resize_items((void**) &(keyed_index->vehicle_offsets), (size_t) capacity, sizeof(int)) != 0)
+        {
+            return 1;
+        }
+        keyed_index->vehicle_capacity = capacity;
+    }
+
+    if (num_entries > keyed_index->entry_capacity)
+    {
+        int capacity = get_grown_capacity(keyed_index->entry_capacity, num_entries);
+        if (resize_items((void**) &(keyed_index->cell_key), (size_t) capacity, sizeof(long long)) != 0
+        || resize_items((void**) &(keyed_index->num_records), (size_t) capacity, sizeof(int)) != 0
+        || resize_items((void**) &(keyed_index->first_offset), (size_t) capacity, sizeof(int)) != 0)
+        {
+            return 1;
+        }
+        keyed_index->entry_capacity = capacity;
+    }
+
+    return 0;
+}
+
+// Adds the records and visits of the chunk cells to counts, merging both key orders;
+// Returns 0 if succeedes, 1 otherwise (and error_msg can be used);
+static int merge_chunk_cells(struct_cell_counts* counts, struct_trace* chunk,
+const int* chunk_records, const int* chunk_visits, char* output_error_msg)
+{
+    struct_cell_grid* grid = &(chunk->grid);
+    size_t max_num_cells = (size_t) counts->num_cells + (size_t) grid->num_cells;
+    long long* key = (long long*) malloc(sizeof(long long) * max_num_cells);
+    int* records = (int*) malloc(sizeof(int) * max_num_cells);
+    int* visits = (int*) malloc(sizeof(int) * max_num_cells);
+    if (!key || !records || !visits)
+    {
+        sprintf(output_error_msg, "can't allocate memory for the counts of %zu cells", max_num_cells);
+        free(key);
+        free(records);
+        free(visits);
+        return 1;
+    }
+
+    int num_cells = 0;
+    int i = 0;
+    int c = 0;
+    while (i < counts->num_cells || c < grid->num_cells)
+    {
+        long long chunk_key = (c < grid->num_cells) ? CELL_KEY(grid->cell_x[c], grid->cell_y[c]) : LLONG_MAX;
+        if (i < counts->num_cells && counts->key[i] <= chunk_key)
+        {
+            key[num_cells] = counts->key[i];
+            records[num_cells] = counts->records[i];
+            visits[num_cells] = counts->visits[i];
+            if (counts->key[i] == chunk_key)
+            {
+                records[num_cells] += chunk_records[c];
+                visits[num_cells] += chunk_visits[c];
+                c++;
+            }
+            i++;
+        }
+        else
+        {
+            key[num_cells] = chunk_key;
+            records[num_cells] = chunk_records[c];
+            visits[num_cells] = chunk_visits[c];
+            c++;
+        }
+        num_cells++;
+    }
+
+    free(counts->key);
+    free(counts->records);
+    free(counts->visits);
+    counts->num_cells = num_cells;
+    counts->key = key;
+    counts->records = records;
+    counts->visits = visits;
+
+    return 0;
+}
+
+// Counts the records and visits of each cell of the chunk and merges them into the state;
+// Returns 0 if succeedes, 1 otherwise (and error_msg can be used);
+static int count_chunk_cells(struct_stream_state* state, int visits_time_interval, char* output_error_msg)
+{
+    struct_trace* chunk = &(state->reader.chunk);
+    int* chunk_records = (int*) calloc((size_t) chunk->grid.num_cells, sizeof(int));
+    int* chunk_visits = (int*) calloc((size_t) chunk->grid.num_cells, sizeof(int));
+    if (!chunk_records || !chunk_visits)
+    {
+        sprintf(output_error_msg, "can't allocate memory for the counts of %d cells", chunk->grid.num_cells);
+        free(chunk_records);
+        free(chunk_visits);
+        return 1;
+    }
+
+    // Chunks start with a new vehicle, so counting each chunk from scratch counts as the whole trace;
+    int current_time = 0;
+    int current_vehicle = -1;
+    int i;
+    for (i = 0; i < chunk->size; i++)
+    {
+        chunk_records[ chunk->cell[i] ]++;
+        if (current_vehicle == chunk->vehicle_id[i])
+        {
+            if (current_time <= visits_time_interval)
+            {
+                chunk_visits[ chunk->cell[i] ]++;
+            }
+        }
+        else
+        {
+            current_time = 0;
+            current_vehicle = chunk->vehicle_id[i];
+            chunk_visits[ chunk->cell[i] ]++;
+        }
+        current_time = current_time + 10 * chunk->r[i];
+    }
+
+    int status = merge_chunk_cells(&(state->counts), chunk, chunk_records, chunk_visits, output_error_msg);
+    free(chunk_records);
+    free(chunk_visits);
+
+    return status;
+}
+
+// Reduces the chunk for the threshold of keyed_index and appends its vehicles;
+// Returns 0 if succeedes, 1 otherwise (and error_msg can be used);
+static int append_chunk_index(struct_keyed_index* keyed_index, struct_trace* chunk, char* output_error_msg)
+{
+    struct_vehicle_cells_index chunk_index;
+    int status = build_vehicle_cells_index(chunk, keyed_index->time_interval, &chunk_index, output_error_msg);
+    if (status != 0)
+    {
+        return 1;
+    }
+
+    if (chunk_index.num_entries > INT_MAX - keyed_index->num_entries
+    || reserve_keyed_index(keyed_index, keyed_index->num_vehicles + chunk_index.num_vehicles,
+    keyed_index->num_entries + chunk_index.num_entries) != 0)
+    {
+        sprintf(output_error_msg, "can't allocate memory for the index of %d vehicles",
+        keyed_index->num_vehicles + chunk_index.num_vehicles);
+        free_vehicle_cells_index(&chunk_index);
+        return 1;
+    }
+
+    int v;
+    for (v = 0; v < chunk_index.num_vehicles; v++)
+    {
+        keyed_index->vehicle_offsets[keyed_index->num_vehicles + v] =
+        keyed_index->num_entries + chunk_index.vehicle_offsets[v];
+    }
+
+    int e;
+    for (e = 0; e < chunk_index.num_entries; e++)
+    {
+        int c = chunk_index.cell[e];
+        keyed_index->cell_key[keyed_index->num_entries + e] = CELL_KEY(chunk->grid.cell_x[c], chunk->grid.cell_y[c]);
+    }
+    memcpy(keyed_index->num_records + keyed_index->num_entries, chunk_index.num_records,
+    sizeof(int) * (size_t) chunk_index.num_entries);
+    memcpy(keyed_index->first_offset + keyed_index->num_entries, chunk_index.first_offset,
+    sizeof(int) * (size_t) chunk_index.num_entries);
+
+    keyed_index->num_vehicles += chunk_index.num_vehicles;
+    keyed_index->num_entries += chunk_index.num_entries;
+    keyed_index->vehicle_offsets[keyed_index->num_vehicles] = keyed_index->num_entries;
+
+    free_vehicle_cells_index(&chunk_index);
+
+    return 0;
+}
+
+// Dense cell of key, which must be among the keys of counts;
+static int get_dense_cell(struct_cell_counts* counts, long long key)
+{
+    int low = 0;
+    int high = counts->num_cells;
+    while (low < high)
+    {
+        int middle = low + (high - low) / 2;
+        if (counts->key[middle] < key)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+// Numbers the keyed cells of keyed_index densely and builds both directions of the index;
+// The keyed entries are released as soon as they are numbered;
+// Returns 0 if succeedes, 1 otherwise (and error_msg can be used);
+static int finish_keyed_index(struct_keyed_index* keyed_index, struct_cell_counts* counts,
+struct_coverage_indexes* output_indexes, char* output_error_msg)
+{
+    int num_entries = keyed_index->num_entries;
+    int* cell = (int*) malloc(sizeof(int) * (size_t) (num_entries > 0 ? num_entries : 1));
+    if (cell == NULL)
+    {
+        sprintf(output_error_msg, "can't allocate memory for the index of %d entries", num_entries);
+        return 1;
+    }
+
+    int e;
+    for (e = 0; e < num_entries; e++)
+    {
+        cell[e] = get_dense_cell(counts, keyed_index->cell_key[e]);
+    }
+    free(keyed_index->cell_key);
+    keyed_index->cell_key = NULL;
+
+    struct_vehicle_cells_index* vehicle_cells = &(output_indexes->vehicle_cells);
+    vehicle_cells->num_vehicles = keyed_index->num_vehicles;
+    vehicle_cells->num_cells = counts->num_cells;
+    vehicle_cells->num_entries = num_entries;
+    vehicle_cells->time_interval = keyed_index->time_interval;
+    vehicle_cells->vehicle_offsets = keyed_index->vehicle_offsets;
+    vehicle_cells->cell = cell;
+    vehicle_cells->num_records = keyed_index->num_records;
+    vehicle_cells->first_offset = keyed_index->first_offset;
+
+    // The index owns the arrays from here on;
+    keyed_index->vehicle_offsets = NULL;
+    keyed_index->num_records = NULL;
+    keyed_index->first_offset = NULL;
+
+    int status = build_cell_vehicles_index(vehicle_cells, &(output_indexes->cell_vehicles), output_error_msg);
+    if (status != 0)
+    {
+        free_vehicle_cells_index(vehicle_cells);
+        return 1;
+    }
+
+    return 0;
+}
+
+// Grid of the keyed cells of counts, width and height as given;
+// Returns 0 if succeedes, 1 otherwise (and error_msg can be used);
+static int build_grid_from_keys(struct_cell_counts* counts, int width, int height,
+struct_cell_grid* output_grid, char* output_error_msg)
+{
+    int num_cells = counts->num_cells;
+    output_grid->width = width;
+    output_grid->height = height;
+    output_grid->num_cells = num_cells;
+    output_grid->cell_x = (int*) malloc(sizeof(int) * (size_t) (num_cells > 0 ? num_cells : 1));
+    output_grid->cell_y = (int*) malloc(sizeof(int) * (size_t) (num_cells > 0 ? num_cells : 1));
+    output_grid->column_offsets = (int*) calloc((size_t) width + 1, sizeof(int));
+    if (!output_grid->cell_x || !output_grid->cell_y || !output_grid->column_offsets)
+    {
+        sprintf(output_error_msg, "can't allocate memory for the cells of a %d x %d grid", width, height);
+        free_cell_grid(output_grid);
+        return 1;
+    }
+
+    int c, x;
+    for (c = 0; c < num_cells; c++)
+    {
+        output_grid->cell_x[c] = (int) (counts->key[c] / MAX_CELL_GRID_SIDE);
+        output_grid->cell_y[c] = (int) (counts->key[c] % MAX_CELL_GRID_SIDE);
+        output_grid->column_offsets[ output_grid->cell_x[c] + 1 ]++;
+    }
+    for (x = 0; x < width; x++)
+    {
+        output_grid->column_offsets[x + 1] += output_grid->column_offsets[x];
+    }
+
+    return 0;
+}
+
+int reduce_trace_in_chunks(const char* trace_file_name, size_t max_chunk_size_in_bytes,
+int visits_time_interval, const int* time_intervals, int num_time_intervals,
+struct_reduced_trace* output_reduced_trace, struct_trace_read_stats* output_stats,
+char* output_error_msg)
+{
+    struct timespec begin_timer;
+    clock_gettime(CLOCK_MONOTONIC, &begin_timer);
+
+    if (num_time_intervals < 1 || num_time_intervals > MAX_REDUCED_TRACE_INDEXES)
+    {
+        sprintf(output_error_msg, "can't reduce a trace for %d thresholds (1 to %d)",
+        num_time_intervals, MAX_REDUCED_TRACE_INDEXES);
+        return 1;
+    }
+
+    size_t max_chunk_records = max_chunk_size_in_bytes / CHUNK_BYTES_PER_RECORD;
+    if (max_chunk_records < 1) max_chunk_records = 1;
+    if (max_chunk_records > INT_MAX / 6) max_chunk_records = INT_MAX / 6;
+
+    struct_stream_state state;
+    memset(&state, 0, sizeof(state));
+    state.num_indexes = num_time_intervals;
+    int k;
+    for (k = 0; k < num_time_intervals; k++)
+    {
+        state.keyed_indexes[k].time_interval = time_intervals[k];
+    }
+
+    int status = open_trace_chunk_reader(trace_file_name, (int) max_chunk_records, &(state.reader), output_error_msg);
+    if (status != 0)
+    {
+        return 1;
+    }
+
+    memset(output_reduced_trace, 0, sizeof(*output_reduced_trace));
+
+    int has_chunk = 1;
+    while (has_chunk)
+    {
+        status = read_trace_chunk(&(state.reader), &has_chunk, output_error_msg);
+        if (status == 0 && has_chunk)
+        {
+            struct_trace* chunk = &(state.reader.chunk);
+            output_reduced_trace->num_chunks++;
+            if (chunk->size > output_reduced_trace->max_chunk_size)
+            {
+                output_reduced_trace->max_chunk_size = chunk->size;
+            }
+
+            status = count_chunk_cells(&state, visits_time_interval, output_error_msg);
+            for (k = 0; status == 0 && k < num_time_intervals; k++)
+            {
+                status = append_chunk_index(&(state.keyed_indexes[k]), chunk, output_error_msg);
+            }
+        }
+
+        if (status != 0)
+        {
+            free_stream_state(&state);
+            return 1;
+        }
+    }
+
+    output_reduced_trace->size = state.reader.num_records;
+    output_reduced_trace->num_vehicles = state.reader.num_vehicles;
+    output_stats->is_binary_format = state.reader.is_binary_format;
+    output_stats->file_size_in_bytes = state.reader.file_size_in_bytes;
+
+    // The last chunk is gone, the reduced trace is numbered with the cells of all of them;
+    int width = state.reader.chunk.grid.width;
+    int height = state.reader.chunk.grid.height;
+    close_trace_chunk_reader(&(state.reader));
+
+    status = build_grid_from_keys(&(state.counts), width, height, &(output_reduced_trace->grid), output_error_msg);
+    if (status != 0)
+    {
+        free_stream_state(&state);
+        return 1;
+    }
+
+    for (k = 0; k < num_time_intervals; k++)
+    {
+        status = finish_keyed_index(&(state.keyed_indexes[k]), &(state.counts),
+        &(output_reduced_trace->indexes[k]), output_error_msg);
+        if (status != 0)
+        {
+            free_stream_state(&state);
+            free_reduced_trace(output_reduced_trace);
+            return 1;
+        }
+        output_reduced_trace->num_indexes++;
+    }
+
+    output_reduced_trace->cell_records = state.counts.records;
+    output_reduced_trace->cell_visits = state.counts.visits;
+    state.counts.records = NULL;
+    state.counts.visits = NULL;
+    free_stream_state(&state);
+
+    struct timespec end_timer;
+    clock_gettime(CLOCK_MONOTONIC, &end_timer);
+    double read_time_in_secs = (double) (end_timer.tv_sec - begin_timer.tv_sec)
+    + (double) (end_timer.tv_nsec - begin_timer.tv_nsec) / 1e9;
+
+    output_stats->read_time_in_secs = read_time_in_secs;
+    output_stats->throughput_in_mb_per_sec = (read_time_in_secs > 0) ?
+    ((double) output_stats->file_size_in_bytes / 1e6) / read_time_in_secs : 0;
+
+    return 0;
+}
+
+void free_reduced_trace(struct_reduced_trace* reduced_trace)
+{
+    free_cell_grid(&(reduced_trace->grid));
+    free(reduced_trace->cell_records);
+    free(reduced_trace->cell_visits);
+    reduced_trace->cell_records = NULL;
+    reduced_trace->cell_visits = NULL;
+
+    int k;
+    for (k = 0; k < reduced_trace->num_indexes; k++)
+    {
+        free_coverage_indexes(&(reduced_trace->indexes[k]));
+    }
+    reduced_trace->num_indexes = 0;
+}
@@ -0,0 +1,57 @@
+#ifndef COMMON_COVERAGE_STREAM_H
+#define COMMON_COVERAGE_STREAM_H
+
+#include "coverage.h"
+
+// Thresholds reduced in the same pass, e.g. the objective's and the coverage curve's;
+#define MAX_REDUCED_TRACE_INDEXES       2
+
+// Approximate bytes a chunk takes per record: its columns, dense cells and the scratch
+// of build_trace_cells() and of one vehicle to cells index per threshold;
+#define CHUNK_BYTES_PER_RECORD          64
+
+// What the solvers need from a trace, read in chunks of whole vehicles (see read_trace_chunk());
+// Each chunk is reduced to the cells its vehicles reach and dropped, so the records are never all in memory;
+// Everything is the same as reading the whole trace, dense cells and vehicles included;
+// Members are heap blocks a solver can take one by one, the rest is released with free_reduced_trace();
+typedef struct reduced_trace_
+{
+    long long size;
+    int num_vehicles;
+    int num_chunks;
+    // Records of the biggest chunk;
+    int max_chunk_size;
+
+    struct_cell_grid grid;
+    // Records of each dense cell;
+    int *cell_records;
+    // Records of each dense cell counted as fill_scores_in_cells() of n-deployment and greedy counts them:
+    // the first record of each vehicle, then its records while the sum of 10 * r of the previous ones
+    // is <= visits_time_interval;
+    int *cell_visits;
+
+    // One index per threshold, in the order they were given;
+    int num_indexes;
+    struct_coverage_indexes indexes[MAX_REDUCED_TRACE_INDEXES];
+
+} struct_reduced_trace;
+
+// ==================== STREAM FUNCTIONS ==================== //
+// Chunks hold about max_chunk_size_in_bytes / CHUNK_BYTES_PER_RECORD records;
+// If succeedes, returns 0, output_reduced_trace and output_stats can be used and
+// output_reduced_trace must be released with free_reduced_trace();
+// Otherwise, returns 1 and error_msg can be used;
+int reduce_trace_in_chunks(
+    const char* trace_file_name,
+    size_t max_chunk_size_in_bytes,
+    int visits_time_interval,
+    const int *time_intervals, int num_time_intervals,
+    struct_reduced_trace *output_reduced_trace,
+    struct_trace_read_stats *output_stats,
+    char* output_error_msg
+);
+
+void free_reduced_trace(struct_reduced_trace *reduced_trace);
+// ==================== STREAM FUNCTIONS ==================== //
+
+#endif
@@ -0,0 +1,137 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "metrics.h"
+#include "trace.h"
+
+static const char* METRICS_PHASE_NAMES[NUM_METRICS_PHASES] =
+{
+    "load", "index", "construct", "evaluate", "local_search", "path_relinking", "output"
+};
+
+static const char* METRICS_COUNTER_NAMES[NUM_METRICS_COUNTERS] =
+{
+    "records_scanned", "evaluations", "gain_evaluations", "rcl_draws", "ls_moves"
+};
+
+void start_metrics_timer(struct_metrics_timer *timer)
+{
+    clock_gettime(CLOCK_MONOTONIC, &(timer->wall_begin));
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &(timer->cpu_begin));
+}
+
+void read_metrics_timer(struct_metrics_timer *timer, double *output_wall_time, double *output_cpu_time)
+{
+    struct timespec wall_end;
+    struct timespec cpu_end;
+    clock_gettime(CLOCK_MONOTONIC, &wall_end);
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu_end);
+
+    *output_wall_time = (wall_end.tv_sec - timer->wall_begin.tv_sec) + (wall_end.tv_nsec - timer->wall_begin.tv_nsec) / 1e9;
+    *output_cpu_time = (cpu_end.tv_sec - timer->cpu_begin.tv_sec) + (cpu_end.tv_nsec - timer->cpu_begin.tv_nsec) / 1e9;
+}
+
+void init_run_metrics(struct_run_metrics *metrics)
+{
+    memset(metrics, 0, sizeof(*metrics));
+
+    start_metrics_timer(&(metrics->run_timer));
+}
+
+void begin_metrics_phase(struct_run_metrics *metrics, enum_metrics_phase phase)
+{
+    start_metrics_timer(&(metrics->phases[phase].timer));
+}
+
+void end_metrics_phase(struct_run_metrics *metrics, enum_metrics_phase phase)
+{
+    double wall_time;
+    double cpu_time;
+    read_metrics_timer(&(metrics->phases[phase].timer), &wall_time, &cpu_time);
+
+    add_metrics_phase_time(metrics, phase, wall_time, cpu_time, 1);
+}
+
+void add_metrics_phase_time(struct_run_metrics *metrics, enum_metrics_phase phase,
+double wall_time, double cpu_time, long long num_calls)
+{
+    struct_phase_metrics* phase_metrics = &(metrics->phases[phase]);
+    phase_metrics->wall_time += wall_time;
+    phase_metrics->cpu_time += cpu_time;
+    phase_metrics->num_calls += num_calls;
+}
+
+void add_metrics_thread_time(struct_run_metrics *metrics, enum_metrics_phase phase,
+double thread_time, long long num_calls)
+{
+    struct_phase_metrics* phase_metrics = &(metrics->phases[phase]);
+    phase_metrics->thread_time += thread_time;
+    phase_metrics->is_summed_over_threads = 1;
+    phase_metrics->num_calls += num_calls;
+}
+
+void add_metrics_counter(struct_run_metrics *metrics, enum_metrics_counter counter, long long value)
+{
+    metrics->counters[counter] += value;
+}
+
+int write_metrics_to_file(const char* metrics_file_name, const char* solver_name,
+struct_run_metrics *metrics, char* output_error_msg)
+{
+    FILE* metrics_file = fopen(metrics_file_name, "w");
+    if (metrics_file == NULL)
+    {
+        sprintf(output_error_msg, "can't open file \"%s\"", metrics_file_name);
+        return 1;
+    }
+
+    double wall_time;
+    double cpu_time;
+    read_metrics_timer(&(metrics->run_timer), &wall_time, &cpu_time);
+
+    fprintf(metrics_file, "{\"solver\": \"%s\", \"wall_time\": %.06f, \"cpu_time\": %.06f, \"peak_rss_mb\": %.1f,\n",
+    solver_name, wall_time, cpu_time, get_peak_rss_in_mb());
+
+    fprintf(metrics_file, " \"phases\": {");
+    int p;
+    for (p = 0; p < NUM_METRICS_PHASES; p++)
+    {
+        struct_phase_metrics* phase_metrics = &(metrics->phases[p]);
+        fprintf(metrics_file, "%s\n  \"%s\": ", (p > 0) ? "," : "", METRICS_PHASE_NAMES[p]);
+        if (phase_metrics->num_calls == 0)
+        {
+            fprintf(metrics_file, "null");
+            continue;
+        }
+
+        fprintf(metrics_file, "{");
+        if (phase_metrics->is_summed_over_threads)
+        {
+            fprintf(metrics_file, "\"wall_time\": null, \"cpu_time\": null, \"thread_time\": %.06f, ",
+            phase_metrics->thread_time);
+        }
+        else
+        {
+            fprintf(metrics_file, "\"wall_time\": %.06f, \"cpu_time\": %.06f, \"thread_time\": null, ",
+            phase_metrics->wall_time, phase_metrics->cpu_time);
+        }
+        fprintf(metrics_file, "\"calls\": %lld}", phase_metrics->num_calls);
+    }
+    fprintf(metrics_file, "},\n");
+
+    fprintf(metrics_file, " \"counters\": {");
+    int c;
+    for (c = 0; c < NUM_METRICS_COUNTERS; c++)
+    {
+        fprintf(metrics_file, "%s\"%s\": %lld", (c > 0) ? ", " : "", METRICS_COUNTER_NAMES[c], metrics->counters[c]);
+    }
+    fprintf(metrics_file, "}}\n");
+
+    if (fclose(metrics_file) != 0)
+    {
+        sprintf(output_error_msg, "can't write file \"%s\"", metrics_file_name);
+        return 1;
+    }
+
+    return 0;
+}
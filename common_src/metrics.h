@@ -0,0 +1,120 @@
+#ifndef COMMON_METRICS_H
+#define COMMON_METRICS_H
+
+#include <time.h>
+
+// Phases of a solver run, see write_metrics_to_file();
+typedef enum metrics_phase_
+{
+    // Reading the trace, or reducing it with --stream (which also builds the indexes and scores);
+    METRICS_PHASE_LOAD,
+    // Coverage indexes, bitsets, cells scores and their ranking;
+    METRICS_PHASE_INDEX,
+    // Picking the RSUs of the solutions;
+    METRICS_PHASE_CONSTRUCT,
+    // Counting the vehicles the solutions cover;
+    METRICS_PHASE_EVALUATE,
+    METRICS_PHASE_LOCAL_SEARCH,
+    // Relinking the solutions with the elite pool, and the local search of the relinked ones;
+    METRICS_PHASE_PATH_RELINKING,
+    // Summary, rsus, log and curve files;
+    METRICS_PHASE_OUTPUT,
+    NUM_METRICS_PHASES
+
+} enum_metrics_phase;
+
+typedef enum metrics_counter_
+{
+    // Trace records read;
+    METRICS_COUNTER_RECORDS_SCANNED,
+    // Solutions whose coverage was counted;
+    METRICS_COUNTER_EVALUATIONS,
+    // Marginal gains computed (CELF greedy, n-deployment local search and path relinking);
+    METRICS_COUNTER_GAIN_EVALUATIONS,
+    // Cells picked from a GRASP restricted candidate list;
+    METRICS_COUNTER_RCL_DRAWS,
+    // Swaps applied by the local search;
+    METRICS_COUNTER_LS_MOVES,
+    NUM_METRICS_COUNTERS
+
+} enum_metrics_counter;
+
+// Monotonic wall clock and process CPU time, unlike clock() which is CPU time only
+// and adds up the CPU time of every thread;
+typedef struct metrics_timer_
+{
+    struct timespec wall_begin;
+    struct timespec cpu_begin;
+
+} struct_metrics_timer;
+
+typedef struct phase_metrics_
+{
+    double wall_time;
+    double cpu_time;
+    // Time of the phase summed over threads, see add_metrics_thread_time();
+    double thread_time;
+    // 1 once a thread time is added, the phase then has no wall clock and CPU time;
+    int is_summed_over_threads;
+    long long num_calls;
+
+    // Of the phase begun last;
+    struct_metrics_timer timer;
+
+} struct_phase_metrics;
+
+// Per phase times and counters of a run, plain values so a copy can go on with its own phases
+// (e.g. one copy per budget of a sweep, after the shared load and index phases);
+typedef struct run_metrics_
+{
+    struct_metrics_timer run_timer;
+    struct_phase_metrics phases[NUM_METRICS_PHASES];
+    long long counters[NUM_METRICS_COUNTERS];
+
+} struct_run_metrics;
+
+// ==================== TIMER FUNCTIONS ==================== //
+void start_metrics_timer(struct_metrics_timer *timer);
+
+// Wall clock and process CPU seconds since the timer started;
+void read_metrics_timer(struct_metrics_timer *timer, double *output_wall_time, double *output_cpu_time);
+// ==================== TIMER FUNCTIONS ==================== //
+
+// ==================== METRICS FUNCTIONS ==================== //
+// Zeroes every phase and counter and starts the run timer;
+void init_run_metrics(struct_run_metrics *metrics);
+
+// A phase may be begun and ended many times, its times add up;
+void begin_metrics_phase(struct_run_metrics *metrics, enum_metrics_phase phase);
+void end_metrics_phase(struct_run_metrics *metrics, enum_metrics_phase phase);
+
+// Adds times measured elsewhere;
+void add_metrics_phase_time(
+    struct_run_metrics *metrics, enum_metrics_phase phase,
+    double wall_time, double cpu_time, long long num_calls
+);
+
+// Adds the time of a phase run by many threads at once, summed over them (e.g. over the GRASP iterations
+// of every thread), which can be more than the wall clock time of the run;
+void add_metrics_thread_time(
+    struct_run_metrics *metrics, enum_metrics_phase phase,
+    double thread_time, long long num_calls
+);
+
+void add_metrics_counter(struct_run_metrics *metrics, enum_metrics_counter counter, long long value);
+// ==================== METRICS FUNCTIONS ==================== //
+
+// ==================== OUTPUT FUNCTIONS ==================== //
+// Writes one JSON object: solver, wall and CPU time since init_run_metrics(), peak RSS,
+// then wall time, CPU time, thread time and calls of every phase (null if it wasn't run) and the counters;
+// If succeedes, returns 0;
+// Otherwise, returns 1 and error_msg can be used;
+int write_metrics_to_file(
+    const char* metrics_file_name,
+    const char* solver_name,
+    struct_run_metrics *metrics,
+    char* output_error_msg
+);
+// ==================== OUTPUT FUNCTIONS ==================== //
+
+#endif
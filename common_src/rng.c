@@ -0,0 +1,60 @@
+#include "rng.h"
+
+#define PHILOX_M0                   0xD2511F53u
+#define PHILOX_M1                   0xCD9E8D57u
+#define PHILOX_W0                   0x9E3779B9u
+#define PHILOX_W1                   0xBB67AE85u
+#define PHILOX_NUM_ROUNDS           10
+
+void philox4x32_10(const uint32_t counter[4], const uint32_t key[2], uint32_t output[4])
+{
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    uint32_t k0 = key[0], k1 = key[1];
+
+    int round;
+    for (round = 0; round < PHILOX_NUM_ROUNDS; round++)
+    {
+        uint64_t product0 = (uint64_t) PHILOX_M0 * c0;
+        uint64_t product1 = (uint64_t) PHILOX_M1 * c2;
+
+        c0 = (uint32_t) (product1 >> 32) ^ c1 ^ k0;
+        c1 = (uint32_t) product1;
+        c2 = (uint32_t) (product0 >> 32) ^ c3 ^ k1;
+        c3 = (uint32_t) product0;
+
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+
+    output[0] = c0;
+    output[1] = c1;
+    output[2] = c2;
+    output[3] = c3;
+}
+
+uint32_t get_bounded_random(uint64_t seed, uint32_t stream, uint32_t index, uint32_t bound)
+{
+    const uint32_t key[2] = { (uint32_t) seed, (uint32_t) (seed >> 32) };
+    // counter[2] numbers the blocks of 4 outputs of the draw, only past the first one on rejection;
+    uint32_t counter[4] = { index, stream, 0, 0 };
+    uint32_t output[4];
+    // 2^32 mod bound, values below it are rejected;
+    uint32_t threshold = (uint32_t) (-bound) % bound;
+
+    while (1)
+    {
+        philox4x32_10(counter, key, output);
+
+        int i;
+        for (i = 0; i < 4; i++)
+        {
+            uint64_t product = (uint64_t) output[i] * bound;
+            if ((uint32_t) product >= threshold)
+            {
+                return (uint32_t) (product >> 32);
+            }
+        }
+
+        counter[2]++;
+    }
+}
@@ -0,0 +1,20 @@
+#ifndef COMMON_RNG_H
+#define COMMON_RNG_H
+
+#include <stdint.h>
+
+// Philox4x32-10 counter-based generator (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC'11);
+// Output is a pure function of (counter, key): no state, so any draw can be computed on its own,
+// on any thread, with the same result on every machine;
+
+// ==================== RNG FUNCTIONS ==================== //
+void philox4x32_10(const uint32_t counter[4], const uint32_t key[2], uint32_t output[4]);
+
+// Uniform integer in [0, bound), bound > 0, for draw index of stream of seed
+// (e.g. stream = GRASP iteration, index = pick inside the iteration);
+// Unbiased (Lemire's multiply-shift with rejection), rejected values are replaced by the next outputs
+// of the same (seed, stream, index) counter;
+uint32_t get_bounded_random(uint64_t seed, uint32_t stream, uint32_t index, uint32_t bound);
+// ==================== RNG FUNCTIONS ==================== //
+
+#endif
@@ -0,0 +1,1078 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+
+#include "trace.h"
+
+// Parses an optionally negative decimal integer starting at p;
+// Returns a pointer to the first byte after the digits, or NULL if there are no digits;
+// IMPORTANT: the caller guarantees a non-digit byte exists before the end of the buffer,
+// so the digit loop needs no bounds check;
+static const char* parse_int_field(const char* p, int* output_value)
+{
+    int negative = (*p == '-');
+    p += negative;
+
+    const char* digits_begin = p;
+    unsigned int value = 0;
+    unsigned int digit;
+    while ((digit = (unsigned int) (*p - '0')) < 10)
+    {
+        value = value * 10 + digit;
+        p++;
+    }
+
+    if (p == digits_begin)
+    {
+        return NULL;
+    }
+
+    *output_value = negative ? -(int) value : (int) value;
+    return p;
+}
+
+// Field order of a trace line;
+enum { FIELD_VEHICLE_ID, FIELD_TIME, FIELD_GRID_X_POS, FIELD_GRID_Y_POS, FIELD_R, NUM_FIELDS };
+
+// Parses "vehicle;time;x;y;r;" starting at p, p must be the beginning of a non empty line;
+// Returns a pointer to the byte after the last field, or NULL if the line is malformed;
+static const char* parse_trace_line(const char* p, int output_fields[NUM_FIELDS])
+{
+    int i;
+    for (i = 0; i < FIELD_R; i++)
+    {
+        p = parse_int_field(p, &output_fields[i]);
+        if (p == NULL || *p++ != ';') return NULL;
+    }
+
+    return parse_int_field(p, &output_fields[FIELD_R]);
+}
+
+// Validates and stores one parsed line (line_number of the file), storage has room for it;
+// Returns 0 if the line was stored, 1 otherwise (and error_msg can be used);
+static int store_trace_line(
+    const char* trace_file_name, const int fields[NUM_FIELDS], int line_number,
+    struct_trace* output_trace, int* last_seen_vehicle_id,
+    char* output_error_msg)
+{
+    int num_read_lines = output_trace->size;
+
+    // A new run of lines is the next dense vehicle, whatever its id;
+    if (fields[FIELD_VEHICLE_ID] != *last_seen_vehicle_id)
+    {
+        output_trace->vehicle_offsets[output_trace->num_vehicles] = num_read_lines;
+        output_trace->num_vehicles++;
+        *last_seen_vehicle_id = fields[FIELD_VEHICLE_ID];
+    }
+
+    // Unsigned comparison does both bound checks of each coordinate at once;
+    if (((unsigned int) fields[FIELD_GRID_X_POS] >= MAX_CELL_GRID_SIDE) |
+        ((unsigned int) fields[FIELD_GRID_Y_POS] >= MAX_CELL_GRID_SIDE))
+    {
+        sprintf(output_error_msg,
+        "file \"%s\" contains a cell with coordinates out of bounds in line %d."
+        " Allowed: (0 <= x < %d) (0 <= y < %d)",
+        trace_file_name, line_number, MAX_CELL_GRID_SIDE, MAX_CELL_GRID_SIDE);
+        return 1;
+    }
+
+    // The grid of a text trace is as big as its biggest coordinates;
+    if (fields[FIELD_GRID_X_POS] >= output_trace->grid.width) output_trace->grid.width = fields[FIELD_GRID_X_POS] + 1;
+    if (fields[FIELD_GRID_Y_POS] >= output_trace->grid.height) output_trace->grid.height = fields[FIELD_GRID_Y_POS] + 1;
+
+    output_trace->vehicle_id[num_read_lines] = fields[FIELD_VEHICLE_ID];
+    output_trace->time[num_read_lines] = fields[FIELD_TIME];
+    output_trace->grid_x_pos[num_read_lines] = fields[FIELD_GRID_X_POS];
+    output_trace->grid_y_pos[num_read_lines] = fields[FIELD_GRID_Y_POS];
+    output_trace->r[num_read_lines] = fields[FIELD_R];
+    output_trace->size++;
+
+    return 0;
+}
+
+// Points the columns of trace to consecutive regions of its storage;
+static void set_trace_columns(struct_trace* trace, int* columns_begin, int num_records)
+{
+    trace->vehicle_id = columns_begin;
+    trace->time = trace->vehicle_id + num_records;
+    trace->grid_x_pos = trace->time + num_records;
+    trace->grid_y_pos = trace->grid_x_pos + num_records;
+    trace->r = trace->grid_y_pos + num_records;
+    trace->vehicle_offsets = trace->r + num_records;
+}
+
+// IMPORTANT:
+// Assumes, for each vehicle, its trace is composed by adjacent lines,
+// int is big enough for every value, and fields are integers separated only by ';'
+// (the trailing ';' is optional). Empty lines are skipped;
+// The text is parsed in place, there is no per line copy;
+// Storage is sized from the file: one record per line and one vehicle per record at most,
+// then shrunk to the records and vehicles actually read;
+static int read_text_trace(const char* trace_file_name, const char* file_begin, size_t file_size,
+struct_trace* output_trace, char* output_error_msg)
+{
+    const char* file_end = file_begin + file_size;
+
+    size_t max_num_records = (file_end[-1] != '\n');
+    const char* line_break = file_begin;
+    while ((line_break = (const char*) memchr(line_break, '\n', file_end - line_break)) != NULL)
+    {
+        max_num_records++;
+        line_break++;
+    }
+
+    if (max_num_records > (size_t) INT_MAX - 1)
+    {
+        sprintf(output_error_msg, "file \"%s\" is too big (max is %d lines)", trace_file_name, INT_MAX - 1);
+        return 1;
+    }
+
+    size_t storage_size = sizeof(int) * ((size_t) 6 * max_num_records + 1);
+    int* storage = (int*) malloc(storage_size);
+    if (storage == NULL)
+    {
+        sprintf(output_error_msg, "can't allocate memory for %zu trace lines", max_num_records);
+        return 1;
+    }
+
+    output_trace->size = 0;
+    output_trace->num_vehicles = 0;
+    output_trace->grid.width = 0;
+    output_trace->grid.height = 0;
+    output_trace->storage = storage;
+    output_trace->storage_size = storage_size;
+    output_trace->storage_is_mapped = 0;
+    set_trace_columns(output_trace, storage, (int) max_num_records);
+
+    // Every complete line ends with '\n', which stops the digit loops of the parser;
+    // Bytes after the last '\n' (a last line without line break) are parsed from a copy;
+    const char* last_line_break = file_end;
+    while (last_line_break > file_begin && last_line_break[-1] != '\n')
+    {
+        last_line_break--;
+    }
+
+    int last_seen_vehicle_id = -1;
+    int num_file_lines = 0;
+    int status = 0;
+
+    int aux[NUM_FIELDS];
+
+    const char* p = file_begin;
+    while (p < last_line_break)
+    {
+        num_file_lines++;
+
+        if (*p == '\n' || *p == '\r')
+        {
+            p = (const char*) memchr(p, '\n', last_line_break - p) + 1;
+            continue;
+        }
+
+        const char* line_rest = parse_trace_line(p, aux);
+        if (line_rest == NULL)
+        {
+            sprintf(output_error_msg, "file \"%s\" contains a malformed line %d"
+            " (expected \"vehicle;time;x;y;r;\")", trace_file_name, num_file_lines);
+            status = 1;
+            break;
+        }
+
+        status = store_trace_line(trace_file_name, aux, num_file_lines, output_trace,
+        &last_seen_vehicle_id, output_error_msg);
+        if (status != 0)
+        {
+            break;
+        }
+
+        p = (const char*) memchr(line_rest, '\n', last_line_break - line_rest) + 1;
+    }
+
+    if (status == 0 && last_line_break < file_end)
+    {
+        char line_buffer[201];
+        size_t last_line_size = file_end - last_line_break;
+        if (last_line_size > sizeof(line_buffer) - 2)
+        {
+            last_line_size = sizeof(line_buffer) - 2;
+        }
+        memcpy(line_buffer, last_line_break, last_line_size);
+        line_buffer[last_line_size] = '\n';
+        line_buffer[last_line_size + 1] = '\0';
+
+        num_file_lines++;
+        if (line_buffer[0] != '\r' && line_buffer[0] != '\n')
+        {
+            if (parse_trace_line(line_buffer, aux) == NULL)
+            {
+                sprintf(output_error_msg, "file \"%s\" contains a malformed line %d"
+                " (expected \"vehicle;time;x;y;r;\")", trace_file_name, num_file_lines);
+                status = 1;
+            }
+            else
+            {
+                status = store_trace_line(trace_file_name, aux, num_file_lines, output_trace,
+                &last_seen_vehicle_id, output_error_msg);
+            }
+        }
+    }
+
+    if (status == 0 && output_trace->size == 0)
+    {
+        sprintf(output_error_msg, "file \"%s\" is empty", trace_file_name);
+        status = 1;
+    }
+
+    if (status != 0)
+    {
+        free_trace(output_trace);
+        return 1;
+    }
+
+    output_trace->vehicle_offsets[output_trace->num_vehicles] = output_trace->size;
+
+    // Pack the columns (they only move if there were empty lines) and give back the rest;
+    size_t num_records = (size_t) output_trace->size;
+    size_t num_vehicle_offsets = (size_t) output_trace->num_vehicles + 1;
+    int column;
+    for (column = 1; column <= 5; column++)
+    {
+        memmove(storage + column * num_records, storage + column * max_num_records,
+        sizeof(int) * ((column < 5) ? num_records : num_vehicle_offsets));
+    }
+
+    storage_size = sizeof(int) * (5 * num_records + num_vehicle_offsets);
+    int* shrunk_storage = (int*) realloc(storage, storage_size);
+    if (shrunk_storage != NULL)
+    {
+        storage = shrunk_storage;
+        output_trace->storage = storage;
+        output_trace->storage_size = storage_size;
+    }
+    set_trace_columns(output_trace, storage, output_trace->size);
+
+    return 0;
+}
+
+// Checks the header against the size of the binary file;
+// Returns 0 if it's valid, 1 otherwise (and error_msg can be used);
+static int validate_binary_header(const char* trace_file_name, struct_trace_bin_header header,
+size_t file_size, char* output_error_msg)
+{
+    if (header.version != TRACE_BIN_VERSION || header.byte_order_mark != 0x01020304)
+    {
+        sprintf(output_error_msg, "binary file \"%s\" was written by another version"
+        " or on a machine with another byte order, convert the text trace again", trace_file_name);
+        return 1;
+    }
+
+    if (header.num_records <= 0)
+    {
+        sprintf(output_error_msg, "file \"%s\" is empty", trace_file_name);
+        return 1;
+    }
+
+    if (header.num_vehicles <= 0 || header.num_vehicles > header.num_records)
+    {
+        sprintf(output_error_msg, "file \"%s\" contains %d vehicles for %d records",
+        trace_file_name, header.num_vehicles, header.num_records);
+        return 1;
+    }
+
+    if (header.grid_width <= 0 || header.grid_width > MAX_CELL_GRID_SIDE
+    || header.grid_height <= 0 || header.grid_height > MAX_CELL_GRID_SIDE)
+    {
+        sprintf(output_error_msg,
+        "file \"%s\" contains cells with coordinates out of bounds."
+        " Allowed: (0 <= x < %d) (0 <= y < %d)",
+        trace_file_name, MAX_CELL_GRID_SIDE, MAX_CELL_GRID_SIDE);
+        return 1;
+    }
+
+    size_t expected_file_size = sizeof(header) +
+    sizeof(int) * ((size_t) 5 * header.num_records + header.num_vehicles + 1);
+    if (file_size != expected_file_size)
+    {
+        sprintf(output_error_msg, "binary file \"%s\" is truncated", trace_file_name);
+        return 1;
+    }
+
+    return 0;
+}
+
+// Vehicle offsets are used as is by every per-vehicle loop, so they are checked in O(vehicles):
+// from 0 to the number of records, never decreasing, and each vehicle starting where the id changes
+// as the chunk reader splits them;
+// Returns 0 if they are valid, 1 otherwise (and error_msg can be used);
+static int validate_binary_vehicle_offsets(const char* trace_file_name, const struct_trace* trace,
+char* output_error_msg)
+{
+    const int* offsets = trace->vehicle_offsets;
+    int is_valid = (offsets[0] == 0 && offsets[trace->num_vehicles] == trace->size);
+    int v;
+    for (v = 1; v <= trace->num_vehicles && is_valid; v++)
+    {
+        is_valid = (offsets[v] >= offsets[v - 1]) && (offsets[v] <= trace->size);
+        if (is_valid && v < trace->num_vehicles && offsets[v] > 0 && offsets[v] < trace->size)
+        {
+            is_valid = (trace->vehicle_id[ offsets[v] ] != trace->vehicle_id[ offsets[v] - 1 ]);
+        }
+    }
+
+    if (!is_valid)
+    {
+        sprintf(output_error_msg, "binary file \"%s\" is corrupt (vehicle offsets), convert the text trace again",
+        trace_file_name);
+        return 1;
+    }
+
+    return 0;
+}
+
+// Columns are used straight from the file mapping, nothing is parsed or copied;
+static int read_binary_trace(const char* trace_file_name, void* file_begin, size_t file_size,
+struct_trace* output_trace, char* output_error_msg)
+{
+    struct_trace_bin_header header;
+    if (file_size < sizeof(header))
+    {
+        sprintf(output_error_msg, "binary file \"%s\" is truncated", trace_file_name);
+        return 1;
+    }
+    memcpy(&header, file_begin, sizeof(header));
+
+    if (validate_binary_header(trace_file_name, header, file_size, output_error_msg) != 0)
+    {
+        return 1;
+    }
+
+    output_trace->size = header.num_records;
+    output_trace->num_vehicles = header.num_vehicles;
+    output_trace->grid.width = header.grid_width;
+    output_trace->grid.height = header.grid_height;
+    output_trace->storage = file_begin;
+    output_trace->storage_size = file_size;
+    output_trace->storage_is_mapped = 1;
+    set_trace_columns(output_trace, (int*) ((char*) file_begin + sizeof(header)), header.num_records);
+
+    return validate_binary_vehicle_offsets(trace_file_name, output_trace, output_error_msg);
+}
+
+static int compare_ints(const void* a, const void* b)
+{
+    int x = *(const int*) a;
+    int y = *(const int*) b;
+    return (x > y) - (x < y);
+}
+
+// Numbers the frequented cells column by column, so the cost is linear in the records
+// plus the grid sides, plus sorting the few distinct cells of each column;
+// Grid width and height must be set, records outside them are an error;
+// If succeedes, returns 0 and trace->cell and trace->grid can be used;
+// Otherwise, returns 1 and error_msg can be used;
+static int build_trace_cells(const char* trace_file_name, struct_trace* trace, char* output_error_msg)
+{
+    struct_cell_grid* grid = &(trace->grid);
+    int width = grid->width;
+    int height = grid->height;
+    size_t num_records = (size_t) trace->size;
+
+    int* cell = (int*) malloc(sizeof(int) * num_records);
+    int* cell_x = (int*) malloc(sizeof(int) * num_records);
+    int* cell_y = (int*) malloc(sizeof(int) * num_records);
+    int* column_offsets = (int*) calloc((size_t) width + 1, sizeof(int));
+    // Records sorted by column, and per y the last column it was seen in and its dense cell there;
+    int* column_records = (int*) malloc(sizeof(int) * num_records);
+    int* y_column = (int*) malloc(sizeof(int) * (size_t) height);
+    int* y_cell = (int*) malloc(sizeof(int) * (size_t) height);
+    if (!cell || !cell_x || !cell_y || !column_offsets || !column_records || !y_column || !y_cell)
+    {
+        sprintf(output_error_msg, "can't allocate memory for the cells of a %d x %d grid", width, height);
+        free(cell);
+        free(cell_x);
+        free(cell_y);
+        free(column_offsets);
+        free(column_records);
+        free(y_column);
+        free(y_cell);
+        return 1;
+    }
+
+    // Counting sort of the records by column;
+    int i;
+    for (i = 0; i < trace->size; i++)
+    {
+        if (((unsigned int) trace->grid_x_pos[i] >= (unsigned int) width) |
+            ((unsigned int) trace->grid_y_pos[i] >= (unsigned int) height))
+        {
+            sprintf(output_error_msg,
+            "file \"%s\" contains a cell with coordinates out of bounds in record %d."
+            " Allowed: (0 <= x < %d) (0 <= y < %d)",
+            trace_file_name, i + 1, width, height);
+            free(cell);
+            free(cell_x);
+            free(cell_y);
+            free(column_offsets);
+            free(column_records);
+            free(y_column);
+            free(y_cell);
+            return 1;
+        }
+        column_offsets[ trace->grid_x_pos[i] + 1 ]++;
+    }
+
+    int x, y;
+    for (x = 0; x < width; x++)
+    {
+        column_offsets[x + 1] += column_offsets[x];
+    }
+    for (i = 0; i < trace->size; i++)
+    {
+        column_records[ column_offsets[ trace->grid_x_pos[i] ]++ ] = i;
+    }
+    // Insert positions ended at the start of the next column;
+    for (x = width; x > 0; x--)
+    {
+        column_offsets[x] = column_offsets[x - 1];
+    }
+    column_offsets[0] = 0;
+
+    for (y = 0; y < height; y++)
+    {
+        y_column[y] = -1;
+    }
+
+    // From here on column_offsets[x] becomes the first dense cell of column x;
+    int num_cells = 0;
+    for (x = 0; x < width; x++)
+    {
+        int first_record = column_offsets[x];
+        int last_record = column_offsets[x + 1];
+        int first_cell = num_cells;
+
+        int k;
+        for (k = first_record; k < last_record; k++)
+        {
+            y = trace->grid_y_pos[ column_records[k] ];
+            if (y_column[y] != x)
+            {
+                y_column[y] = x;
+                cell_y[num_cells++] = y;
+            }
+        }
+
+        qsort(cell_y + first_cell, (size_t) (num_cells - first_cell), sizeof(int), compare_ints);
+
+        int c;
+        for (c = first_cell; c < num_cells; c++)
+        {
+            cell_x[c] = x;
+            y_cell[ cell_y[c] ] = c;
+        }
+
+        for (k = first_record; k < last_record; k++)
+        {
+            cell[ column_records[k] ] = y_cell[ trace->grid_y_pos[ column_records[k] ] ];
+        }
+
+        column_offsets[x] = first_cell;
+    }
+    column_offsets[width] = num_cells;
+
+    free(column_records);
+    free(y_column);
+    free(y_cell);
+
+    // Give back the space reserved for one cell per record;
+    int* shrunk_cell_x = (int*) realloc(cell_x, sizeof(int) * (size_t) num_cells);
+    int* shrunk_cell_y = (int*) realloc(cell_y, sizeof(int) * (size_t) num_cells);
+
+    trace->cell = cell;
+    grid->num_cells = num_cells;
+    grid->cell_x = shrunk_cell_x ? shrunk_cell_x : cell_x;
+    grid->cell_y = shrunk_cell_y ? shrunk_cell_y : cell_y;
+    grid->column_offsets = column_offsets;
+
+    return 0;
+}
+
+int read_trace(const char* trace_file_name, struct_trace* output_trace,
+struct_trace_read_stats* output_stats, char* output_error_msg)
+{
+    struct timespec begin_timer;
+    clock_gettime(CLOCK_MONOTONIC, &begin_timer);
+
+    int fd = open(trace_file_name, O_RDONLY);
+    if (fd < 0)
+    {
+        sprintf(output_error_msg, "can't open file \"%s\"", trace_file_name);
+        return 1;
+    }
+
+    struct stat file_info;
+    if (fstat(fd, &file_info) != 0)
+    {
+        sprintf(output_error_msg, "can't open file \"%s\"", trace_file_name);
+        close(fd);
+        return 1;
+    }
+
+    size_t file_size = (size_t) file_info.st_size;
+    if (file_size == 0)
+    {
+        sprintf(output_error_msg, "file \"%s\" is empty", trace_file_name);
+        close(fd);
+        return 1;
+    }
+
+    void* file_begin = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (file_begin == MAP_FAILED)
+    {
+        sprintf(output_error_msg, "can't map file \"%s\" into memory", trace_file_name);
+        return 1;
+    }
+
+    int is_binary_format = (file_size >= sizeof(TRACE_BIN_MAGIC) - 1) &&
+    (memcmp(file_begin, TRACE_BIN_MAGIC, sizeof(TRACE_BIN_MAGIC) - 1) == 0);
+
+    // Set before reading, so free_trace() works on a trace that fails half way;
+    output_trace->cell = NULL;
+    output_trace->grid.num_cells = 0;
+    output_trace->grid.cell_x = NULL;
+    output_trace->grid.cell_y = NULL;
+    output_trace->grid.column_offsets = NULL;
+
+    int status;
+    if (is_binary_format)
+    {
+        status = read_binary_trace(trace_file_name, file_begin, file_size, output_trace, output_error_msg);
+        if (status != 0)
+        {
+            munmap(file_begin, file_size);
+            return 1;
+        }
+    }
+    else
+    {
+        madvise(file_begin, file_size, MADV_SEQUENTIAL);
+        status = read_text_trace(trace_file_name, (const char*) file_begin, file_size,
+        output_trace, output_error_msg);
+        munmap(file_begin, file_size);
+        if (status != 0)
+        {
+            return 1;
+        }
+    }
+
+    status = build_trace_cells(trace_file_name, output_trace, output_error_msg);
+    if (status != 0)
+    {
+        free_trace(output_trace);
+        return 1;
+    }
+
+    struct timespec end_timer;
+    clock_gettime(CLOCK_MONOTONIC, &end_timer);
+    double read_time_in_secs = (double) (end_timer.tv_sec - begin_timer.tv_sec)
+    + (double) (end_timer.tv_nsec - begin_timer.tv_nsec) / 1e9;
+
+    output_stats->is_binary_format = is_binary_format;
+    output_stats->file_size_in_bytes = (long long) file_size;
+    output_stats->read_time_in_secs = read_time_in_secs;
+    output_stats->throughput_in_mb_per_sec = (read_time_in_secs > 0) ?
+    ((double) file_size / 1e6) / read_time_in_secs : 0;
+
+    return 0;
+}
+
+void free_trace(struct_trace* trace)
+{
+    if (trace->storage != NULL)
+    {
+        if (trace->storage_is_mapped)
+        {
+            munmap(trace->storage, trace->storage_size);
+        }
+        else
+        {
+            free(trace->storage);
+        }
+    }
+
+    free(trace->cell);
+    free_cell_grid(&(trace->grid));
+
+    trace->storage = NULL;
+    trace->cell = NULL;
+    trace->size = 0;
+    trace->num_vehicles = 0;
+}
+
+// Moves the records of the chunk into a new block with room for capacity records;
+// If succeedes, returns 0, otherwise returns 1 and the chunk is unchanged;
+static int resize_chunk_storage(struct_trace* chunk, int capacity)
+{
+    size_t storage_size = sizeof(int) * ((size_t) 6 * capacity + 1);
+    int* storage = (int*) malloc(storage_size);
+    if (storage == NULL)
+    {
+        return 1;
+    }
+
+    struct_trace resized_chunk = *chunk;
+    set_trace_columns(&resized_chunk, storage, capacity);
+    if (chunk->storage != NULL)
+    {
+        size_t column_size = sizeof(int) * (size_t) chunk->size;
+        memcpy(resized_chunk.vehicle_id, chunk->vehicle_id, column_size);
+        memcpy(resized_chunk.time, chunk->time, column_size);
+        memcpy(resized_chunk.grid_x_pos, chunk->grid_x_pos, column_size);
+        memcpy(resized_chunk.grid_y_pos, chunk->grid_y_pos, column_size);
+        memcpy(resized_chunk.r, chunk->r, column_size);
+        memcpy(resized_chunk.vehicle_offsets, chunk->vehicle_offsets,
+        sizeof(int) * ((size_t) chunk->num_vehicles + 1));
+        free(chunk->storage);
+    }
+
+    resized_chunk.storage = storage;
+    resized_chunk.storage_size = storage_size;
+    resized_chunk.storage_is_mapped = 0;
+    *chunk = resized_chunk;
+
+    return 0;
+}
+
+// Reads size bytes at offset, retrying short reads;
+// Returns 0 if all were read, 1 otherwise;
+static int read_file_range(int fd, void* output_bytes, size_t size, off_t offset)
+{
+    char* p = (char*) output_bytes;
+    while (size > 0)
+    {
+        ssize_t num_read_bytes = pread(fd, p, size, offset);
+        if (num_read_bytes <= 0)
+        {
+            return 1;
+        }
+
+        p += num_read_bytes;
+        size -= (size_t) num_read_bytes;
+        offset += num_read_bytes;
+    }
+
+    return 0;
+}
+
+static int chunk_reader_is_at_end(struct_trace_chunk_reader* reader)
+{
+    if (reader->is_binary_format)
+    {
+        return reader->next_record == reader->header.num_records;
+    }
+
+    return reader->is_at_end_of_file && reader->text_begin == reader->text_end;
+}
+
+// Appends records of a binary trace until the chunk is full or the file ends;
+// Returns 0 if succeedes, 1 otherwise (and error_msg can be used);
+static int fill_binary_chunk(struct_trace_chunk_reader* reader, char* output_error_msg)
+{
+    struct_trace* chunk = &(reader->chunk);
+    int num_records = reader->chunk_capacity - chunk->size;
+    if (num_records > reader->header.num_records - reader->next_record)
+    {
+        num_records = reader->header.num_records - reader->next_record;
+    }
+
+    int* columns[5] = { chunk->vehicle_id, chunk->time, chunk->grid_x_pos, chunk->grid_y_pos, chunk->r };
+    int column;
+    for (column = 0; column < 5; column++)
+    {
+        off_t offset = (off_t) (sizeof(struct_trace_bin_header) +
+        sizeof(int) * ((size_t) column * reader->header.num_records + reader->next_record));
+        if (read_file_range(reader->fd, columns[column] + chunk->size, sizeof(int) * (size_t) num_records, offset) != 0)
+        {
+            sprintf(output_error_msg, "can't read file \"%s\"", reader->trace_file_name);
+            return 1;
+        }
+    }
+
+    // Vehicles are cut at each change of id, as the text loader did when the file was written;
+    int i;
+    for (i = chunk->size; i < chunk->size + num_records; i++)
+    {
+        if (chunk->vehicle_id[i] != reader->last_seen_vehicle_id)
+        {
+            chunk->vehicle_offsets[chunk->num_vehicles] = i;
+            chunk->num_vehicles++;
+            reader->last_seen_vehicle_id = chunk->vehicle_id[i];
+        }
+    }
+
+    chunk->size += num_records;
+    reader->next_record += num_records;
+
+    return 0;
+}
+
+// Parses lines of a text trace until the chunk is full or the file ends;
+// Only whole lines are parsed, so every line ends with '\n' as the parser needs;
+// Returns 0 if succeedes, 1 otherwise (and error_msg can be used);
+static int fill_text_chunk(struct_trace_chunk_reader* reader, char* output_error_msg)
+{
+    struct_trace* chunk = &(reader->chunk);
+    char* buffer = reader->text_buffer;
+    int aux[NUM_FIELDS];
+
+    while (chunk->size < reader->chunk_capacity)
+    {
+        char* line_begin = buffer + reader->text_begin;
+        char* line_break = (char*) memchr(line_begin, '\n', reader->text_end - reader->text_begin);
+        if (line_break == NULL)
+        {
+            if (reader->is_at_end_of_file)
+            {
+                if (reader->text_begin == reader->text_end)
+                {
+                    return 0;
+                }
+
+                // A last line without line break gets one, the buffer has a byte to spare for it;
+                buffer[reader->text_end++] = '\n';
+                continue;
+            }
+
+            // Only part of a line is left: move it to the front and read what follows;
+            size_t line_size = reader->text_end - reader->text_begin;
+            if (line_size == TRACE_CHUNK_TEXT_BUFFER_SIZE)
+            {
+                sprintf(output_error_msg, "file \"%s\" contains a line longer than %d bytes in line %d",
+                reader->trace_file_name, TRACE_CHUNK_TEXT_BUFFER_SIZE, reader->num_file_lines + 1);
+                return 1;
+            }
+
+            memmove(buffer, line_begin, line_size);
+            reader->text_begin = 0;
+            reader->text_end = line_size;
+
+            ssize_t num_read_bytes = read(reader->fd, buffer + line_size, TRACE_CHUNK_TEXT_BUFFER_SIZE - line_size);
+            if (num_read_bytes < 0)
+            {
+                sprintf(output_error_msg, "can't read file \"%s\"", reader->trace_file_name);
+                return 1;
+            }
+
+            reader->is_at_end_of_file = (num_read_bytes == 0);
+            reader->text_end += (size_t) num_read_bytes;
+            continue;
+        }
+
+        reader->num_file_lines++;
+        reader->text_begin = (size_t) (line_break + 1 - buffer);
+        if (*line_begin == '\n' || *line_begin == '\r')
+        {
+            continue;
+        }
+
+        if (parse_trace_line(line_begin, aux) == NULL)
+        {
+            sprintf(output_error_msg, "file \"%s\" contains a malformed line %d"
+            " (expected \"vehicle;time;x;y;r;\")", reader->trace_file_name, reader->num_file_lines);
+            return 1;
+        }
+
+        if (store_trace_line(reader->trace_file_name, aux, reader->num_file_lines, chunk,
+        &(reader->last_seen_vehicle_id), output_error_msg) != 0)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int open_trace_chunk_reader(const char* trace_file_name, int max_chunk_records,
+struct_trace_chunk_reader* output_reader, char* output_error_msg)
+{
+    memset(output_reader, 0, sizeof(*output_reader));
+    output_reader->trace_file_name = trace_file_name;
+    output_reader->max_chunk_records = max_chunk_records;
+    output_reader->chunk_capacity = max_chunk_records;
+    output_reader->last_seen_vehicle_id = -1;
+
+    output_reader->fd = open(trace_file_name, O_RDONLY);
+    if (output_reader->fd < 0)
+    {
+        sprintf(output_error_msg, "can't open file \"%s\"", trace_file_name);
+        return 1;
+    }
+
+    struct stat file_info;
+    if (fstat(output_reader->fd, &file_info) != 0)
+    {
+        sprintf(output_error_msg, "can't open file \"%s\"", trace_file_name);
+        close_trace_chunk_reader(output_reader);
+        return 1;
+    }
+
+    output_reader->file_size_in_bytes = (long long) file_info.st_size;
+    if (output_reader->file_size_in_bytes == 0)
+    {
+        sprintf(output_error_msg, "file \"%s\" is empty", trace_file_name);
+        close_trace_chunk_reader(output_reader);
+        return 1;
+    }
+
+    struct_trace_bin_header* header = &(output_reader->header);
+    ssize_t num_header_bytes = pread(output_reader->fd, header, sizeof(*header), 0);
+    output_reader->is_binary_format = (num_header_bytes >= (ssize_t) sizeof(TRACE_BIN_MAGIC) - 1) &&
+    (memcmp(header->magic, TRACE_BIN_MAGIC, sizeof(TRACE_BIN_MAGIC) - 1) == 0);
+
+    if (output_reader->is_binary_format)
+    {
+        if (num_header_bytes < (ssize_t) sizeof(*header))
+        {
+            sprintf(output_error_msg, "binary file \"%s\" is truncated", trace_file_name);
+            close_trace_chunk_reader(output_reader);
+            return 1;
+        }
+
+        if (validate_binary_header(trace_file_name, *header, (size_t) file_info.st_size, output_error_msg) != 0)
+        {
+            close_trace_chunk_reader(output_reader);
+            return 1;
+        }
+
+        output_reader->chunk.grid.width = header->grid_width;
+        output_reader->chunk.grid.height = header->grid_height;
+    }
+    else
+    {
+        posix_fadvise(output_reader->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        output_reader->text_buffer = (char*) malloc(TRACE_CHUNK_TEXT_BUFFER_SIZE + 1);
+    }
+
+    if ((!output_reader->is_binary_format && output_reader->text_buffer == NULL)
+    || resize_chunk_storage(&(output_reader->chunk), max_chunk_records) != 0)
+    {
+        sprintf(output_error_msg, "can't allocate memory for %d trace lines", max_chunk_records);
+        close_trace_chunk_reader(output_reader);
+        return 1;
+    }
+
+    return 0;
+}
+
+int read_trace_chunk(struct_trace_chunk_reader* reader, int* output_has_chunk, char* output_error_msg)
+{
+    struct_trace* chunk = &(reader->chunk);
+
+    // Cells of the previous chunk go, its held records become the first vehicle of this one;
+    free(chunk->cell);
+    chunk->cell = NULL;
+    free_cell_grid(&(chunk->grid));
+
+    int num_held_records = reader->held_end - reader->held_begin;
+    if (num_held_records > 0)
+    {
+        size_t column_size = sizeof(int) * (size_t) num_held_records;
+        memmove(chunk->vehicle_id, chunk->vehicle_id + reader->held_begin, column_size);
+        memmove(chunk->time, chunk->time + reader->held_begin, column_size);
+        memmove(chunk->grid_x_pos, chunk->grid_x_pos + reader->held_begin, column_size);
+        memmove(chunk->grid_y_pos, chunk->grid_y_pos + reader->held_begin, column_size);
+        memmove(chunk->r, chunk->r + reader->held_begin, column_size);
+    }
+    chunk->size = num_held_records;
+    chunk->num_vehicles = (num_held_records > 0);
+    chunk->vehicle_offsets[0] = 0;
+    reader->held_begin = 0;
+    reader->held_end = 0;
+
+    for (;;)
+    {
+        int status = reader->is_binary_format ?
+        fill_binary_chunk(reader, output_error_msg) : fill_text_chunk(reader, output_error_msg);
+        if (status != 0)
+        {
+            return 1;
+        }
+
+        if (chunk_reader_is_at_end(reader) || chunk->num_vehicles > 1)
+        {
+            break;
+        }
+
+        // A vehicle alone fills the chunk, which grows until the vehicle fits;
+        if (reader->chunk_capacity > INT_MAX / 6 / 2 || resize_chunk_storage(chunk, 2 * reader->chunk_capacity) != 0)
+        {
+            sprintf(output_error_msg, "can't allocate memory for the %d or more trace lines of a vehicle",
+            chunk->size);
+            return 1;
+        }
+        reader->chunk_capacity *= 2;
+    }
+
+    // The chunk is full, and its last vehicle may go on in the file;
+    if (!chunk_reader_is_at_end(reader))
+    {
+        chunk->num_vehicles--;
+        reader->held_begin = chunk->vehicle_offsets[chunk->num_vehicles];
+        reader->held_end = chunk->size;
+        chunk->size = reader->held_begin;
+    }
+
+    if (chunk->size == 0)
+    {
+        if (reader->num_records == 0)
+        {
+            sprintf(output_error_msg, "file \"%s\" is empty", reader->trace_file_name);
+            return 1;
+        }
+
+        *output_has_chunk = 0;
+        return 0;
+    }
+
+    chunk->vehicle_offsets[chunk->num_vehicles] = chunk->size;
+    if (build_trace_cells(reader->trace_file_name, chunk, output_error_msg) != 0)
+    {
+        return 1;
+    }
+
+    reader->num_records += chunk->size;
+    reader->num_vehicles += chunk->num_vehicles;
+    *output_has_chunk = 1;
+
+    return 0;
+}
+
+void close_trace_chunk_reader(struct_trace_chunk_reader* reader)
+{
+    if (reader->fd >= 0)
+    {
+        close(reader->fd);
+    }
+    free(reader->text_buffer);
+    free_trace(&(reader->chunk));
+
+    reader->fd = -1;
+    reader->text_buffer = NULL;
+}
+
+double get_peak_rss_in_mb(void)
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+
+    // ru_maxrss is in kilobytes;
+    return (double) usage.ru_maxrss * 1024 / 1e6;
+}
+
+int get_cell_id(const struct_cell_grid* grid, int x, int y)
+{
+    if ((unsigned int) x >= (unsigned int) grid->width)
+    {
+        return -1;
+    }
+
+    // Binary search of y among the cells of column x;
+    int low = grid->column_offsets[x];
+    int high = grid->column_offsets[x + 1];
+    while (low < high)
+    {
+        int middle = low + (high - low) / 2;
+        if (grid->cell_y[middle] < y)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return (low < grid->column_offsets[x + 1] && grid->cell_y[low] == y) ? low : -1;
+}
+
+int copy_cell_grid(const struct_cell_grid* grid, struct_cell_grid* output_grid, char* output_error_msg)
+{
+    *output_grid = *grid;
+    output_grid->cell_x = (int*) malloc(sizeof(int) * (size_t) (grid->num_cells > 0 ? grid->num_cells : 1));
+    output_grid->cell_y = (int*) malloc(sizeof(int) * (size_t) (grid->num_cells > 0 ? grid->num_cells : 1));
+    output_grid->column_offsets = (int*) malloc(sizeof(int) * ((size_t) grid->width + 1));
+    if (!output_grid->cell_x || !output_grid->cell_y || !output_grid->column_offsets)
+    {
+        sprintf(output_error_msg, "can't allocate memory for the %d cells of the grid", grid->num_cells);
+        free_cell_grid(output_grid);
+        return 1;
+    }
+
+    memcpy(output_grid->cell_x, grid->cell_x, sizeof(int) * (size_t) grid->num_cells);
+    memcpy(output_grid->cell_y, grid->cell_y, sizeof(int) * (size_t) grid->num_cells);
+    memcpy(output_grid->column_offsets, grid->column_offsets, sizeof(int) * ((size_t) grid->width + 1));
+
+    return 0;
+}
+
+void free_cell_grid(struct_cell_grid* grid)
+{
+    free(grid->cell_x);
+    free(grid->cell_y);
+    free(grid->column_offsets);
+
+    grid->cell_x = NULL;
+    grid->cell_y = NULL;
+    grid->column_offsets = NULL;
+    grid->num_cells = 0;
+}
+
+int write_binary_trace(const char* binary_trace_file_name, struct_trace* trace,
+char* output_error_msg)
+{
+    struct_trace_bin_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TRACE_BIN_MAGIC, sizeof(header.magic));
+    header.version = TRACE_BIN_VERSION;
+    header.byte_order_mark = 0x01020304;
+    header.num_records = trace->size;
+    header.num_vehicles = trace->num_vehicles;
+    header.grid_width = trace->grid.width;
+    header.grid_height = trace->grid.height;
+
+    FILE* output_file = fopen(binary_trace_file_name, "wb");
+    if (output_file == NULL)
+    {
+        sprintf(output_error_msg, "can't open file \"%s\"", binary_trace_file_name);
+        return 1;
+    }
+
+    size_t n = (size_t) trace->size;
+    int written =
+        fwrite(&header, sizeof(header), 1, output_file) == 1 &&
+        fwrite(trace->vehicle_id, sizeof(int), n, output_file) == n &&
+        fwrite(trace->time, sizeof(int), n, output_file) == n &&
+        fwrite(trace->grid_x_pos, sizeof(int), n, output_file) == n &&
+        fwrite(trace->grid_y_pos, sizeof(int), n, output_file) == n &&
+        fwrite(trace->r, sizeof(int), n, output_file) == n &&
+        fwrite(trace->vehicle_offsets, sizeof(int), (size_t) trace->num_vehicles + 1, output_file)
+        == (size_t) trace->num_vehicles + 1;
+
+    if (fclose(output_file) != 0 || !written)
+    {
+        sprintf(output_error_msg, "can't write file \"%s\"", binary_trace_file_name);
+        return 1;
+    }
+
+    return 0;
+}
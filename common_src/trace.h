@@ -0,0 +1,193 @@
+#ifndef COMMON_TRACE_H
+#define COMMON_TRACE_H
+
+#include <stddef.h>
+
+// Grid dimensions are read at runtime (see struct_cell_grid), this only bounds each coordinate;
+#define MAX_CELL_GRID_SIDE          1048576
+
+// Bytes of the text read at a time by the chunk reader, a line can't be longer;
+#define TRACE_CHUNK_TEXT_BUFFER_SIZE    (4 << 20)
+
+// Binary trace files (see write_binary_trace()) start with these bytes;
+#define TRACE_BIN_MAGIC             "VTCTRACE"
+#define TRACE_BIN_VERSION           1
+
+// Frequented cells of a trace, i.e. the cells with at least one record, numbered 0..num_cells - 1
+// in row-major order (by x, then y), so comparing dense cells compares their (x, y) as the grid scans did;
+// Memory is proportional to the frequented cells and the grid sides, not to the grid area;
+typedef struct cell_grid_
+{
+    // Biggest coordinates plus one (text trace) or the dimensions of the binary header;
+    int width;
+    int height;
+    int num_cells;
+
+    // Coordinates of each dense cell;
+    int *cell_x;
+    int *cell_y;
+    // Dense cells of column x are [column_offsets[x], column_offsets[x + 1]), by increasing y;
+    int *column_offsets;
+
+} struct_cell_grid;
+
+// Trace stored as columns (struct of arrays), record i is
+// (vehicle_id[i], time[i], grid_x_pos[i], grid_y_pos[i], r[i]);
+// IMPORTANT: columns are read only, they may point into a read only file mapping;
+typedef struct trace_
+{
+    int size;
+    int num_vehicles;
+
+    int *vehicle_id;
+    int *time;
+    int *grid_x_pos;
+    int *grid_y_pos;
+    int *r;
+
+    // Records of the v-th vehicle (in file order) are [vehicle_offsets[v], vehicle_offsets[v + 1]);
+    // Vehicles are numbered densely 0..num_vehicles - 1 this way whatever their ids,
+    // and every per-vehicle array is indexed by this number;
+    int *vehicle_offsets;
+
+    // Dense cell of each record, always on the heap;
+    int *cell;
+    struct_cell_grid grid;
+
+    // Memory backing the columns: a heap block (text trace) or a file mapping (binary trace);
+    void *storage;
+    size_t storage_size;
+    int storage_is_mapped;
+
+} struct_trace;
+
+// Header of a binary trace file, followed by the int columns vehicle_id, time,
+// grid_x_pos, grid_y_pos, r (num_records entries each) and vehicle_offsets (num_vehicles + 1 entries);
+typedef struct trace_bin_header_
+{
+    char magic[8];
+    unsigned int version;
+    // 0x01020304 written in the byte order of the machine that wrote the file;
+    unsigned int byte_order_mark;
+    int num_records;
+    int num_vehicles;
+    int grid_width;
+    int grid_height;
+    int reserved[8];
+
+} struct_trace_bin_header;
+
+typedef struct trace_read_stats_
+{
+    int is_binary_format;
+    long long file_size_in_bytes;
+    double read_time_in_secs;
+    double throughput_in_mb_per_sec;
+
+} struct_trace_read_stats;
+
+// Reads a trace a few whole vehicles at a time, for traces that don't fit in memory;
+// Relies on the records of each vehicle being adjacent, as read_trace() does;
+typedef struct trace_chunk_reader_
+{
+    const char *trace_file_name;
+    int fd;
+    int is_binary_format;
+    long long file_size_in_bytes;
+    int max_chunk_records;
+    // Records the chunk has room for, bigger than max_chunk_records if a vehicle needed it;
+    int chunk_capacity;
+
+    // Records of the last chunk read, with their own dense cells (see read_trace_chunk());
+    // The grid width and height are those of the whole file once the last chunk is read;
+    struct_trace chunk;
+    // Records kept after the chunk: the last vehicle of a full chunk may go on in the file;
+    int held_begin;
+    int held_end;
+    int last_seen_vehicle_id;
+
+    // Records and vehicles of all the chunks read;
+    long long num_records;
+    int num_vehicles;
+
+    // Binary trace: header and next record to read;
+    struct_trace_bin_header header;
+    int next_record;
+
+    // Text trace: unparsed bytes are text_buffer[text_begin, text_end);
+    char *text_buffer;
+    size_t text_begin;
+    size_t text_end;
+    int is_at_end_of_file;
+    int num_file_lines;
+
+} struct_trace_chunk_reader;
+
+// ==================== INPUT FUNCTIONS ==================== //
+// Shared by n-deployment, greedy and baseline;
+// Detects the format (text or binary) from the first bytes of the file;
+// If succeedes, returns 0, output_trace and output_stats can be used and
+// output_trace must be released with free_trace();
+// Otherwise, returns 1 and error_msg can be used;
+int read_trace(
+    const char* trace_file_name,
+    struct_trace *output_trace,
+    struct_trace_read_stats *output_stats,
+    char* output_error_msg
+);
+
+void free_trace(struct_trace *trace);
+
+// Chunks hold max_chunk_records records at most, unless a vehicle alone has more;
+// If succeedes, returns 0 and output_reader can be used (release it with close_trace_chunk_reader());
+// Otherwise, returns 1 and error_msg can be used;
+int open_trace_chunk_reader(
+    const char* trace_file_name,
+    int max_chunk_records,
+    struct_trace_chunk_reader *output_reader,
+    char* output_error_msg
+);
+
+// Replaces reader->chunk with the next vehicles of the file, cut so no vehicle is split between chunks;
+// The chunk is valid until the next call, its vehicles and cells are numbered from 0;
+// If succeedes, returns 0 and output_has_chunk is 0 once the whole file was read;
+// Otherwise, returns 1 and error_msg can be used;
+int read_trace_chunk(
+    struct_trace_chunk_reader *reader,
+    int *output_has_chunk,
+    char* output_error_msg
+);
+
+void close_trace_chunk_reader(struct_trace_chunk_reader *reader);
+
+// Peak resident set size of the process so far, in MB;
+double get_peak_rss_in_mb(void);
+// ==================== INPUT FUNCTIONS ==================== //
+
+// ==================== CELL GRID FUNCTIONS ==================== //
+// Dense cell of (x, y), or -1 if no record is in that cell;
+int get_cell_id(const struct_cell_grid *grid, int x, int y);
+
+// Copy that outlives the trace;
+// If succeedes, returns 0 and output_grid can be used (release it with free_cell_grid());
+// Otherwise, returns 1 and error_msg can be used;
+int copy_cell_grid(
+    const struct_cell_grid *grid,
+    struct_cell_grid *output_grid,
+    char* output_error_msg
+);
+
+void free_cell_grid(struct_cell_grid *grid);
+// ==================== CELL GRID FUNCTIONS ==================== //
+
+// ==================== OUTPUT FUNCTIONS ==================== //
+// If succeedes, returns 0;
+// Otherwise, returns 1 and error_msg can be used;
+int write_binary_trace(
+    const char* binary_trace_file_name,
+    struct_trace *trace,
+    char* output_error_msg
+);
+// ==================== OUTPUT FUNCTIONS ==================== //
+
+#endif
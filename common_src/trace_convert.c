@@ -0,0 +1,52 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "trace.h"
+
+int main(int argc, char **argv)
+{
+    // In case any specified error below occurs;
+    int status;
+    char error_msg[300];
+    error_msg[0] = '\0';
+
+    const char* correct_input_format = "USAGE: trace-convert <text trace file path> <binary trace file path>";
+
+    if (argc != 3)
+    {
+        fprintf(stderr, "TRACE-CONVERT: COMMAND LINE ERROR: wrong number of arguments\n\n%s\n",
+        correct_input_format);
+        return 1;
+    }
+
+    // ==================== 1 - READ TEXT TRACE ==================== //
+
+    struct_trace trace;
+    struct_trace_read_stats trace_read_stats;
+    status = read_trace(argv[1], &trace, &trace_read_stats, error_msg);
+    if (status != 0)
+    {
+        fprintf(stderr, "TRACE-CONVERT: INPUT TRACE FILE ERROR: %s\n", error_msg);
+        return 1;
+    }
+
+    printf("TRACE-CONVERT: TRACE FILE: %d lines, %d vehicles, %.1f MB %s read in %.3f s (%.1f MB/s)\n",
+    trace.size, trace.num_vehicles, trace_read_stats.file_size_in_bytes / 1e6,
+    trace_read_stats.is_binary_format ? "binary" : "text",
+    trace_read_stats.read_time_in_secs, trace_read_stats.throughput_in_mb_per_sec);
+
+    // ==================== 2 - WRITE BINARY TRACE ================= //
+
+    status = write_binary_trace(argv[2], &trace, error_msg);
+    if (status != 0)
+    {
+        fprintf(stderr, "TRACE-CONVERT: OUTPUT FILE ERROR: %s\n", error_msg);
+        free_trace(&trace);
+        return 1;
+    }
+
+    free_trace(&trace);
+
+    return 0;
+}
@@ -0,0 +1,660 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <limits.h>
+
+#include "trace.h"
+#include "rng.h"
+
+// <num of vehicles> <grid width> <grid height> <seed> <output trace file path>;
+#define NUM_POSITIONAL_ARGS         5
+
+#define MAX_OUTPUT_FILE_PATH_SIZE   1000
+
+#define MAX_NUM_HOTSPOTS            100000
+
+// Bytes formatted before each fwrite(), a record line takes at most 5 ints and 5 separators;
+#define OUTPUT_BUFFER_SIZE          (4 << 20)
+#define MAX_RECORD_LINE_SIZE        64
+
+// Geometric trips are cut at this many times the mean length;
+#define MAX_TRIP_LENGTH_FACTOR      20
+
+// Philox stream of the hotspots, vehicles use streams 0..num_vehicles - 1;
+#define HOTSPOTS_RNG_STREAM         0xFFFFFFFFu
+
+// Blocks of a vehicle: its trip (length, start) then one block per record;
+#define TRIP_RNG_BLOCK              1
+#define STEP_RNG_BLOCK              2
+
+typedef enum trip_distribution_
+{
+    // Every trip has the mean length;
+    TRIP_DISTRIBUTION_FIXED,
+    // Uniform in [1, 2 * mean - 1];
+    TRIP_DISTRIBUTION_UNIFORM,
+    // Geometric with that mean, many short trips and a few long ones, as in the datasets;
+    TRIP_DISTRIBUTION_GEOMETRIC
+
+} enum_trip_distribution;
+
+typedef struct trace_generate_input_
+{
+    int num_vehicles;
+    int grid_width;
+    int grid_height;
+    int seed;
+
+    // Records per trip;
+    int mean_trip_length;
+    enum_trip_distribution trip_distribution;
+
+    // Trips start near one of these cells with probability hotspot_share (percent),
+    // hotspot h being picked with weight 1 / (h + 1)^skew, anywhere on the grid otherwise;
+    int num_hotspots;
+    int hotspot_share;
+    double skew;
+
+    // Records last 10 * r seconds, r uniform in [1, max_r];
+    int max_r;
+
+    // First records are uniform in [start_time, start_time + time_window);
+    int start_time;
+    int time_window;
+
+} struct_trace_generate_input;
+
+typedef struct hotspots_
+{
+    int num_hotspots;
+    int *x;
+    int *y;
+    // Cumulative weights, the last one is 1;
+    double *cumulative_weights;
+    // Trips starting at a hotspot start this far from its center at most, on each axis;
+    int radius;
+
+} struct_hotspots;
+
+// ==================== INPUT FUNCTIONS ==================== //
+// If succeedes, returns 0 and output_input can be used;
+// Otherwise, returns 1 and error_msg can be used;
+int read_commandline_args(
+    int argc, char **argv,
+    struct_trace_generate_input *output_input,
+    char* output_file_path, char* output_error_msg
+);
+
+// Options are "--name value" pairs accepted anywhere among the positional arguments;
+// If succeedes, returns 0 and the option's value is stored in output_input;
+// Otherwise, returns 1 and error_msg can be used;
+int read_commandline_option(
+    char* name, char* value,
+    struct_trace_generate_input *output_input,
+    char* output_error_msg
+);
+
+int try_to_get_positive_int_from_arg(
+    char* arg, char* var_name,
+    int* output,
+    char* output_error_msg
+);
+
+int try_to_get_non_negative_int_from_arg(
+    char* arg, char* var_name,
+    int* output,
+    char* output_error_msg
+);
+// ==================== INPUT FUNCTIONS ==================== //
+
+
+// ==================== GENERATE FUNCTIONS ==================== //
+// If succeedes, returns 0 and output_hotspots can be used (release it with free_hotspots());
+// Otherwise, returns 1 and error_msg can be used;
+int init_hotspots(
+    struct_trace_generate_input *input,
+    struct_hotspots *output_hotspots,
+    char* output_error_msg
+);
+
+void free_hotspots(struct_hotspots *hotspots);
+
+// Writes the records of every vehicle, one trip each, in vehicle order;
+// If succeedes, returns 0 and output_num_records can be used;
+// Otherwise, returns 1 and error_msg can be used;
+int write_generated_trace(
+    FILE* output_file,
+    struct_trace_generate_input *input,
+    struct_hotspots *hotspots,
+    long long *output_num_records,
+    char* output_error_msg
+);
+
+// Four random words for block of vehicle (stream) and index;
+void draw_random_block(int seed, uint32_t stream, uint32_t index, uint32_t block, uint32_t output[4]);
+
+// Uniform in [0, bound) from a random word;
+int get_bounded_int(uint32_t word, int bound);
+
+// Uniform in (0, 1) from a random word;
+double get_unit_double(uint32_t word);
+
+// Writes value (>= 0) in decimal at p, returns the end of the digits;
+char* write_int(char* p, int value);
+// ==================== GENERATE FUNCTIONS ==================== //
+
+
+int main(int argc, char **argv)
+{
+    // In case any specified error below occurs;
+    int status;
+    char error_msg[MAX_OUTPUT_FILE_PATH_SIZE + 300];
+    error_msg[0] = '\0';
+
+    // ==================== 1 - READ INPUT ==================== //
+
+    const char* correct_input_format = "USAGE: trace-generate <num of vehicles> <grid width> <grid height> <seed> "
+    "<output trace file path> [--trip-length <mean records per trip>] [--trip-distribution fixed|uniform|geometric] "
+    "[--hotspots <num of hotspots>] [--hotspot-share <percent of trips>] [--skew <hotspots zipf exponent>] "
+    "[--max-r <max r>] [--start-time <s>] [--time-window <s>]";
+
+    char output_file_path[MAX_OUTPUT_FILE_PATH_SIZE + 1];
+    output_file_path[0] = '\0';
+    struct_trace_generate_input input;
+    status = read_commandline_args(argc, argv, &input, output_file_path, error_msg);
+    if (status != 0)
+    {
+        fprintf(stderr, "TRACE-GENERATE: COMMAND LINE ERROR: %s\n\n%s\n", error_msg, correct_input_format);
+        return 1;
+    }
+
+    struct_hotspots hotspots;
+    status = init_hotspots(&input, &hotspots, error_msg);
+    if (status != 0)
+    {
+        fprintf(stderr, "TRACE-GENERATE: MEMORY ERROR: %s\n", error_msg);
+        return 1;
+    }
+
+    // ==================== 2 - WRITE TRACE ==================== //
+
+    FILE* output_file = fopen(output_file_path, "w");
+    if (output_file == NULL)
+    {
+        fprintf(stderr, "TRACE-GENERATE: OUTPUT FILE ERROR: can't open file \"%s\"\n", output_file_path);
+        free_hotspots(&hotspots);
+        return 1;
+    }
+
+    struct timespec begin_timer;
+    clock_gettime(CLOCK_MONOTONIC, &begin_timer);
+
+    long long num_records = 0;
+    status = write_generated_trace(output_file, &input, &hotspots, &num_records, error_msg);
+    if (fclose(output_file) != 0 && status == 0)
+    {
+        sprintf(error_msg, "can't write file \"%s\"", output_file_path);
+        status = 1;
+    }
+    free_hotspots(&hotspots);
+    if (status != 0)
+    {
+        fprintf(stderr, "TRACE-GENERATE: OUTPUT FILE ERROR: %s\n", error_msg);
+        return 1;
+    }
+
+    struct timespec end_timer;
+    clock_gettime(CLOCK_MONOTONIC, &end_timer);
+    double write_time = (end_timer.tv_sec - begin_timer.tv_sec) + (end_timer.tv_nsec - begin_timer.tv_nsec) / 1e9;
+
+    printf("TRACE-GENERATE: TRACE FILE: %lld lines, %d vehicles written in %.3f s (%.1f M lines/s)\n",
+    num_records, input.num_vehicles, write_time, num_records / 1e6 / write_time);
+
+    // read_trace() numbers records with int, --stream doesn't;
+    if (num_records > INT_MAX)
+    {
+        printf("TRACE-GENERATE: more than %d lines, the solvers can only read this trace with --stream\n", INT_MAX);
+    }
+
+    return 0;
+}
+
+int read_commandline_args(int argc, char **argv, struct_trace_generate_input *output_input,
+char* output_file_path, char* output_error_msg)
+{
+    int status;
+
+    // ========== Defaults, close to 6_to_8am.csv; ========== //
+    output_input->mean_trip_length = 30;
+    output_input->trip_distribution = TRIP_DISTRIBUTION_GEOMETRIC;
+    output_input->num_hotspots = 10;
+    output_input->hotspot_share = 80;
+    output_input->skew = 1.0;
+    output_input->max_r = 4;
+    output_input->start_time = 21600;
+    output_input->time_window = 7200;
+
+    // argv-like: program name, then the positional arguments in order;
+    char* positional_args[NUM_POSITIONAL_ARGS + 1];
+    positional_args[0] = argv[0];
+    int num_positional_args = 0;
+    int i;
+    for (i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--", 2) == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                sprintf(output_error_msg, "option %s needs a value", argv[i]);
+                return 1;
+            }
+
+            status = read_commandline_option(argv[i], argv[i + 1], output_input, output_error_msg);
+            if (status != 0)
+            {
+                return 1;
+            }
+            i++;
+        }
+        else if (num_positional_args < NUM_POSITIONAL_ARGS)
+        {
+            positional_args[++num_positional_args] = argv[i];
+        }
+        else
+        {
+            strcpy(output_error_msg, "wrong number of arguments");
+            return 1;
+        }
+    }
+
+    if (num_positional_args != NUM_POSITIONAL_ARGS)
+    {
+        strcpy(output_error_msg, "wrong number of arguments");
+        return 1;
+    }
+    argv = positional_args;
+
+    // ========== Try to convert all arguments to correct numeric values; ========== //
+
+    status = try_to_get_positive_int_from_arg(argv[1], "<num of vehicles>",
+    &(output_input->num_vehicles), output_error_msg);
+    if (status != 0)
+    {
+        return 1;
+    }
+    status = try_to_get_positive_int_from_arg(argv[2], "<grid width>",
+    &(output_input->grid_width), output_error_msg);
+    if (status != 0)
+    {
+        return 1;
+    }
+    status = try_to_get_positive_int_from_arg(argv[3], "<grid height>",
+    &(output_input->grid_height), output_error_msg);
+    if (status != 0)
+    {
+        return 1;
+    }
+    if (output_input->grid_width > MAX_CELL_GRID_SIDE || output_input->grid_height > MAX_CELL_GRID_SIDE)
+    {
+        sprintf(output_error_msg, "grid sides must be at most %d", MAX_CELL_GRID_SIDE);
+        return 1;
+    }
+    status = try_to_get_non_negative_int_from_arg(argv[4], "<seed>",
+    &(output_input->seed), output_error_msg);
+    if (status != 0)
+    {
+        return 1;
+    }
+
+    // The last record of the longest trip must still have an int time;
+    long long max_trip_length = (long long) MAX_TRIP_LENGTH_FACTOR * output_input->mean_trip_length;
+    if ((long long) output_input->start_time + output_input->time_window + max_trip_length * 10 * output_input->max_r > INT_MAX)
+    {
+        strcpy(output_error_msg, "--start-time, --time-window, --trip-length and --max-r give times bigger than an int");
+        return 1;
+    }
+
+    // ========== try to get output file path ========== //
+    if (strlen(argv[5]) > MAX_OUTPUT_FILE_PATH_SIZE)
+    {
+        sprintf(output_error_msg, "file path is bigger than %d bytes", MAX_OUTPUT_FILE_PATH_SIZE);
+        return 1;
+    }
+    strcpy(output_file_path, argv[5]);
+
+    return 0;
+}
+
+int read_commandline_option(char* name, char* value,
+struct_trace_generate_input *output_input, char* output_error_msg)
+{
+    if (strcmp(name, "--trip-length") == 0)
+    {
+        return try_to_get_positive_int_from_arg(value, "--trip-length",
+        &(output_input->mean_trip_length), output_error_msg);
+    }
+
+    if (strcmp(name, "--trip-distribution") == 0)
+    {
+        if (strcmp(value, "fixed") == 0)
+        {
+            output_input->trip_distribution = TRIP_DISTRIBUTION_FIXED;
+        }
+        else if (strcmp(value, "uniform") == 0)
+        {
+            output_input->trip_distribution = TRIP_DISTRIBUTION_UNIFORM;
+        }
+        else if (strcmp(value, "geometric") == 0)
+        {
+            output_input->trip_distribution = TRIP_DISTRIBUTION_GEOMETRIC;
+        }
+        else
+        {
+            sprintf(output_error_msg, "unknown trip distribution \"%s\" (expected fixed, uniform or geometric)", value);
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if (strcmp(name, "--hotspots") == 0)
+    {
+        int status = try_to_get_non_negative_int_from_arg(value, "--hotspots",
+        &(output_input->num_hotspots), output_error_msg);
+        if (status == 0 && output_input->num_hotspots > MAX_NUM_HOTSPOTS)
+        {
+            sprintf(output_error_msg, "--hotspots must be at most %d", MAX_NUM_HOTSPOTS);
+            return 1;
+        }
+
+        return status;
+    }
+
+    if (strcmp(name, "--hotspot-share") == 0)
+    {
+        int status = try_to_get_non_negative_int_from_arg(value, "--hotspot-share",
+        &(output_input->hotspot_share), output_error_msg);
+        if (status == 0 && output_input->hotspot_share > 100)
+        {
+            strcpy(output_error_msg, "--hotspot-share must be a percent, at most 100");
+            return 1;
+        }
+
+        return status;
+    }
+
+    if (strcmp(name, "--skew") == 0)
+    {
+        char* end;
+        output_input->skew = strtod(value, &end);
+        if (end == value || *end != '\0' || !(output_input->skew >= 0) || output_input->skew > 100)
+        {
+            strcpy(output_error_msg, "--skew must be a number between 0 and 100");
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if (strcmp(name, "--max-r") == 0)
+    {
+        return try_to_get_positive_int_from_arg(value, "--max-r",
+        &(output_input->max_r), output_error_msg);
+    }
+
+    if (strcmp(name, "--start-time") == 0)
+    {
+        return try_to_get_non_negative_int_from_arg(value, "--start-time",
+        &(output_input->start_time), output_error_msg);
+    }
+
+    if (strcmp(name, "--time-window") == 0)
+    {
+        return try_to_get_positive_int_from_arg(value, "--time-window",
+        &(output_input->time_window), output_error_msg);
+    }
+
+    sprintf(output_error_msg, "unknown option %s", name);
+    return 1;
+}
+
+// Get int from command line argument;
+// IMPORTANT: Assumes int is big enough for converted value;
+int try_to_get_positive_int_from_arg(char* arg, char* var_name, int* output,
+char* output_error_msg)
+{
+    int value = atoi(arg);
+    if (value <= 0)
+    {
+        sprintf(output_error_msg, "%s must be a positive integer", var_name);
+        return 1;
+    }
+
+    *output = value;
+    return 0;
+}
+
+int try_to_get_non_negative_int_from_arg(char* arg, char* var_name, int* output,
+char* output_error_msg)
+{
+    int value = atoi(arg);
+    if (value < 0 || (value == 0 && strcmp(arg, "0") != 0))
+    {
+        sprintf(output_error_msg, "%s must be a non negative integer", var_name);
+        return 1;
+    }
+
+    *output = value;
+    return 0;
+}
+
+int init_hotspots(struct_trace_generate_input *input, struct_hotspots *output_hotspots,
+char* output_error_msg)
+{
+    int num_hotspots = input->num_hotspots;
+    output_hotspots->num_hotspots = num_hotspots;
+    output_hotspots->x = (int*) malloc(sizeof(int) * (num_hotspots + 1));
+    output_hotspots->y = (int*) malloc(sizeof(int) * (num_hotspots + 1));
+    output_hotspots->cumulative_weights = (double*) malloc(sizeof(double) * (num_hotspots + 1));
+    if (!output_hotspots->x || !output_hotspots->y || !output_hotspots->cumulative_weights)
+    {
+        sprintf(output_error_msg, "can't allocate memory for %d hotspots", num_hotspots);
+        free_hotspots(output_hotspots);
+        return 1;
+    }
+
+    int smallest_side = (input->grid_width < input->grid_height) ? input->grid_width : input->grid_height;
+    output_hotspots->radius = (smallest_side / 20 > 1) ? smallest_side / 20 : 1;
+
+    double total_weight = 0;
+    int h;
+    for (h = 0; h < num_hotspots; h++)
+    {
+        uint32_t words[4];
+        draw_random_block(input->seed, HOTSPOTS_RNG_STREAM, (uint32_t) h, 0, words);
+        output_hotspots->x[h] = get_bounded_int(words[0], input->grid_width);
+        output_hotspots->y[h] = get_bounded_int(words[1], input->grid_height);
+
+        // Zipf weights, hotspot 0 is the busiest;
+        total_weight += 1.0 / pow(h + 1, input->skew);
+        output_hotspots->cumulative_weights[h] = total_weight;
+    }
+    for (h = 0; h < num_hotspots; h++)
+    {
+        output_hotspots->cumulative_weights[h] /= total_weight;
+    }
+
+    return 0;
+}
+
+void free_hotspots(struct_hotspots *hotspots)
+{
+    free(hotspots->x);
+    free(hotspots->y);
+    free(hotspots->cumulative_weights);
+
+    hotspots->x = NULL;
+    hotspots->y = NULL;
+    hotspots->cumulative_weights = NULL;
+}
+
+int write_generated_trace(FILE* output_file, struct_trace_generate_input *input, struct_hotspots *hotspots,
+long long *output_num_records, char* output_error_msg)
+{
+    char* buffer = (char*) malloc(OUTPUT_BUFFER_SIZE);
+    if (buffer == NULL)
+    {
+        strcpy(output_error_msg, "can't allocate memory for the output buffer");
+        return 1;
+    }
+    char* p = buffer;
+    long long num_records = 0;
+    int max_trip_length = MAX_TRIP_LENGTH_FACTOR * input->mean_trip_length;
+    // Log of the probability that a geometric trip goes on (1 - 1 / mean), the denominator of the inverse transform;
+    double log_go_on = log(1.0 - 1.0 / input->mean_trip_length);
+
+    int v;
+    for (v = 0; v < input->num_vehicles; v++)
+    {
+        uint32_t words[4];
+        draw_random_block(input->seed, (uint32_t) v, 0, TRIP_RNG_BLOCK, words);
+
+        int trip_length = input->mean_trip_length;
+        if (input->trip_distribution == TRIP_DISTRIBUTION_UNIFORM)
+        {
+            trip_length = 1 + get_bounded_int(words[0], 2 * input->mean_trip_length - 1);
+        }
+        else if (input->trip_distribution == TRIP_DISTRIBUTION_GEOMETRIC && input->mean_trip_length > 1)
+        {
+            // Inverse transform, number of trials up to the first stop;
+            double length = ceil(log(get_unit_double(words[0])) / log_go_on);
+            trip_length = (length < 1) ? 1 : (length > max_trip_length) ? max_trip_length : (int) length;
+        }
+
+        uint32_t more_words[4];
+        draw_random_block(input->seed, (uint32_t) v, 1, TRIP_RNG_BLOCK, more_words);
+        int time = input->start_time + get_bounded_int(more_words[0], input->time_window);
+
+        int x;
+        int y;
+        if (hotspots->num_hotspots > 0 && get_bounded_int(words[1], 100) < input->hotspot_share)
+        {
+            // First hotspot whose cumulative weight passes the draw;
+            double draw = get_unit_double(words[2]);
+            int low = 0;
+            int high = hotspots->num_hotspots - 1;
+            while (low < high)
+            {
+                int middle = (low + high) / 2;
+                if (hotspots->cumulative_weights[middle] < draw)
+                {
+                    low = middle + 1;
+                }
+                else
+                {
+                    high = middle;
+                }
+            }
+
+            int diameter = 2 * hotspots->radius + 1;
+            x = hotspots->x[low] - hotspots->radius + get_bounded_int(words[3], diameter);
+            y = hotspots->y[low] - hotspots->radius + get_bounded_int(more_words[1], diameter);
+            x = (x < 0) ? 0 : (x >= input->grid_width) ? input->grid_width - 1 : x;
+            y = (y < 0) ? 0 : (y >= input->grid_height) ? input->grid_height - 1 : y;
+        }
+        else
+        {
+            x = get_bounded_int(words[2], input->grid_width);
+            y = get_bounded_int(words[3], input->grid_height);
+        }
+
+        // Random walk of at most one cell per axis per record;
+        int i;
+        for (i = 0; i < trip_length; i++)
+        {
+            draw_random_block(input->seed, (uint32_t) v, (uint32_t) i, STEP_RNG_BLOCK, words);
+            int r = 1 + get_bounded_int(words[0], input->max_r);
+
+            if (p - buffer > OUTPUT_BUFFER_SIZE - MAX_RECORD_LINE_SIZE)
+            {
+                if (fwrite(buffer, 1, (size_t) (p - buffer), output_file) != (size_t) (p - buffer))
+                {
+                    strcpy(output_error_msg, "can't write the trace file");
+                    free(buffer);
+                    return 1;
+                }
+                p = buffer;
+            }
+
+            // Vehicle ids start at 1;
+            p = write_int(p, v + 1);
+            *p++ = ';';
+            p = write_int(p, time);
+            *p++ = ';';
+            p = write_int(p, x);
+            *p++ = ';';
+            p = write_int(p, y);
+            *p++ = ';';
+            p = write_int(p, r);
+            *p++ = ';';
+            *p++ = '\n';
+
+            time += 10 * r;
+            x += get_bounded_int(words[1], 3) - 1;
+            y += get_bounded_int(words[2], 3) - 1;
+            x = (x < 0) ? 0 : (x >= input->grid_width) ? input->grid_width - 1 : x;
+            y = (y < 0) ? 0 : (y >= input->grid_height) ? input->grid_height - 1 : y;
+        }
+        num_records += trip_length;
+    }
+
+    if (fwrite(buffer, 1, (size_t) (p - buffer), output_file) != (size_t) (p - buffer))
+    {
+        strcpy(output_error_msg, "can't write the trace file");
+        free(buffer);
+        return 1;
+    }
+    free(buffer);
+
+    *output_num_records = num_records;
+    return 0;
+}
+
+void draw_random_block(int seed, uint32_t stream, uint32_t index, uint32_t block, uint32_t output[4])
+{
+    const uint32_t key[2] = { (uint32_t) seed, 0 };
+    // counter[3] tells the generator's blocks from get_bounded_random()'s;
+    const uint32_t counter[4] = { index, stream, block, 1 };
+
+    philox4x32_10(counter, key, output);
+}
+
+int get_bounded_int(uint32_t word, int bound)
+{
+    return (int) (((uint64_t) word * (uint32_t) bound) >> 32);
+}
+
+double get_unit_double(uint32_t word)
+{
+    return (word + 0.5) / 4294967296.0;
+}
+
+char* write_int(char* p, int value)
+{
+    char digits[12];
+    int num_digits = 0;
+    do
+    {
+        digits[num_digits++] = (char) ('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+
+    while (num_digits > 0)
+    {
+        *p++ = digits[--num_digits];
+    }
+
+    return p;
+}
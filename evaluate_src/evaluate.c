@@ -0,0 +1,842 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "../common_src/trace.h"
+#include "../common_src/coverage.h"
+#include "../common_src/coverage_stream.h"
+
+#define MAX_NUMBER_OF_RSUS              MAX_SOLUTION_SIZE
+
+#define MAX_INPUT_FILE_PATH_SIZE        100
+
+// Solution files sit deep in the results directories;
+#define MAX_SOLUTION_FILE_PATH_SIZE     1000
+
+// <contacts time threshold> <num of contacts> <trace file path>, then the solutions;
+#define NUM_POSITIONAL_ARGS             3
+
+#define MAX_NUM_THREADS                 256
+
+typedef enum output_format_
+{
+    OUTPUT_FORMAT_CSV,
+    // One JSON object per line;
+    OUTPUT_FORMAT_JSON
+
+} enum_output_format;
+
+typedef struct evaluate_input_
+{
+    int contacts_time_threshold;
+    int number_of_contacts;
+
+    // Solution files, in the order given, directories expanded to their solution files in name order;
+    int num_solutions;
+    int solutions_capacity;
+    char **solution_file_paths;
+
+    int num_threads;
+    enum_output_format output_format;
+    // --output, "tau=<threshold>_cont=<contacts>_evaluation.csv" (or .json) by default;
+    char output_file_path[MAX_SOLUTION_FILE_PATH_SIZE + 1];
+
+    // Trace reduced in chunks of about this many MB instead of read whole (--stream), 0 to read it whole;
+    int stream_chunk_size_in_mb;
+
+} struct_evaluate_input;
+
+typedef struct solution_result_
+{
+    // 0 once scored, otherwise error_msg tells why the file couldn't be scored;
+    int status;
+    char error_msg[MAX_SOLUTION_FILE_PATH_SIZE + 100];
+
+    int num_rsus;
+    // RSUs at cells no record of the trace reaches, they cover nobody;
+    int num_rsus_outside_trace;
+    int covered_vehicles;
+
+} struct_solution_result;
+
+// Scores solution files, taking the next one not yet taken until all are done;
+typedef struct evaluate_worker_
+{
+    // Shared by all workers, read only;
+    struct_coverage_indexes *indexes;
+    struct_cell_grid *grid;
+    struct_evaluate_input *input;
+
+    // Shared by all workers, each solution is taken and written by one worker only;
+    int *next_solution;
+    struct_solution_result *results;
+
+    // Scratch owned by the worker;
+    unsigned char *cell_has_rsu;
+    int solution_cells[MAX_NUMBER_OF_RSUS];
+
+} struct_evaluate_worker;
+
+// ==================== INPUT FUNCTIONS ==================== //
+// If succeedes, returns 0 and output_evaluate_input can be used (release it with free_evaluate_input());
+// Otherwise, returns 1 and error_msg can be used;
+int read_commandline_args(
+    int argc, char **argv,
+    struct_evaluate_input *output_evaluate_input,
+    char* output_input_file_path, char* output_error_msg
+);
+
+void free_evaluate_input(struct_evaluate_input *evaluate_input);
+
+int try_to_get_positive_int_from_arg(
+    char* arg, char* var_name,
+    int* output,
+    char* output_error_msg
+);
+
+// Options are "--name value" pairs accepted anywhere among the positional arguments;
+// If succeedes, returns 0 and the option's value is stored in output_evaluate_input;
+// Otherwise, returns 1 and error_msg can be used;
+int read_commandline_option(
+    char* name, char* value,
+    struct_evaluate_input *output_evaluate_input,
+    char* output_error_msg
+);
+
+// A file is added as it is, a directory adds its files ending in "rsus.csv" (GRASP, greedy, baseline
+// and lagrangian) or "_sol.csv" (ILP), in name order, without going into subdirectories;
+// If succeedes, returns 0;
+// Otherwise, returns 1 and error_msg can be used;
+int add_solution_path(
+    const char* path,
+    struct_evaluate_input *output_evaluate_input,
+    char* output_error_msg
+);
+
+int add_solution_file_path(
+    const char* path,
+    struct_evaluate_input *output_evaluate_input,
+    char* output_error_msg
+);
+
+int is_solution_file_name(const char* file_name);
+
+int compare_file_names(const void* a, const void* b);
+// ==================== INPUT FUNCTIONS ==================== //
+
+
+// ==================== EVALUATE FUNCTIONS ==================== //
+// Thread entry point, arg is a struct_evaluate_worker;
+void* run_evaluate_worker(void* arg);
+
+// Reads "x,y" lines and counts the vehicles covered with check_coverage() semantics:
+// contacts up to (first record time + threshold) included, a cell repeated in the solution counts once;
+void evaluate_solution_file(
+    struct_evaluate_worker *worker,
+    const char* solution_file_path,
+    struct_solution_result *output_result
+);
+
+// Solver that wrote the file, from its name: grasp, greedy, baseline, lagrangian, ilp or unknown;
+const char* get_solver_name(const char* solution_file_path);
+// ==================== EVALUATE FUNCTIONS ==================== //
+
+
+// ==================== OUTPUT FUNCTIONS ==================== //
+int write_results_to_file(
+    struct_evaluate_input *evaluate_input,
+    struct_solution_result *results,
+    int num_vehicles,
+    char* output_error_msg
+);
+
+// JSON string with quotes;
+void write_json_string(FILE* output_file, const char* value);
+// ==================== OUTPUT FUNCTIONS ==================== //
+
+
+int main(int argc, char** argv)
+{
+    // In case any specified error below occurs;
+    int status;
+    char error_msg[MAX_SOLUTION_FILE_PATH_SIZE + 300];
+    error_msg[0] = '\0';
+
+    // ==================== 1 - READ INPUT ==================== //
+
+    const char* correct_input_format = "USAGE: evaluate <contacts time threshold> <num of contacts> <trace file path>"
+    " <rsus file or directory> [<rsus file or directory> ...]"
+    " [--threads <num of threads>] [--format csv|json] [--output <output file path>] [--stream <chunk size in MB>]";
+
+    // -------------------- 1.1 COMMAND LINE ------------------ //
+
+    char input_file_path[MAX_INPUT_FILE_PATH_SIZE + 1];
+    input_file_path[0] = '\0';
+    struct_evaluate_input evaluate_input;
+    status = read_commandline_args(argc, argv, &evaluate_input, input_file_path, error_msg);
+    if (status != 0)
+    {
+        fprintf(stderr, "EVALUATE: COMMAND LINE ERROR: %s\n\n%s\n",
+        error_msg, correct_input_format);
+        return 1;
+    }
+
+    // -------------------- 1.2 TRACE FILE -------------------- //
+
+    // Only the cells each vehicle reaches within the threshold are kept, as n-deployment and results1 count them;
+    struct_coverage_indexes indexes;
+    struct_cell_grid grid;
+    struct_trace_read_stats trace_read_stats;
+    if (evaluate_input.stream_chunk_size_in_mb > 0)
+    {
+        // The trace is reduced chunk by chunk, it's never whole in memory;
+        struct_reduced_trace reduced_trace;
+        status = reduce_trace_in_chunks(input_file_path, (size_t) evaluate_input.stream_chunk_size_in_mb * 1000000,
+        evaluate_input.contacts_time_threshold, &(evaluate_input.contacts_time_threshold), 1,
+        &reduced_trace, &trace_read_stats, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "EVALUATE: INPUT TRACE FILE ERROR: %s\n", error_msg);
+            free_evaluate_input(&evaluate_input);
+            return 1;
+        }
+
+        printf("EVALUATE: TRACE FILE: %lld lines, %.1f MB %s reduced in %d chunks of up to %d lines in %.3f s (%.1f MB/s)\n",
+        reduced_trace.size, trace_read_stats.file_size_in_bytes / 1e6,
+        trace_read_stats.is_binary_format ? "binary" : "text", reduced_trace.num_chunks, reduced_trace.max_chunk_size,
+        trace_read_stats.read_time_in_secs, trace_read_stats.throughput_in_mb_per_sec);
+
+        // Everything the evaluation needs is taken, the rest of the reduced trace goes;
+        grid = reduced_trace.grid;
+        indexes = reduced_trace.indexes[0];
+        free(reduced_trace.cell_records);
+        free(reduced_trace.cell_visits);
+    }
+    else
+    {
+        struct_trace trace;
+        status = read_trace(input_file_path, &trace, &trace_read_stats, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "EVALUATE: INPUT TRACE FILE ERROR: %s\n", error_msg);
+            free_evaluate_input(&evaluate_input);
+            return 1;
+        }
+
+        printf("EVALUATE: TRACE FILE: %d lines, %.1f MB %s read in %.3f s (%.1f MB/s)\n",
+        trace.size, trace_read_stats.file_size_in_bytes / 1e6,
+        trace_read_stats.is_binary_format ? "binary" : "text",
+        trace_read_stats.read_time_in_secs, trace_read_stats.throughput_in_mb_per_sec);
+
+        status = copy_cell_grid(&(trace.grid), &grid, error_msg);
+        if (status == 0)
+        {
+            status = build_coverage_indexes(&trace, evaluate_input.contacts_time_threshold, &indexes, error_msg);
+            if (status != 0)
+            {
+                free_cell_grid(&grid);
+            }
+        }
+        free_trace(&trace);
+        if (status != 0)
+        {
+            fprintf(stderr, "EVALUATE: MEMORY ERROR: %s\n", error_msg);
+            free_evaluate_input(&evaluate_input);
+            return 1;
+        }
+    }
+
+    // ==================== 2 - RUN AND WRITE RESULTS ============ //
+
+    int num_solutions = evaluate_input.num_solutions;
+    int num_threads = (evaluate_input.num_threads < num_solutions) ? evaluate_input.num_threads : num_solutions;
+    struct_solution_result* results = (struct_solution_result*) calloc((size_t) num_solutions, sizeof(struct_solution_result));
+    struct_evaluate_worker* workers = (struct_evaluate_worker*) calloc((size_t) num_threads, sizeof(struct_evaluate_worker));
+    pthread_t* threads = (pthread_t*) malloc(sizeof(pthread_t) * (size_t) num_threads);
+
+    int next_solution = 0;
+    int num_ready_workers = 0;
+    if (results && workers && threads)
+    {
+        for (num_ready_workers = 0; num_ready_workers < num_threads; num_ready_workers++)
+        {
+            struct_evaluate_worker* worker = &(workers[num_ready_workers]);
+            worker->indexes = &indexes;
+            worker->grid = &grid;
+            worker->input = &evaluate_input;
+            worker->next_solution = &next_solution;
+            worker->results = results;
+            worker->cell_has_rsu = (unsigned char*) calloc((size_t) (grid.num_cells > 0 ? grid.num_cells : 1), 1);
+            if (worker->cell_has_rsu == NULL)
+            {
+                break;
+            }
+        }
+    }
+
+    struct timespec begin_timer;
+    clock_gettime(CLOCK_MONOTONIC, &begin_timer);
+
+    // The calling thread is worker 0;
+    int num_started_threads = 0;
+    if (num_ready_workers == num_threads)
+    {
+        for (num_started_threads = 1; num_started_threads < num_threads; num_started_threads++)
+        {
+            if (pthread_create(&(threads[num_started_threads]), NULL, run_evaluate_worker,
+            &(workers[num_started_threads])) != 0)
+            {
+                break;
+            }
+        }
+
+        run_evaluate_worker(&(workers[0]));
+
+        int t;
+        for (t = 1; t < num_started_threads; t++)
+        {
+            pthread_join(threads[t], NULL);
+        }
+    }
+
+    struct timespec end_timer;
+    clock_gettime(CLOCK_MONOTONIC, &end_timer);
+
+    if (num_ready_workers != num_threads)
+    {
+        fprintf(stderr, "EVALUATE: MEMORY ERROR: can't allocate memory for %d solutions on %d threads\n",
+        num_solutions, num_threads);
+        status = 1;
+    }
+    else if (num_started_threads != num_threads)
+    {
+        fprintf(stderr, "EVALUATE: THREAD ERROR: can't start thread %d of %d\n", num_started_threads + 1, num_threads);
+        status = 1;
+    }
+
+    // A file that can't be scored fails the run, the others are still written;
+    int s;
+    for (s = 0; s < num_solutions && status == 0; s++)
+    {
+        if (results[s].status != 0)
+        {
+            fprintf(stderr, "EVALUATE: INPUT SOLUTION FILE ERROR: %s\n", results[s].error_msg);
+        }
+    }
+
+    if (status == 0)
+    {
+        printf("EVALUATE: %d solutions scored in %.3f s on %d threads\n", num_solutions,
+        (end_timer.tv_sec - begin_timer.tv_sec) + (end_timer.tv_nsec - begin_timer.tv_nsec) / 1e9, num_threads);
+
+        status = write_results_to_file(&evaluate_input, results, indexes.vehicle_cells.num_vehicles, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "EVALUATE: OUTPUT FILE ERROR: %s\n", error_msg);
+        }
+    }
+
+    for (s = 0; s < num_solutions && status == 0; s++)
+    {
+        if (results[s].status != 0)
+        {
+            status = 1;
+        }
+    }
+
+    // ==================== 3 - FREE REMAINING RESOURCES ====== //
+    int t;
+    for (t = 0; t < num_ready_workers; t++)
+    {
+        free(workers[t].cell_has_rsu);
+    }
+    free(workers);
+    free(threads);
+    free(results);
+    free_coverage_indexes(&indexes);
+    free_cell_grid(&grid);
+    free_evaluate_input(&evaluate_input);
+
+    return status;
+}
+
+int read_commandline_args(int argc, char **argv, struct_evaluate_input *output_evaluate_input,
+char* output_input_file_path, char* output_error_msg)
+{
+    int status = 0;
+
+    // ========== Split options from positional arguments; ========== //
+    output_evaluate_input->num_solutions = 0;
+    output_evaluate_input->solutions_capacity = 0;
+    output_evaluate_input->solution_file_paths = NULL;
+    output_evaluate_input->num_threads = 1;
+    output_evaluate_input->output_format = OUTPUT_FORMAT_CSV;
+    output_evaluate_input->output_file_path[0] = '\0';
+    output_evaluate_input->stream_chunk_size_in_mb = 0;
+
+    // argv-like: program name, then the positional arguments in order, solutions are added as they come;
+    char* positional_args[NUM_POSITIONAL_ARGS + 1];
+    positional_args[0] = argv[0];
+    int num_positional_args = 0;
+    int i;
+    for (i = 1; i < argc && status == 0; i++)
+    {
+        if (strncmp(argv[i], "--", 2) == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                sprintf(output_error_msg, "option %s needs a value", argv[i]);
+                status = 1;
+                break;
+            }
+
+            status = read_commandline_option(argv[i], argv[i + 1], output_evaluate_input, output_error_msg);
+            i++;
+        }
+        else if (num_positional_args < NUM_POSITIONAL_ARGS)
+        {
+            positional_args[++num_positional_args] = argv[i];
+        }
+        else
+        {
+            status = add_solution_path(argv[i], output_evaluate_input, output_error_msg);
+            num_positional_args++;
+        }
+    }
+
+    if (status == 0 && num_positional_args <= NUM_POSITIONAL_ARGS)
+    {
+        strcpy(output_error_msg, "wrong number of arguments");
+        status = 1;
+    }
+    else if (status == 0 && output_evaluate_input->num_solutions == 0)
+    {
+        strcpy(output_error_msg, "no solution files found");
+        status = 1;
+    }
+    argv = positional_args;
+
+    // ========== Try to convert all arguments to correct numeric values; ========== //
+
+    if (status == 0)
+    {
+        status = try_to_get_positive_int_from_arg(argv[1], "<contacts time threshold>",
+        &(output_evaluate_input->contacts_time_threshold), output_error_msg);
+    }
+    if (status == 0)
+    {
+        status = try_to_get_positive_int_from_arg(argv[2], "<num of contacts>",
+        &(output_evaluate_input->number_of_contacts), output_error_msg);
+    }
+    if (status == 0 && strlen(argv[3]) > MAX_INPUT_FILE_PATH_SIZE)
+    {
+        sprintf(output_error_msg, "file path is bigger than %d bytes", MAX_INPUT_FILE_PATH_SIZE);
+        status = 1;
+    }
+    if (status != 0)
+    {
+        free_evaluate_input(output_evaluate_input);
+        return 1;
+    }
+
+    // ========== try to get input file path ========== //
+    strcpy(output_input_file_path, argv[3]);
+
+    if (output_evaluate_input->output_file_path[0] == '\0')
+    {
+        sprintf(output_evaluate_input->output_file_path, "tau=%d_cont=%d_evaluation.%s",
+        output_evaluate_input->contacts_time_threshold, output_evaluate_input->number_of_contacts,
+        (output_evaluate_input->output_format == OUTPUT_FORMAT_JSON) ? "json" : "csv");
+    }
+
+    return 0;
+}
+
+void free_evaluate_input(struct_evaluate_input *evaluate_input)
+{
+    int s;
+    for (s = 0; s < evaluate_input->num_solutions; s++)
+    {
+        free(evaluate_input->solution_file_paths[s]);
+    }
+    free(evaluate_input->solution_file_paths);
+
+    evaluate_input->num_solutions = 0;
+    evaluate_input->solutions_capacity = 0;
+    evaluate_input->solution_file_paths = NULL;
+}
+
+int read_commandline_option(char* name, char* value,
+struct_evaluate_input *output_evaluate_input, char* output_error_msg)
+{
+    if (strcmp(name, "--threads") == 0)
+    {
+        int status = try_to_get_positive_int_from_arg(value, "--threads",
+        &(output_evaluate_input->num_threads), output_error_msg);
+        if (status == 0 && output_evaluate_input->num_threads > MAX_NUM_THREADS)
+        {
+            sprintf(output_error_msg, "--threads must be at most %d", MAX_NUM_THREADS);
+            return 1;
+        }
+
+        return status;
+    }
+
+    if (strcmp(name, "--format") == 0)
+    {
+        if (strcmp(value, "csv") == 0)
+        {
+            output_evaluate_input->output_format = OUTPUT_FORMAT_CSV;
+        }
+        else if (strcmp(value, "json") == 0)
+        {
+            output_evaluate_input->output_format = OUTPUT_FORMAT_JSON;
+        }
+        else
+        {
+            sprintf(output_error_msg, "unknown format \"%s\" (expected csv or json)", value);
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if (strcmp(name, "--output") == 0)
+    {
+        if (strlen(value) > MAX_SOLUTION_FILE_PATH_SIZE)
+        {
+            sprintf(output_error_msg, "output file path is bigger than %d bytes", MAX_SOLUTION_FILE_PATH_SIZE);
+            return 1;
+        }
+
+        strcpy(output_evaluate_input->output_file_path, value);
+        return 0;
+    }
+
+    if (strcmp(name, "--stream") == 0)
+    {
+        return try_to_get_positive_int_from_arg(value, "--stream",
+        &(output_evaluate_input->stream_chunk_size_in_mb), output_error_msg);
+    }
+
+    sprintf(output_error_msg, "unknown option %s", name);
+    return 1;
+}
+
+// Get int from command line argument;
+// IMPORTANT: Assumes int is big enough for converted value;
+int try_to_get_positive_int_from_arg(char* arg, char* var_name, int* output,
+char* output_error_msg)
+{
+    int value = atoi(arg);
+    if (value <= 0)
+    {
+        sprintf(output_error_msg, "%s must be a positive integer", var_name);
+        return 1;
+    }
+
+    *output = value;
+
+    return 0;
+}
+
+int add_solution_path(const char* path, struct_evaluate_input *output_evaluate_input, char* output_error_msg)
+{
+    struct stat path_stat;
+    if (stat(path, &path_stat) != 0)
+    {
+        sprintf(output_error_msg, "can't open \"%.*s\"", MAX_SOLUTION_FILE_PATH_SIZE, path);
+        return 1;
+    }
+
+    if (!S_ISDIR(path_stat.st_mode))
+    {
+        return add_solution_file_path(path, output_evaluate_input, output_error_msg);
+    }
+
+    DIR* directory = opendir(path);
+    if (directory == NULL)
+    {
+        sprintf(output_error_msg, "can't open directory \"%.*s\"", MAX_SOLUTION_FILE_PATH_SIZE, path);
+        return 1;
+    }
+
+    // Directory entries come in no particular order, so they are sorted once added;
+    int first_solution = output_evaluate_input->num_solutions;
+    int status = 0;
+    struct dirent* entry;
+    while ((entry = readdir(directory)) != NULL && status == 0)
+    {
+        if (!is_solution_file_name(entry->d_name))
+        {
+            continue;
+        }
+
+        char file_path[MAX_SOLUTION_FILE_PATH_SIZE + 2];
+        if (strlen(path) + strlen(entry->d_name) + 1 > MAX_SOLUTION_FILE_PATH_SIZE)
+        {
+            sprintf(output_error_msg, "file path of \"%.*s\" is bigger than %d bytes",
+            MAX_SOLUTION_FILE_PATH_SIZE / 2, entry->d_name, MAX_SOLUTION_FILE_PATH_SIZE);
+            status = 1;
+            break;
+        }
+        sprintf(file_path, (path[strlen(path) - 1] == '/') ? "%s%s" : "%s/%s", path, entry->d_name);
+
+        status = add_solution_file_path(file_path, output_evaluate_input, output_error_msg);
+    }
+
+    closedir(directory);
+
+    if (output_evaluate_input->num_solutions - first_solution > 1)
+    {
+        qsort(output_evaluate_input->solution_file_paths + first_solution,
+        output_evaluate_input->num_solutions - first_solution, sizeof(char*), compare_file_names);
+    }
+
+    return status;
+}
+
+int add_solution_file_path(const char* path, struct_evaluate_input *output_evaluate_input, char* output_error_msg)
+{
+    if (strlen(path) > MAX_SOLUTION_FILE_PATH_SIZE)
+    {
+        sprintf(output_error_msg, "solution file path is bigger than %d bytes", MAX_SOLUTION_FILE_PATH_SIZE);
+        return 1;
+    }
+
+    if (output_evaluate_input->num_solutions == output_evaluate_input->solutions_capacity)
+    {
+        int capacity = (output_evaluate_input->solutions_capacity > 0) ? 2 * output_evaluate_input->solutions_capacity : 64;
+        char** solution_file_paths = (char**) realloc(output_evaluate_input->solution_file_paths,
+        sizeof(char*) * (size_t) capacity);
+        if (solution_file_paths == NULL)
+        {
+            sprintf(output_error_msg, "can't allocate memory for %d solution files", capacity);
+            return 1;
+        }
+        output_evaluate_input->solution_file_paths = solution_file_paths;
+        output_evaluate_input->solutions_capacity = capacity;
+    }
+
+    char* solution_file_path = (char*) malloc(strlen(path) + 1);
+    if (solution_file_path == NULL)
+    {
+        sprintf(output_error_msg, "can't allocate memory for the solution file paths");
+        return 1;
+    }
+    strcpy(solution_file_path, path);
+
+    output_evaluate_input->solution_file_paths[ output_evaluate_input->num_solutions++ ] = solution_file_path;
+
+    return 0;
+}
+
+int is_solution_file_name(const char* file_name)
+{
+    size_t length = strlen(file_name);
+
+    return (length >= 8 && strcmp(file_name + length - 8, "rsus.csv") == 0)
+    || (length >= 8 && strcmp(file_name + length - 8, "_sol.csv") == 0);
+}
+
+int compare_file_names(const void* a, const void* b)
+{
+    return strcmp(*(char* const*) a, *(char* const*) b);
+}
+
+void* run_evaluate_worker(void* arg)
+{
+    struct_evaluate_worker* worker = (struct_evaluate_worker*) arg;
+
+    while (1)
+    {
+        int solution_index = __atomic_fetch_add(worker->next_solution, 1, __ATOMIC_RELAXED);
+        if (solution_index >= worker->input->num_solutions)
+        {
+            break;
+        }
+
+        evaluate_solution_file(worker, worker->input->solution_file_paths[solution_index],
+        &(worker->results[solution_index]));
+    }
+
+    return NULL;
+}
+
+void evaluate_solution_file(struct_evaluate_worker *worker, const char* solution_file_path,
+struct_solution_result *output_result)
+{
+    output_result->status = 1;
+    output_result->num_rsus = 0;
+    output_result->num_rsus_outside_trace = 0;
+    output_result->covered_vehicles = 0;
+
+    FILE* solution_file = fopen(solution_file_path, "r");
+    if (solution_file == NULL)
+    {
+        sprintf(output_result->error_msg, "can't open file \"%s\"", solution_file_path);
+        return;
+    }
+
+    // On a bad line the loop stops, the cells marked so far are still cleared below;
+    int is_valid = 1;
+    int num_cells = 0;
+    int line_number = 0;
+    char line[100];
+    while (is_valid && fgets(line, sizeof(line), solution_file) != NULL)
+    {
+        line_number++;
+
+        int x, y;
+        if (line[0] == '\n' || line[0] == '\r' || line[0] == '\0')
+        {
+            continue;
+        }
+        if (sscanf(line, "%d,%d", &x, &y) != 2)
+        {
+            sprintf(output_result->error_msg, "line %d of \"%s\" is not \"x,y\"", line_number, solution_file_path);
+            is_valid = 0;
+            continue;
+        }
+        if (output_result->num_rsus == MAX_NUMBER_OF_RSUS)
+        {
+            sprintf(output_result->error_msg, "\"%s\" has more than %d RSUs", solution_file_path, MAX_NUMBER_OF_RSUS);
+            is_valid = 0;
+            continue;
+        }
+
+        output_result->num_rsus++;
+        int cell = get_cell_id(worker->grid, x, y);
+        if (cell < 0)
+        {
+            output_result->num_rsus_outside_trace++;
+        }
+        else if (!worker->cell_has_rsu[cell])
+        {
+            worker->cell_has_rsu[cell] = 1;
+            worker->solution_cells[num_cells++] = cell;
+        }
+    }
+
+    fclose(solution_file);
+
+    if (is_valid)
+    {
+        output_result->covered_vehicles = count_covered_vehicles(&(worker->indexes->vehicle_cells),
+        worker->cell_has_rsu, worker->input->number_of_contacts);
+        output_result->status = 0;
+    }
+
+    int i;
+    for (i = 0; i < num_cells; i++) worker->cell_has_rsu[ worker->solution_cells[i] ] = 0;
+}
+
+const char* get_solver_name(const char* solution_file_path)
+{
+    const char* file_name = strrchr(solution_file_path, '/');
+    file_name = (file_name != NULL) ? file_name + 1 : solution_file_path;
+
+    if (strncmp(file_name, "ILP_", 4) == 0) return "ilp";
+    if (strstr(file_name, "_bound_rsus") != NULL) return "lagrangian";
+    if (strstr(file_name, "_rcl=") != NULL) return "grasp";
+    if (strncmp(file_name, "n=", 2) == 0) return "baseline";
+    if (strncmp(file_name, "rsu=", 4) == 0) return "greedy";
+
+    return "unknown";
+}
+
+int write_results_to_file(struct_evaluate_input *evaluate_input, struct_solution_result *results,
+int num_vehicles, char* output_error_msg)
+{
+    FILE* output_file = fopen(evaluate_input->output_file_path, "w");
+    if (output_file == NULL)
+    {
+        sprintf(output_error_msg, "can't write file \"%s\"", evaluate_input->output_file_path);
+        return 1;
+    }
+
+    if (evaluate_input->output_format == OUTPUT_FORMAT_CSV)
+    {
+        fprintf(output_file, "file,solver,n_rsus,n_rsus_outside_trace,covered_vehicles,num_vehicles\n");
+    }
+
+    // In the order the files were given, whatever the thread that scored them;
+    int s;
+    for (s = 0; s < evaluate_input->num_solutions; s++)
+    {
+        if (results[s].status != 0)
+        {
+            continue;
+        }
+
+        const char* solution_file_path = evaluate_input->solution_file_paths[s];
+        if (evaluate_input->output_format == OUTPUT_FORMAT_CSV)
+        {
+            // Quoted when the path has "," or "\"";
+            if (strchr(solution_file_path, ',') != NULL || strchr(solution_file_path, '"') != NULL)
+            {
+                fputc('"', output_file);
+                const char* c;
+                for (c = solution_file_path; *c != '\0'; c++)
+                {
+                    if (*c == '"') fputc('"', output_file);
+                    fputc(*c, output_file);
+                }
+                fputc('"', output_file);
+            }
+            else
+            {
+                fprintf(output_file, "%s", solution_file_path);
+            }
+            fprintf(output_file, ",%s,%d,%d,%d,%d\n", get_solver_name(solution_file_path), results[s].num_rsus,
+            results[s].num_rsus_outside_trace, results[s].covered_vehicles, num_vehicles);
+        }
+        else
+        {
+            fprintf(output_file, "{\"file\": ");
+            write_json_string(output_file, solution_file_path);
+            fprintf(output_file, ", \"solver\": \"%s\", \"n_rsus\": %d, \"n_rsus_outside_trace\": %d, "
+            "\"covered_vehicles\": %d, \"num_vehicles\": %d, \"contacts_time_threshold\": %d, \"num_contacts\": %d}\n",
+            get_solver_name(solution_file_path), results[s].num_rsus, results[s].num_rsus_outside_trace,
+            results[s].covered_vehicles, num_vehicles,
+            evaluate_input->contacts_time_threshold, evaluate_input->number_of_contacts);
+        }
+    }
+
+    if (fclose(output_file) != 0)
+    {
+        sprintf(output_error_msg, "can't write file \"%s\"", evaluate_input->output_file_path);
+        return 1;
+    }
+
+    return 0;
+}
+
+void write_json_string(FILE* output_file, const char* value)
+{
+    fputc('"', output_file);
+
+    const unsigned char* c;
+    for (c = (const unsigned char*) value; *c != '\0'; c++)
+    {
+        if (*c == '"' || *c == '\\')
+        {
+            fputc('\\', output_file);
+            fputc(*c, output_file);
+        }
+        else if (*c < 0x20)
+        {
+            fprintf(output_file, "\\u%04x", *c);
+        }
+        else
+        {
+            fputc(*c, output_file);
+        }
+    }
+
+    fputc('"', output_file);
+}
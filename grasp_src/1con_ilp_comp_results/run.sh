@@ -10,27 +10,38 @@ N_ITER=1000
 CONTACT_TIME=30
 N_CONTACTS=1
 RNG_SEED=123
+# Published results were drawn with srand/rand, the default generator is now philox;
+RNG=libc
 
 INPUT_DIR=../..
 INPUT_PATH="${INPUT_DIR}/6_to_8am.csv"
 
+# Convert the text trace once, every run below maps the binary trace instead of parsing it;
+COMMON_DIR=../../common_src
+BIN_INPUT_PATH="${INPUT_PATH%.csv}.bin"
+if [ ! -f "$BIN_INPUT_PATH" ] || [ "$INPUT_PATH" -nt "$BIN_INPUT_PATH" ]
+then
+    $COMMON_DIR/trace-convert "$INPUT_PATH" "$BIN_INPUT_PATH" || exit 1
+fi
+INPUT_PATH="$BIN_INPUT_PATH"
+
 RESULTS_DIR="results"
 
 rm -rf "$RESULTS_DIR"
 mkdir "$RESULTS_DIR"
 
-for n_rsus in 42 211 422 633 845 1056 1267 1478 1690 1901 2112
-do
-    $N_DEPLOY_DIR/n-deployment $n_rsus $CONTACT_TIME $GRASP_RCL_LEN $N_ITER $N_CONTACTS $RNG_SEED $INPUT_PATH
-done
+N_RSUS_LIST="42 211 422 633 845 1056 1267 1478 1690 1901 2112"
 
-wait
+# One process for all budgets, the trace is read and indexed once;
+$N_DEPLOY_DIR/n-deployment $CONTACT_TIME $GRASP_RCL_LEN $N_ITER $N_CONTACTS $RNG_SEED $INPUT_PATH --rng $RNG --budgets "${N_RSUS_LIST// /,}" || exit 1
 
-for n_rsus in 42 211 422 633 845 1056 1267 1478 1690 1901 2112
+for n_rsus in $N_RSUS_LIST
 do
     mv *rsu=${n_rsus}_tau=${CONTACT_TIME}*rsus.csv "${RESULTS_DIR}"
     mv *rsu=${n_rsus}_tau=${CONTACT_TIME}*summary.txt "${RESULTS_DIR}"
 
 done
 
+mv *sweep.csv "${RESULTS_DIR}"
+
 rm *best_coverage*
\ No newline at end of file
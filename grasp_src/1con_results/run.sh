@@ -10,10 +10,21 @@ N_ITER=1000
 CONTACT_TIME=30
 N_CONTACTS=1
 RNG_SEED=123
+# Published results were drawn with srand/rand, the default generator is now philox;
+RNG=libc
 
 INPUT_DIR=../..
 INPUT_PATH="${INPUT_DIR}/6_to_8am.csv"
 
+# Convert the text trace once, every run below maps the binary trace instead of parsing it;
+COMMON_DIR=../../common_src
+BIN_INPUT_PATH="${INPUT_PATH%.csv}.bin"
+if [ ! -f "$BIN_INPUT_PATH" ] || [ "$INPUT_PATH" -nt "$BIN_INPUT_PATH" ]
+then
+    $COMMON_DIR/trace-convert "$INPUT_PATH" "$BIN_INPUT_PATH" || exit 1
+fi
+INPUT_PATH="$BIN_INPUT_PATH"
+
 MIN_N_RSUS=43
 MAX_N_RSUS=423
 N_RSUS_STEP=10
@@ -23,12 +34,8 @@ RESULTS_DIR="rsu=[${MIN_N_RSUS}_${MAX_N_RSUS}_${N_RSUS_STEP}]"
 rm -rf "$RESULTS_DIR"
 mkdir "$RESULTS_DIR"
 
-for ((n_rsus = $MIN_N_RSUS; n_rsus <= $MAX_N_RSUS; n_rsus += $N_RSUS_STEP))
-do
-    $N_DEPLOY_DIR/n-deployment $n_rsus $CONTACT_TIME $GRASP_RCL_LEN $N_ITER $N_CONTACTS $RNG_SEED $INPUT_PATH
-done
-
-wait
+# One process for all budgets, the trace is read and indexed once;
+$N_DEPLOY_DIR/n-deployment $CONTACT_TIME $GRASP_RCL_LEN $N_ITER $N_CONTACTS $RNG_SEED $INPUT_PATH --rng $RNG --budgets "${MIN_N_RSUS}:${MAX_N_RSUS}:${N_RSUS_STEP}" || exit 1
 
 for ((n_rsus = $MIN_N_RSUS; n_rsus <= $MAX_N_RSUS; n_rsus += $N_RSUS_STEP))
 do
@@ -37,4 +44,6 @@ do
 
 done
 
+mv *sweep.csv "${RESULTS_DIR}"
+
 rm *best_coverage*
\ No newline at end of file
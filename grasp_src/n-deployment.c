@@ -3,26 +3,35 @@
 #include <string.h>
 #include <assert.h>
 #include <time.h>
+#include <pthread.h>
+#include <signal.h>
 
-#define MAX_CELL_GRID_WIDTH         100
-#define MAX_CELL_GRID_HEIGHT        100
+#include "../common_src/trace.h"
+#include "../common_src/coverage.h"
+#include "../common_src/coverage_bitset.h"
+#include "../common_src/coverage_stream.h"
+#include "../common_src/rng.h"
+#include "../common_src/budgets.h"
+#include "../common_src/metrics.h"
 
-#define MAX_TRACE_SIZE              2200000
-#define MAX_NUMBER_OF_VEHICLES      80000
 // max solution size;
 #define MAX_NUMBER_OF_RSUS          2500
 
 #define MAX_INPUT_FILE_PATH_SIZE    100
 
-typedef struct trace_ 
-{
-    int vehicle_id;
-    int time;
-    int grid_x_pos;
-    int grid_y_pos;
-    int r;
+#define NUM_POSITIONAL_ARGS         7
+
+// Iterations run in rounds of at most this many, their results are reduced in iteration order after
+// each round, so memory doesn't grow with the number of iterations;
+#define ITERATION_ROUND_SIZE        1024
 
-} trace_line;
+// With --elite-pool, iterations run in rounds of this many, relinked with the pool as it was at the start
+// of the round, and the pool is updated in iteration order after the round;
+#define ELITE_POOL_ROUND_SIZE       16
+
+// A solution joins the elite pool only if it differs from every elite solution in at least this percent
+// of its cells, or in one cell if it is the best one so far;
+#define ELITE_POOL_MIN_DIFFERENCE   10
 
 typedef struct solution_
 {
@@ -31,6 +40,49 @@ typedef struct solution_
 
 } pos_2d;
 
+// Improvement phase applied to each constructed solution (--local-search);
+typedef enum local_search_
+{
+    LOCAL_SEARCH_NONE,
+    // Apply the first swap found that improves coverage;
+    LOCAL_SEARCH_FIRST,
+    // Apply the swap that improves coverage the most;
+    LOCAL_SEARCH_BEST
+
+} enum_local_search;
+
+// Source of the RCL picks (--rng);
+typedef enum grasp_rng_
+{
+    // Counter-based, pick j of iteration i is a function of (seed, i, j) only;
+    GRASP_RNG_PHILOX,
+    // srand(seed) then rand(), as the first versions did; depends on the libc;
+    GRASP_RNG_LIBC
+
+} enum_grasp_rng;
+
+// Cells scores the RCLs are built from (--scoring);
+typedef enum cell_scoring_
+{
+    // Records inside the cell within the threshold, as the first versions did;
+    CELL_SCORING_VISITS,
+    // Sum over the vehicles reaching the cell of min(records inside the cell, <num of contacts>),
+    // records past the contacts a vehicle needs don't make the cell better;
+    CELL_SCORING_CONTACTS
+
+} enum_cell_scoring;
+
+// Why the iterations of a budget stopped;
+typedef enum grasp_stop_
+{
+    GRASP_STOP_ITERATIONS,
+    GRASP_STOP_TIME_LIMIT,
+    GRASP_STOP_TARGET_COVERAGE,
+    // SIGINT or SIGTERM, the best solution so far is still written;
+    GRASP_STOP_SIGNAL
+
+} enum_grasp_stop;
+
 typedef struct n_deployment_input_ 
 {
     // Problem instance;
@@ -41,22 +93,194 @@ typedef struct n_deployment_input_
     // Algorithm parameters;
     int grasp_rng_seed;
     int n_deploy_num_ite;
+    enum_grasp_rng grasp_rng;
+    // Index of the first iteration run, so a run can be resumed or one iteration replayed (--first-iteration);
+    int first_iteration;
     int grasp_rcl_len;
 
-    // To avoid recomputing cells scores when building a solution;
-    int cells[MAX_CELL_GRID_WIDTH][MAX_CELL_GRID_HEIGHT];
+    // How each built solution is evaluated (--eval-kernel);
+    enum_coverage_kernel eval_kernel;
+
+    enum_cell_scoring cell_scoring;
+
+    enum_local_search local_search;
+    // Max swaps applied per iteration, 0 for no limit (--ls-max-moves);
+    int ls_max_moves;
+
+    // Elite solutions kept as path relinking guides (--elite-pool), 0 for no path relinking;
+    int elite_pool_size;
+
+    // Iterations run in parallel on this many threads (--threads);
+    int num_threads;
+
+    // Anytime mode: no iteration is started after this many seconds of iterations (--time-limit),
+    // or once an iteration covers this many vehicles (--target-coverage), 0 for none;
+    // <n-deploy num iterations> is then the most iterations run;
+    int time_limit_in_secs;
+    int target_coverage;
+
+    // Trace reduced in chunks of about this many MB instead of read whole (--stream), 0 to read it whole;
+    int stream_chunk_size_in_mb;
+
+    // Sweep mode (--budgets): every budget is solved in turn instead of <num of rsus>;
+    int is_sweep;
+    struct_budgets budgets;
+
+    // Thresholds the best solution is also scored against (--tau), none by default;
+    struct_budgets taus;
+
+    // Frequented cells of the trace, solutions are dense cells until they are written;
+    struct_cell_grid grid;
+
+    // To avoid recomputing cells scores when building a solution, one per dense cell;
+    int *cells;
+
+    // Cells with a positive score, by decreasing score then row-major order, i.e. the order in which
+    // repeatedly taking (and zeroing) the highest score cell of the grid returns them;
+    int *ranked_cells;
+    int num_ranked_cells;
+    // Position of each cell in ranked_cells, -1 if its score is 0;
+    int *cell_rank;
+    // Cell padding the RCLs once fewer ranked cells than the RCL length are left: grid cell (0,0),
+    // the highest score cell of the grid then, or NO_CELL if no record is in it;
+    int padding_cell;
 
 } struct_n_deployment_input;
 
 typedef struct n_deployment_output_
 {
+    // Iterations run, fewer than <n-deploy num iterations> if stopped before;
+    int num_iterations;
+    enum_grasp_stop stop;
     double mean_ite_execution_time;
     double ite_execution_time;
     pos_2d best_solution[MAX_NUMBER_OF_RSUS];
     int best_solution_obj_f_value;
 
+    // Local search totals over the iterations;
+    long long ls_num_moves;
+    double ls_execution_time;
+
+    // Marginal gains computed by the local search and the path relinking, over the iterations;
+    long long num_gain_evaluations;
+
+    // Path relinking totals over the iterations;
+    long long pr_num_improvements;
+    double pr_execution_time;
+
+    // Construction and evaluation times summed over the iterations (of every thread);
+    double construction_execution_time;
+    double evaluation_execution_time;
+
 } struct_n_deployment_output;
 
+// Scratch of the swap local search, indexed by cell;
+typedef struct swap_search_
+{
+    // Frequented cells, i.e. cells some vehicle reaches within the threshold;
+    int *candidate_cells;
+    int num_candidate_cells;
+
+    // Gain of adding each cell to the current solution;
+    int *base_gain;
+    // Change in that gain once the RSU being swapped out is removed, non zero only for touched cells;
+    int *extra_gain;
+    int *touched_cells;
+    unsigned char *is_touched;
+    // Cells of the guiding solution of the path relinking, all zeros between calls;
+    unsigned char *is_guiding;
+
+    // gain_if_added() and loss_if_removed() calls, added up by every search;
+    long long num_gain_evaluations;
+
+} struct_swap_search;
+
+// Diverse high coverage solutions, the guides of the path relinking;
+typedef struct elite_pool_
+{
+    int max_size;
+    int size;
+    int solution_size;
+    // size solutions of solution_size cells each;
+    int *solution_cells;
+    int *coverage;
+    // Scratch indexed by cell, all zeros between calls;
+    unsigned char *is_marked;
+
+} struct_elite_pool;
+
+typedef struct iteration_result_
+{
+    int coverage;
+    // Coverage before the local search;
+    int construction_coverage;
+    int num_moves;
+    double ls_execution_time;
+    long long num_gain_evaluations;
+    // 1 if the best solution of the relinking path beat the iteration's own solution;
+    int is_improved_by_relinking;
+    double pr_execution_time;
+    double construction_execution_time;
+    double evaluation_execution_time;
+    // Wall clock time from the start of the iterations to the end of this one;
+    double elapsed_time;
+
+} struct_iteration_result;
+
+// Runs GRASP iterations, taking the next one not yet taken until all are done;
+typedef struct n_deployment_worker_
+{
+    // Shared by all workers, read only;
+    struct_coverage_indexes *indexes;
+    struct_cell_bitsets *bitsets;
+    struct_n_deployment_input *input;
+    // libc only, rand() draws of the round's iterations;
+    const int *rcl_draws;
+
+    // Shared by all workers, each iteration is taken and written by one worker only;
+    // Results and draws of iteration i are at i % round_size;
+    int round_size;
+    int *next_iteration;
+    const int *round_end_iteration;
+    struct_iteration_result *iteration_results;
+
+    // Shared by all workers, read only during a round, NULL without --elite-pool;
+    const struct_elite_pool *elite_pool;
+    // Shared by all workers, solution cells of each iteration of the round, ELITE_POOL_ROUND_SIZE solutions;
+    int *round_solution_cells;
+
+    // Shared by all workers, set once the iterations must stop (anytime mode);
+    const struct timespec *begin_timer;
+    int *stop_requested;
+
+    // Scratch owned by the worker;
+    // Ranked cells not in the solution yet, as a circular doubly linked list over positions of ranked_cells,
+    // with num_ranked_cells as head;
+    int *ranked_next;
+    int *ranked_prev;
+    struct_coverage_state coverage_state;
+    // Contacts kernel only;
+    struct_contact_counters contact_counters;
+    unsigned char *cell_has_rsu;
+    struct_swap_search swap_search;
+    int *rcl;
+    // Position of each RCL cell in ranked_cells, -1 for padding;
+    int *rcl_rank;
+    pos_2d solution[MAX_NUMBER_OF_RSUS];
+    int solution_cells[MAX_NUMBER_OF_RSUS];
+    // Bitset kernels only, rows of the solution cells;
+    const uint64_t *bitset_rows[MAX_NUMBER_OF_RSUS];
+    // Path relinking only;
+    int path_cells[MAX_NUMBER_OF_RSUS];
+    int relinking_cells[MAX_NUMBER_OF_RSUS];
+
+    // Best solution among the worker's iterations, the first one on ties;
+    int best_coverage;
+    int best_iteration;
+    pos_2d best_solution[MAX_NUMBER_OF_RSUS];
+
+} struct_n_deployment_worker;
+
 // ==================== INPUT FUNCTIONS ==================== //
 // If succeedes, returns 0 and n_deployment_input can be used;
 // Otherwise, returns 1 and error_msg can be used;
@@ -72,49 +296,182 @@ int try_to_get_positive_int_from_arg(
     char* output_error_msg
 );
 
-// If succeedes, returns 0 and output_trace and output_trace_size can be used;
+int try_to_get_non_negative_int_from_arg(
+    char* arg, char* var_name, 
+    int* output, 
+    char* output_error_msg
+);
+
+// Options are "--name value" pairs accepted anywhere among the positional arguments;
+// If succeedes, returns 0 and the option's value is stored in output_n_deployment_input;
 // Otherwise, returns 1 and error_msg can be used;
-int read_trace(
-    const char* trace_file_name, 
-    trace_line *output_trace, int *output_trace_size, 
+int read_commandline_option(
+    char* name, char* value,
+    struct_n_deployment_input *output_n_deployment_input,
     char* output_error_msg
 );
 // ==================== INPUT FUNCTIONS ==================== //
 
 
 // ==================== N-DEPLOYMENT FUNCTIONS ==================== //
-void n_deployment(
-    trace_line *trace, int trace_size, 
+// If succeedes, returns 0 and output_n_deployment_output can be used;
+// Otherwise, returns 1 and error_msg can be used;
+int n_deployment(
+    struct_coverage_indexes *indexes, 
+    struct_cell_bitsets *bitsets,
     struct_n_deployment_input n_deployment_input, 
     struct_n_deployment_output* output_n_deployment_output,
-    FILE* best_coverage_log_file
+    FILE* best_coverage_log_file,
+    char* output_error_msg
 );
 
-void fill_scores_in_cells(
-    trace_line *trace, 
-    int tam, int cells[ MAX_CELL_GRID_WIDTH ][ MAX_CELL_GRID_HEIGHT ], 
-    int time_interval, int number_of_contacts
+// Worker's shared fields must be set; if succeedes, returns 0 and the worker can run
+// (release it with free_n_deployment_worker());
+// Otherwise, returns 1 and error_msg can be used;
+int init_n_deployment_worker(
+    struct_n_deployment_worker *worker,
+    char* output_error_msg
+);
+
+void free_n_deployment_worker(struct_n_deployment_worker *worker);
+
+// Thread entry point, arg is a struct_n_deployment_worker;
+// Takes the next iteration until all are taken or a stop is requested; every iteration taken is run,
+// so the iterations run are always the first ones, as in a run with that many iterations;
+void* run_n_deployment_worker(void* arg);
+
+// Signal received during the iterations (SIGINT or SIGTERM), 0 if none;
+static volatile sig_atomic_t received_signal = 0;
+
+void handle_stop_signal(int signal_number);
+
+const char* get_grasp_stop_name(enum_grasp_stop stop);
+
+// Builds (and improves, with local search) the solution of one iteration in worker->solution;
+void run_grasp_iteration(
+    struct_n_deployment_worker *worker,
+    int iteration_index,
+    struct_iteration_result *output_result
+);
+
+// Coverage of the solution with the given kernel, the incremental one reads coverage_state
+// which must already hold the solution's RSUs;
+int evaluate_solution(
+    enum_coverage_kernel eval_kernel,
+    struct_coverage_state *coverage_state,
+    struct_coverage_indexes *indexes,
+    struct_contact_counters *contact_counters,
+    struct_cell_bitsets *bitsets,
+    const uint64_t **bitset_rows,
+    unsigned char *cell_has_rsu,
+    int *solution_cells, int solution_size
+);
+
+// If succeedes, returns 0 and output_search can be used (release it with free_swap_search());
+// Otherwise, returns 1 and error_msg can be used;
+int init_swap_search(
+    struct_coverage_indexes *indexes,
+    struct_swap_search *output_search,
+    char* output_error_msg
+);
+
+void free_swap_search(struct_swap_search *search);
+
+// Swaps one RSU of the solution for one unused frequented cell while coverage improves,
+// at most max_moves times (0 for no limit);
+// coverage_state must hold the solution's RSUs and is kept in sync with solution_cells;
+// Returns the number of swaps applied;
+int swap_local_search(
+    struct_swap_search *search,
+    struct_coverage_state *coverage_state,
+    struct_vehicle_cells_index *vehicle_cells,
+    int *solution_cells, int solution_size,
+    enum_local_search local_search, int max_moves
+);
+
+// Walks from the solution in path_cells to guiding_cells, applying at each step the swap of a cell
+// not in the guide for a guide cell that leaves the most vehicles covered;
+// coverage_state must hold the path_cells RSUs and is kept in sync with them;
+// Returns the coverage of the best solution strictly between both ends (copied to output_best_cells),
+// or -1 if they are too close to have one;
+int path_relinking(
+    struct_swap_search *search,
+    struct_coverage_state *coverage_state,
+    struct_vehicle_cells_index *vehicle_cells,
+    int *path_cells, int solution_size,
+    const int *guiding_cells,
+    int *output_best_cells
+);
+
+// Fills search->extra_gain for the removal of cell from the solution;
+// Returns the number of touched cells;
+int fill_extra_gains(
+    struct_swap_search *search,
+    struct_coverage_state *coverage_state,
+    struct_vehicle_cells_index *vehicle_cells,
+    int cell
+);
+
+// Pool starts empty;
+// If succeedes, returns 0 and output_pool can be used (release it with free_elite_pool());
+// Otherwise, returns 1 and error_msg can be used;
+int init_elite_pool(
+    int max_size, int solution_size, int num_cells,
+    struct_elite_pool *output_pool,
+    char* output_error_msg
 );
 
-void reset_cells(int cells[ MAX_CELL_GRID_WIDTH ][ MAX_CELL_GRID_HEIGHT ]);
+void free_elite_pool(struct_elite_pool *pool);
 
-void reset_score_of_cells_having_rsu(
-    int cells[ MAX_CELL_GRID_WIDTH ][ MAX_CELL_GRID_HEIGHT ], 
-    pos_2d *solution, int solution_size
+// Adds the solution if the pool isn't full, or in place of the most similar elite solution
+// with a lower coverage, as long as it differs enough from every elite solution (see ELITE_POOL_MIN_DIFFERENCE);
+// Returns 1 if it was added, 0 otherwise;
+int update_elite_pool(
+    struct_elite_pool *pool,
+    const int *solution_cells,
+    int coverage
 );
 
-void get_cell_with_highest_score(
-    int cells[ MAX_CELL_GRID_WIDTH ][ MAX_CELL_GRID_HEIGHT ], int *_x, int *_y
+// Copies the grid of the trace and allocates the cells scores and ranking of n_deployment_input;
+// If succeedes, returns 0 (release them with free_cells_scores());
+// Otherwise, returns 1 and error_msg can be used;
+int init_cells_scores(
+    struct_cell_grid *grid,
+    struct_n_deployment_input *n_deployment_input,
+    char* output_error_msg
 );
 
-int check_coverage(
-    trace_line *trace, int trace_size, 
-    pos_2d *solution, int solution_size, 
-    int *num_of_contacts, int cells[MAX_CELL_GRID_WIDTH][MAX_CELL_GRID_HEIGHT],
+void free_cells_scores(struct_n_deployment_input *n_deployment_input);
+
+void fill_scores_in_cells(
+    struct_trace *trace, 
+    int tam, int *cells, 
     int time_interval, int number_of_contacts
 );
 
-void reset_vehicles(int *vehicles, int tam);
+// Contacts scores (CELL_SCORING_CONTACTS) from the cell to vehicles index;
+void fill_contact_scores_in_cells(
+    struct_cell_vehicles_index *index,
+    int *cells,
+    int number_of_contacts
+);
+
+void reset_cells(int *cells, int num_cells);
+
+// Coordinates of a dense cell, (0,0) for NO_CELL;
+pos_2d get_cell_position(const struct_cell_grid *grid, int cell);
+
+// If succeedes, returns 0 and ranked_cells, cell_rank and num_ranked_cells
+// can be used (see struct_n_deployment_input);
+// Otherwise, returns 1 and error_msg can be used;
+int rank_cells_by_score(
+    int *cells, int num_cells,
+    int *ranked_cells, int *cell_rank,
+    int *output_num_ranked_cells,
+    char* output_error_msg
+);
+
+int compare_ranked_cells(const void* a, const void* b);
 // ==================== N-DEPLOYMENT FUNCTIONS ==================== //
 
 // ==================== OUTPUT FUNCTIONS ==================== //
@@ -129,8 +486,27 @@ int write_rsus_to_file(
     pos_2d* rsus_pos, int num_rsus,
     char *output_error_msg
 );
+
+// Appends the line "budget,coverage with each threshold of --tau" of the best solution;
+// tau_indexes must be built up to the biggest threshold;
+int write_coverage_by_tau_to_file(
+    FILE* coverage_by_tau_file,
+    struct_coverage_indexes *tau_indexes,
+    struct_n_deployment_input n_deployment_input, 
+    pos_2d* rsus_pos, int num_rsus,
+    char *output_error_msg
+);
+
+// Per phase wall and CPU times and counters of the run, named as the summary file;
+int write_n_deployment_metrics_to_file(
+    struct_n_deployment_input n_deployment_input, 
+    struct_run_metrics *metrics,
+    char *output_error_msg
+);
 // ==================== OUTPUT FUNCTIONS ==================== //
 
+// bench_src includes this file with N_DEPLOYMENT_NO_MAIN defined to time its functions;
+#ifndef N_DEPLOYMENT_NO_MAIN
 int main(int argc, char **argv)
 {
     // In case any specified error below occurs;
@@ -141,7 +517,13 @@ int main(int argc, char **argv)
     // ==================== 1 - READ INPUT ==================== //
 
     const char* correct_input_format = "USAGE: n-deployment <num of rsus> <contacts time threshold> "
-    "<GRASP's rcl length> <n-deploy num iterations> <num of contacts> <GRASP's seed> <trace file path>";
+    "<GRASP's rcl length> <n-deploy num iterations> <num of contacts> <GRASP's seed> <trace file path> "
+    "[--eval-kernel auto|incremental|index|contacts|bitset|bitset-scalar|bitset-avx2|bitset-neon] "
+    "[--scoring visits|contacts] [--local-search none|first|best] [--ls-max-moves <max swaps per iteration>] [--elite-pool <num of elite solutions>] [--threads <num of threads>] "
+    "[--rng philox|libc] [--first-iteration <iteration index>] "
+    "[--budgets <min:max:step or list b1,b2,...> in place of <num of rsus>] "
+    "[--tau <thresholds, min:max:step or list t1,t2,...>] [--stream <chunk size in MB>] "
+    "[--time-limit <seconds of iterations per budget>] [--target-coverage <num of covered vehicles>]";
 
     // -------------------- 1.1 COMMAND LINE ------------------ //
 
@@ -158,325 +540,1840 @@ int main(int argc, char **argv)
 
     // -------------------- 1.2 TRACE FILE -------------------- //
 
-    trace_line *trace = (trace_line *) malloc(sizeof(trace_line) * MAX_TRACE_SIZE);
-    if (!trace)
+    struct_run_metrics metrics;
+    init_run_metrics(&metrics);
+
+    // One index up to the biggest --tau threshold scores all of them;
+    int has_taus = (n_deployment_input.taus.num_budgets > 0);
+    int max_tau = 0;
+    int t;
+    for (t = 0; t < n_deployment_input.taus.num_budgets; t++)
+    {
+        if (n_deployment_input.taus.budgets[t] > max_tau)
+        {
+            max_tau = n_deployment_input.taus.budgets[t];
+        }
+    }
+
+    // Solutions are evaluated on the cells each vehicle reaches within the threshold, not on the trace;
+    struct_coverage_indexes indexes;
+    struct_coverage_indexes tau_indexes;
+    struct_trace_read_stats trace_read_stats;
+    begin_metrics_phase(&metrics, METRICS_PHASE_LOAD);
+    if (n_deployment_input.stream_chunk_size_in_mb > 0)
+    {
+        // The trace is reduced chunk by chunk, it's never whole in memory;
+        struct_reduced_trace reduced_trace;
+        int time_intervals[MAX_REDUCED_TRACE_INDEXES] = { n_deployment_input.contacts_time_threshold, max_tau };
+        status = reduce_trace_in_chunks(input_file_path, (size_t) n_deployment_input.stream_chunk_size_in_mb * 1000000,
+        n_deployment_input.contacts_time_threshold, time_intervals, has_taus ? 2 : 1,
+        &reduced_trace, &trace_read_stats, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "N-DEPLOYMENT: INPUT TRACE FILE ERROR: %s\n", error_msg);
+            return 1;
+        }
+
+        printf("N-DEPLOYMENT: TRACE FILE: %lld lines, %.1f MB %s reduced in %d chunks of up to %d lines in %.3f s (%.1f MB/s)\n",
+        reduced_trace.size, trace_read_stats.file_size_in_bytes / 1e6,
+        trace_read_stats.is_binary_format ? "binary" : "text", reduced_trace.num_chunks, reduced_trace.max_chunk_size,
+        trace_read_stats.read_time_in_secs, trace_read_stats.throughput_in_mb_per_sec);
+        end_metrics_phase(&metrics, METRICS_PHASE_LOAD);
+        add_metrics_counter(&metrics, METRICS_COUNTER_RECORDS_SCANNED, reduced_trace.size);
+        begin_metrics_phase(&metrics, METRICS_PHASE_INDEX);
+
+        status = init_cells_scores(&(reduced_trace.grid), &n_deployment_input, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "N-DEPLOYMENT: MEMORY ERROR: %s\n", error_msg);
+            free_reduced_trace(&reduced_trace);
+            return 1;
+        }
+
+        memcpy(n_deployment_input.cells, reduced_trace.cell_visits, sizeof(int) * (size_t) reduced_trace.grid.num_cells);
+        indexes = reduced_trace.indexes[0];
+        tau_indexes = reduced_trace.indexes[1];
+
+        // The indexes are taken, the rest of the reduced trace goes;
+        reduced_trace.num_indexes = 0;
+        free_reduced_trace(&reduced_trace);
+    }
+    else
+    {
+        struct_trace trace;
+        status = read_trace(input_file_path, &trace, &trace_read_stats, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "N-DEPLOYMENT: INPUT TRACE FILE ERROR: %s\n", error_msg);
+            return 1;
+        }
+
+        printf("N-DEPLOYMENT: TRACE FILE: %d lines, %.1f MB %s read in %.3f s (%.1f MB/s)\n",
+        trace.size, trace_read_stats.file_size_in_bytes / 1e6,
+        trace_read_stats.is_binary_format ? "binary" : "text",
+        trace_read_stats.read_time_in_secs, trace_read_stats.throughput_in_mb_per_sec);
+        end_metrics_phase(&metrics, METRICS_PHASE_LOAD);
+        add_metrics_counter(&metrics, METRICS_COUNTER_RECORDS_SCANNED, trace.size);
+        begin_metrics_phase(&metrics, METRICS_PHASE_INDEX);
+
+        status = init_cells_scores(&(trace.grid), &n_deployment_input, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "N-DEPLOYMENT: MEMORY ERROR: %s\n", error_msg);
+            free_trace(&trace);
+            return 1;
+        }
+
+        status = build_coverage_indexes(&trace, n_deployment_input.contacts_time_threshold, &indexes, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "N-DEPLOYMENT: MEMORY ERROR: %s\n", error_msg);
+            free_trace(&trace);
+            free_cells_scores(&n_deployment_input);
+            return 1;
+        }
+
+        fill_scores_in_cells(&trace, trace.size, 
+        n_deployment_input.cells, n_deployment_input.contacts_time_threshold, n_deployment_input.number_of_contacts);
+
+        if (has_taus)
+        {
+            status = build_coverage_indexes(&trace, max_tau, &tau_indexes, error_msg);
+            if (status != 0)
+            {
+                fprintf(stderr, "N-DEPLOYMENT: MEMORY ERROR: %s\n", error_msg);
+                free_trace(&trace);
+                free_coverage_indexes(&indexes);
+                free_cells_scores(&n_deployment_input);
+                free_budgets(&(n_deployment_input.taus));
+                return 1;
+            }
+        }
+        free_trace(&trace);
+    }
+
+    if (n_deployment_input.cell_scoring == CELL_SCORING_CONTACTS)
+    {
+        fill_contact_scores_in_cells(&(indexes.cell_vehicles), n_deployment_input.cells,
+        n_deployment_input.number_of_contacts);
+    }
+
+    status = rank_cells_by_score(n_deployment_input.cells, n_deployment_input.grid.num_cells, n_deployment_input.ranked_cells,
+    n_deployment_input.cell_rank, &(n_deployment_input.num_ranked_cells), error_msg);
+    if (status != 0)
+    {
+        fprintf(stderr, "N-DEPLOYMENT: MEMORY ERROR: %s\n", error_msg);
+        free_coverage_indexes(&indexes);
+        free_cells_scores(&n_deployment_input);
+        if (has_taus)
+        {
+            free_coverage_indexes(&tau_indexes);
+            free_budgets(&(n_deployment_input.taus));
+        }
+        return 1;
+    }
+    n_deployment_input.padding_cell = get_cell_id(&(n_deployment_input.grid), 0, 0);
+
+    // Bitsets only answer "reaches at least one RSU cell", i.e. 1 contact;
+    if (n_deployment_input.eval_kernel == COVERAGE_KERNEL_AUTO)
+    {
+        n_deployment_input.eval_kernel = (n_deployment_input.number_of_contacts == 1) ?
+        get_best_bitset_kernel() : COVERAGE_KERNEL_INCREMENTAL;
+    }
+    else if (is_bitset_kernel(n_deployment_input.eval_kernel) && n_deployment_input.number_of_contacts != 1)
+    {
+        fprintf(stderr, "N-DEPLOYMENT: COMMAND LINE ERROR: evaluation kernel %s needs <num of contacts> = 1\n",
+        get_coverage_kernel_name(n_deployment_input.eval_kernel));
+        free_coverage_indexes(&indexes);
+        free_cells_scores(&n_deployment_input);
+        return 1;
+    }
+    else if (n_deployment_input.eval_kernel == COVERAGE_KERNEL_CONTACTS
+    && n_deployment_input.number_of_contacts > MAX_SATURATING_CONTACTS)
+    {
+        fprintf(stderr, "N-DEPLOYMENT: COMMAND LINE ERROR: evaluation kernel contacts needs <num of contacts> <= %d\n",
+        MAX_SATURATING_CONTACTS);
+        free_coverage_indexes(&indexes);
+        free_cells_scores(&n_deployment_input);
+        return 1;
+    }
+
+    printf("N-DEPLOYMENT: EVALUATION KERNEL: %s\n", get_coverage_kernel_name(n_deployment_input.eval_kernel));
+
+    // Vehicles reaching each cell, for the bitset kernels, shared by all budgets and workers;
+    struct_cell_bitsets bitsets;
+    bitsets.cell_row = NULL;
+    bitsets.words = NULL;
+    if (is_bitset_kernel(n_deployment_input.eval_kernel))
+    {
+        status = build_cell_bitsets(&indexes, &bitsets, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "N-DEPLOYMENT: MEMORY ERROR: %s\n", error_msg);
+            free_coverage_indexes(&indexes);
+            free_cells_scores(&n_deployment_input);
+            return 1;
+        }
+    }
+    end_metrics_phase(&metrics, METRICS_PHASE_INDEX);
+
+    // Sweep table: one line per budget;
+    FILE* sweep_file = NULL;
+    if (n_deployment_input.is_sweep)
+    {
+        char sweep_file_name[MAX_BUDGETS_LABEL_SIZE + 250];
+        sprintf(sweep_file_name, "rsu=%s_tau=%d_rcl=%d_iter=%d_cont=%d_sweep.csv", 
+        n_deployment_input.budgets.label, n_deployment_input.contacts_time_threshold, 
+        n_deployment_input.grasp_rcl_len, n_deployment_input.n_deploy_num_ite, n_deployment_input.number_of_contacts);
+
+        sweep_file = fopen(sweep_file_name, "w");
+        if (sweep_file == NULL)
+        {
+            fprintf(stderr, "N-DEPLOYMENT: OUTPUT FILE ERROR: can't write sweep file\n");
+            free_coverage_indexes(&indexes);
+            free_cells_scores(&n_deployment_input);
+            free_cell_bitsets(&bitsets);
+            free_budgets(&(n_deployment_input.budgets));
+            if (has_taus)
+            {
+                free_coverage_indexes(&tau_indexes);
+                free_budgets(&(n_deployment_input.taus));
+            }
+            return 1;
+        }
+        fprintf(sweep_file, "budget,obj_f_value,execution_time,sweep_wall_clock_time\n");
+    }
+
+    // Coverage by tau matrix: one line per budget, one column per threshold;
+    FILE* coverage_by_tau_file = NULL;
+    if (has_taus)
+    {
+        char coverage_by_tau_file_name[2 * MAX_BUDGETS_LABEL_SIZE + 250];
+        char rsus_label[MAX_BUDGETS_LABEL_SIZE + 1];
+        if (n_deployment_input.is_sweep)
+        {
+            strcpy(rsus_label, n_deployment_input.budgets.label);
+        }
+        else
+        {
+            sprintf(rsus_label, "%d", n_deployment_input.number_of_rsus);
+        }
+        sprintf(coverage_by_tau_file_name, "rsu=%s_tau=%d_rcl=%d_iter=%d_cont=%d_coverage_by_tau=%s.csv", 
+        rsus_label, n_deployment_input.contacts_time_threshold, n_deployment_input.grasp_rcl_len, 
+        n_deployment_input.n_deploy_num_ite, n_deployment_input.number_of_contacts, n_deployment_input.taus.label);
+
+        coverage_by_tau_file = fopen(coverage_by_tau_file_name, "w");
+        if (coverage_by_tau_file == NULL)
+        {
+            fprintf(stderr, "N-DEPLOYMENT: OUTPUT FILE ERROR: can't write coverage by tau file\n");
+            status = 1;
+        }
+        else
+        {
+            fprintf(coverage_by_tau_file, "budget");
+            for (t = 0; t < n_deployment_input.taus.num_budgets; t++)
+            {
+                fprintf(coverage_by_tau_file, ",tau=%d", n_deployment_input.taus.budgets[t]);
+            }
+            fprintf(coverage_by_tau_file, "\n");
+        }
+    }
+
+    // From here on SIGINT and SIGTERM stop the iterations, the best solution so far is still written;
+    // The handler is reset on the first signal, so a second one ends the process at once;
+    struct sigaction stop_action;
+    memset(&stop_action, 0, sizeof(stop_action));
+    stop_action.sa_handler = handle_stop_signal;
+    stop_action.sa_flags = SA_RESETHAND;
+    sigemptyset(&stop_action.sa_mask);
+    sigaction(SIGINT, &stop_action, NULL);
+    sigaction(SIGTERM, &stop_action, NULL);
+
+    struct timespec sweep_begin_timer;
+    clock_gettime(CLOCK_MONOTONIC, &sweep_begin_timer);
+
+    int num_budgets = n_deployment_input.is_sweep ? n_deployment_input.budgets.num_budgets : 1;
+    int b;
+    for (b = 0; b < num_budgets && status == 0; b++)
+    {
+        if (n_deployment_input.is_sweep)
+        {
+            n_deployment_input.number_of_rsus = n_deployment_input.budgets.budgets[b];
+        }
+
+        // ==================== 2 - RUN AND WRITE COVERAGE LOG =========================== //
+        char best_coverage_log_file_name[MAX_INPUT_FILE_PATH_SIZE + 250];
+        sprintf(best_coverage_log_file_name, "rsu=%d_tau=%d_rcl=%d_iter=%d_cont=%d_best_coverage_log.csv", 
+        n_deployment_input.number_of_rsus, n_deployment_input.contacts_time_threshold, 
+        n_deployment_input.grasp_rcl_len, n_deployment_input.n_deploy_num_ite, n_deployment_input.number_of_contacts);
+
+        FILE* best_coverage_log_file = fopen(best_coverage_log_file_name, "w");
+        if (best_coverage_log_file == NULL)
+        {
+            fprintf(stderr, "N-DEPLOYMENT: OUTPUT FILE ERROR: can't write coverage log file\n");
+            status = 1;
+            break;
+        }
+
+        struct_n_deployment_output n_deployment_output;
+        status = n_deployment(&indexes, &bitsets, n_deployment_input, &n_deployment_output, best_coverage_log_file, error_msg);
+
+        fclose(best_coverage_log_file);
+        if (status != 0)
+        {
+            fprintf(stderr, "N-DEPLOYMENT: MEMORY ERROR: %s\n", error_msg);
+            break;
+        }
+
+        if (n_deployment_output.stop != GRASP_STOP_ITERATIONS
+        || n_deployment_input.time_limit_in_secs > 0 || n_deployment_input.target_coverage > 0)
+        {
+            printf("N-DEPLOYMENT: STOP: %s, %d RSUs, %d iterations in %.3f s\n", get_grasp_stop_name(n_deployment_output.stop),
+            n_deployment_input.number_of_rsus, n_deployment_output.num_iterations, n_deployment_output.ite_execution_time);
+        }
+
+        // Each budget gets the shared load and index phases, as a run with that budget would;
+        // Iteration phases are timed by the iterations, on any thread, so they are summed over threads;
+        struct_run_metrics budget_metrics = metrics;
+        long long num_iterations = n_deployment_output.num_iterations;
+        add_metrics_thread_time(&budget_metrics, METRICS_PHASE_CONSTRUCT,
+        n_deployment_output.construction_execution_time, num_iterations);
+        add_metrics_thread_time(&budget_metrics, METRICS_PHASE_EVALUATE,
+        n_deployment_output.evaluation_execution_time, num_iterations);
+        if (n_deployment_input.local_search != LOCAL_SEARCH_NONE)
+        {
+            add_metrics_thread_time(&budget_metrics, METRICS_PHASE_LOCAL_SEARCH,
+            n_deployment_output.ls_execution_time, num_iterations);
+        }
+        if (n_deployment_input.elite_pool_size > 0)
+        {
+            add_metrics_thread_time(&budget_metrics, METRICS_PHASE_PATH_RELINKING,
+            n_deployment_output.pr_execution_time, num_iterations);
+        }
+        add_metrics_counter(&budget_metrics, METRICS_COUNTER_EVALUATIONS, num_iterations);
+        add_metrics_counter(&budget_metrics, METRICS_COUNTER_RCL_DRAWS, num_iterations * n_deployment_input.number_of_rsus);
+        add_metrics_counter(&budget_metrics, METRICS_COUNTER_GAIN_EVALUATIONS, n_deployment_output.num_gain_evaluations);
+        add_metrics_counter(&budget_metrics, METRICS_COUNTER_LS_MOVES, n_deployment_output.ls_num_moves);
+
+        // ==================== 3 - WRITE OTHER RESULTS: SUMMARY AND RSUS ================= //
+        begin_metrics_phase(&budget_metrics, METRICS_PHASE_OUTPUT);
+        status = write_summary_to_file(n_deployment_input, n_deployment_output, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "N-DEPLOYMENT: OUTPUT FILE ERROR: %s\n", error_msg);
+            break;
+        }
+
+        status = write_rsus_to_file(n_deployment_input, n_deployment_output.best_solution,  n_deployment_input.number_of_rsus, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "N-DEPLOYMENT: OUTPUT FILE ERROR: %s\n", error_msg);
+            break;
+        }
+
+        if (has_taus)
+        {
+            status = write_coverage_by_tau_to_file(coverage_by_tau_file, &tau_indexes, n_deployment_input,
+            n_deployment_output.best_solution, n_deployment_input.number_of_rsus, error_msg);
+            if (status != 0)
+            {
+                fprintf(stderr, "N-DEPLOYMENT: OUTPUT FILE ERROR: %s\n", error_msg);
+                break;
+            }
+        }
+        end_metrics_phase(&budget_metrics, METRICS_PHASE_OUTPUT);
+
+        status = write_n_deployment_metrics_to_file(n_deployment_input, &budget_metrics, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "N-DEPLOYMENT: OUTPUT FILE ERROR: %s\n", error_msg);
+            break;
+        }
+
+        if (n_deployment_input.is_sweep)
+        {
+            struct timespec sweep_timer;
+            clock_gettime(CLOCK_MONOTONIC, &sweep_timer);
+
+            fprintf(sweep_file, "%d,%d,%.06f,%.06f\n", n_deployment_input.number_of_rsus,
+            n_deployment_output.best_solution_obj_f_value, n_deployment_output.ite_execution_time,
+            (sweep_timer.tv_sec - sweep_begin_timer.tv_sec) + (sweep_timer.tv_nsec - sweep_begin_timer.tv_nsec) / 1e9);
+        }
+
+        // The budget's results are written, the next budgets aren't solved;
+        if (received_signal != 0)
+        {
+            fprintf(stderr, "N-DEPLOYMENT: INTERRUPTED: signal %d, results written up to %d RSUs\n",
+            (int) received_signal, n_deployment_input.number_of_rsus);
+            status = 128 + received_signal;
+        }
+    }
+
+    if (n_deployment_input.is_sweep)
+    {
+        if (status == 0)
+        {
+            struct timespec sweep_end_timer;
+            clock_gettime(CLOCK_MONOTONIC, &sweep_end_timer);
+
+            printf("N-DEPLOYMENT: SWEEP: %d budgets solved in %.3f s\n", num_budgets,
+            (sweep_end_timer.tv_sec - sweep_begin_timer.tv_sec) + (sweep_end_timer.tv_nsec - sweep_begin_timer.tv_nsec) / 1e9);
+        }
+
+        fclose(sweep_file);
+        free_budgets(&(n_deployment_input.budgets));
+    }
+
+    if (has_taus)
+    {
+        if (coverage_by_tau_file != NULL)
+        {
+            fclose(coverage_by_tau_file);
+        }
+        free_coverage_indexes(&tau_indexes);
+        free_budgets(&(n_deployment_input.taus));
+    }
+
+    printf("N-DEPLOYMENT: PEAK RSS: %.1f MB\n", get_peak_rss_in_mb());
+
+    // ==================== 4 - FREE REMAINING RESOURCES ====== //
+    free_coverage_indexes(&indexes);
+    free_cells_scores(&n_deployment_input);
+    free_cell_bitsets(&bitsets);
+    
+    return status;
+}
+#endif
+
+int read_commandline_args(int argc, char **argv, struct_n_deployment_input *output_n_deployment_input, 
+char* output_input_file_path, char* output_error_msg)
+{
+    int status;
+
+    // ========== Split options from positional arguments; ========== //
+    output_n_deployment_input->eval_kernel = COVERAGE_KERNEL_AUTO;
+    output_n_deployment_input->cell_scoring = CELL_SCORING_VISITS;
+    output_n_deployment_input->local_search = LOCAL_SEARCH_NONE;
+    output_n_deployment_input->ls_max_moves = 0;
+    output_n_deployment_input->elite_pool_size = 0;
+    output_n_deployment_input->num_threads = 1;
+    output_n_deployment_input->time_limit_in_secs = 0;
+    output_n_deployment_input->target_coverage = 0;
+    output_n_deployment_input->grasp_rng = GRASP_RNG_PHILOX;
+    output_n_deployment_input->first_iteration = 0;
+    output_n_deployment_input->is_sweep = 0;
+    output_n_deployment_input->taus.num_budgets = 0;
+    output_n_deployment_input->stream_chunk_size_in_mb = 0;
+
+    // argv-like: program name, then the positional arguments in order;
+    char* positional_args[NUM_POSITIONAL_ARGS + 1];
+    positional_args[0] = argv[0];
+    int num_positional_args = 0;
+    int i;
+    for (i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--", 2) == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                sprintf(output_error_msg, "option %s needs a value", argv[i]);
+                return 1;
+            }
+
+            status = read_commandline_option(argv[i], argv[i + 1], output_n_deployment_input, output_error_msg);
+            if (status != 0)
+            {
+                return 1;
+            }
+            i++;
+        }
+        else if (num_positional_args < NUM_POSITIONAL_ARGS)
+        {
+            positional_args[++num_positional_args] = argv[i];
+        }
+        else
+        {
+            strcpy(output_error_msg, "wrong number of arguments");
+            return 1;
+        }
+    }
+
+    // In sweep mode, --budgets takes the place of <num of rsus>;
+    if (output_n_deployment_input->is_sweep)
+    {
+        if (num_positional_args != NUM_POSITIONAL_ARGS - 1)
+        {
+            strcpy(output_error_msg, "wrong number of arguments");
+            return 1;
+        }
+
+        for (i = NUM_POSITIONAL_ARGS; i > 1; i--)
+        {
+            positional_args[i] = positional_args[i - 1];
+        }
+        positional_args[1] = NULL;
+    }
+    else if (num_positional_args != NUM_POSITIONAL_ARGS)
+    {
+        strcpy(output_error_msg, "wrong number of arguments");
+        return 1;
+    }
+    argv = positional_args;
+
+    // ========== Try to convert all arguments to correct numeric values; ========== //
+
+    if (!output_n_deployment_input->is_sweep)
+    {
+        status = try_to_get_positive_int_from_arg(argv[1], "<num of rsus>", 
+        &(output_n_deployment_input->number_of_rsus), output_error_msg);
+        if (status != 0)
+        {
+            return 1;
+        }
+        if (output_n_deployment_input->number_of_rsus > MAX_NUMBER_OF_RSUS)
+        {        
+            sprintf(output_error_msg, "number of RSUs must be at most %d", MAX_NUMBER_OF_RSUS);
+            return 1;
+        }
+    }
+    
+    status = try_to_get_positive_int_from_arg(argv[2], "<contacts time threshold>", 
+    &(output_n_deployment_input->contacts_time_threshold), output_error_msg);
+    if (status != 0)
+    {
+        return 1;
+    }
+    status = try_to_get_positive_int_from_arg(argv[3], "<GRASP's rcl length>", 
+    &(output_n_deployment_input->grasp_rcl_len), output_error_msg);
+    if (status != 0)
+    {
+        return 1;
+    }
+    status = try_to_get_positive_int_from_arg(argv[4], "<n-deploy num iterations>", 
+    &(output_n_deployment_input->n_deploy_num_ite), output_error_msg);
+    if (status != 0)
+    {
+        return 1;
+    }
+    status = try_to_get_positive_int_from_arg(argv[5], "<num of contacts>", 
+    &(output_n_deployment_input->number_of_contacts), output_error_msg);
+    if (status != 0)
+    {
+        return 1;
+    }
+    if (output_n_deployment_input->taus.num_budgets > 1 && output_n_deployment_input->number_of_contacts != 1)
+    {
+        strcpy(output_error_msg, "a list of --tau thresholds needs <num of contacts> = 1");
+        return 1;
+    }
+    status = try_to_get_positive_int_from_arg(argv[6], "<GRASP's seed>", 
+    &(output_n_deployment_input->grasp_rng_seed), output_error_msg);
+    if (status != 0)
+    {
+        return 1;
+    }
+
+    // ========== try to get input file path ========== //
+    if (strlen(argv[7]) > MAX_INPUT_FILE_PATH_SIZE)
+    {
+        sprintf(output_error_msg, "file path is bigger than %d bytes", MAX_INPUT_FILE_PATH_SIZE);
+        return 1;
+    }
+    else {
+
+        strcpy(output_input_file_path, argv[7]);
+    }
+
+    return 0;
+}
+
+int read_commandline_option(char* name, char* value,
+struct_n_deployment_input *output_n_deployment_input, char* output_error_msg)
+{
+    if (strcmp(name, "--eval-kernel") == 0)
+    {
+        return get_coverage_kernel_from_name(value, &(output_n_deployment_input->eval_kernel), output_error_msg);
+    }
+
+    if (strcmp(name, "--tau") == 0)
+    {
+        if (output_n_deployment_input->taus.num_budgets > 0)
+        {
+            strcpy(output_error_msg, "option --tau given twice");
+            return 1;
+        }
+
+        return parse_taus(value, MAX_TAU_LIST_VALUE, &(output_n_deployment_input->taus), output_error_msg);
+    }
+
+    if (strcmp(name, "--budgets") == 0)
+    {
+        if (output_n_deployment_input->is_sweep)
+        {
+            strcpy(output_error_msg, "option --budgets given twice");
+            return 1;
+        }
+
+        int status = parse_budgets(value, MAX_NUMBER_OF_RSUS, &(output_n_deployment_input->budgets), output_error_msg);
+        if (status != 0)
+        {
+            return 1;
+        }
+        output_n_deployment_input->is_sweep = 1;
+
+        return 0;
+    }
+
+    if (strcmp(name, "--scoring") == 0)
+    {
+        if (strcmp(value, "visits") == 0)
+        {
+            output_n_deployment_input->cell_scoring = CELL_SCORING_VISITS;
+        }
+        else if (strcmp(value, "contacts") == 0)
+        {
+            output_n_deployment_input->cell_scoring = CELL_SCORING_CONTACTS;
+        }
+        else
+        {
+            sprintf(output_error_msg, "unknown scoring \"%s\" (expected visits or contacts)", value);
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if (strcmp(name, "--local-search") == 0)
+    {
+        if (strcmp(value, "none") == 0)
+        {
+            output_n_deployment_input->local_search = LOCAL_SEARCH_NONE;
+        }
+        else if (strcmp(value, "first") == 0)
+        {
+            output_n_deployment_input->local_search = LOCAL_SEARCH_FIRST;
+        }
+        else if (strcmp(value, "best") == 0)
+        {
+            output_n_deployment_input->local_search = LOCAL_SEARCH_BEST;
+        }
+        else
+        {
+            sprintf(output_error_msg, "unknown local search \"%s\" (expected none, first or best)", value);
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if (strcmp(name, "--rng") == 0)
+    {
+        if (strcmp(value, "philox") == 0)
+        {
+            output_n_deployment_input->grasp_rng = GRASP_RNG_PHILOX;
+        }
+        else if (strcmp(value, "libc") == 0)
+        {
+            output_n_deployment_input->grasp_rng = GRASP_RNG_LIBC;
+        }
+        else
+        {
+            sprintf(output_error_msg, "unknown rng \"%s\" (expected philox or libc)", value);
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if (strcmp(name, "--first-iteration") == 0)
+    {
+        return try_to_get_non_negative_int_from_arg(value, "--first-iteration",
+        &(output_n_deployment_input->first_iteration), output_error_msg);
+    }
+
+    if (strcmp(name, "--threads") == 0)
+    {
+        return try_to_get_positive_int_from_arg(value, "--threads",
+        &(output_n_deployment_input->num_threads), output_error_msg);
+    }
+
+    if (strcmp(name, "--elite-pool") == 0)
+    {
+        return try_to_get_positive_int_from_arg(value, "--elite-pool",
+        &(output_n_deployment_input->elite_pool_size), output_error_msg);
+    }
+
+    if (strcmp(name, "--time-limit") == 0)
+    {
+        return try_to_get_positive_int_from_arg(value, "--time-limit",
+        &(output_n_deployment_input->time_limit_in_secs), output_error_msg);
+    }
+
+    if (strcmp(name, "--target-coverage") == 0)
+    {
+        return try_to_get_positive_int_from_arg(value, "--target-coverage",
+        &(output_n_deployment_input->target_coverage), output_error_msg);
+    }
+
+    if (strcmp(name, "--ls-max-moves") == 0)
+    {
+        return try_to_get_positive_int_from_arg(value, "--ls-max-moves",
+        &(output_n_deployment_input->ls_max_moves), output_error_msg);
+    }
+
+    if (strcmp(name, "--stream") == 0)
+    {
+        return try_to_get_positive_int_from_arg(value, "--stream",
+        &(output_n_deployment_input->stream_chunk_size_in_mb), output_error_msg);
+    }
+
+    sprintf(output_error_msg, "unknown option %s", name);
+    return 1;
+}
+
+// Get int from command line argument;
+// IMPORTANT: Assumes int is big enough for converted value;
+int try_to_get_positive_int_from_arg(char* arg, char* var_name, int* output, 
+char* output_error_msg)
+{
+    int value = atoi(arg);
+    if (value <= 0)
+    {
+        sprintf(output_error_msg, "%s must be a positive integer", var_name);
+        return 1;
+    }
+
+    *output = value;
+
+    return 0;
+}
+
+int try_to_get_non_negative_int_from_arg(char* arg, char* var_name, int* output, 
+char* output_error_msg)
+{
+    char* end;
+    long value = strtol(arg, &end, 10);
+    if (end == arg || *end != '\0' || value < 0 || value > 2147483647L)
+    {
+        sprintf(output_error_msg, "%s must be a non negative integer", var_name);
+        return 1;
+    }
+
+    *output = (int) value;
+
+    return 0;
+}
+
+int n_deployment(struct_coverage_indexes *indexes, struct_cell_bitsets *bitsets, struct_n_deployment_input n_deployment_input, struct_n_deployment_output* output_n_deployment_output, FILE* best_coverage_log_file, char* output_error_msg)
+{
+    int status;
+    int num_iterations = n_deployment_input.n_deploy_num_ite;
+    int num_threads = n_deployment_input.num_threads;
+    if (num_threads > num_iterations)
+    {
+        num_threads = num_iterations;
+    }
+
+    // With --elite-pool, the rounds are the ones of the pool;
+    int round_size = (n_deployment_input.elite_pool_size > 0) ? ELITE_POOL_ROUND_SIZE : ITERATION_ROUND_SIZE;
+    if (round_size > num_iterations)
+    {
+        round_size = num_iterations;
+    }
+
+    // With libc, iteration i uses draws [i * num of rsus, (i + 1) * num of rsus) of the seeded stream,
+    // the ones it would get running alone, so results don't depend on the number of threads;
+    // The draws of a round are made before it;
+    size_t num_rcl_draws = (n_deployment_input.grasp_rng == GRASP_RNG_LIBC) ?
+    (size_t) round_size * (size_t) n_deployment_input.number_of_rsus : 1;
+    int* rcl_draws = (int*) malloc(sizeof(int) * num_rcl_draws);
+    struct_iteration_result* iteration_results = (struct_iteration_result*) malloc(sizeof(struct_iteration_result) * (size_t) round_size);
+    struct_n_deployment_worker* workers = (struct_n_deployment_worker*) calloc((size_t) num_threads, sizeof(struct_n_deployment_worker));
+    pthread_t* threads = (pthread_t*) malloc(sizeof(pthread_t) * (size_t) num_threads);
+    if (!rcl_draws || !iteration_results || !workers || !threads)
+    {
+        sprintf(output_error_msg, "can't allocate memory for rounds of %d iterations on %d threads", round_size, num_threads);
+        free(rcl_draws);
+        free(iteration_results);
+        free(workers);
+        free(threads);
+        return 1;
+    }
+
+    if (n_deployment_input.grasp_rng == GRASP_RNG_LIBC)
+    {
+        srand(n_deployment_input.grasp_rng_seed);
+
+        // Draws of the iterations before the first one;
+        size_t num_skipped_draws = (size_t) n_deployment_input.first_iteration * (size_t) n_deployment_input.number_of_rsus;
+        size_t d;
+        for (d = 0; d < num_skipped_draws; d++)
+        {
+            rand();
+        }
+    }
+
+    struct_elite_pool elite_pool;
+    int* round_solution_cells = NULL;
+    if (n_deployment_input.elite_pool_size > 0)
+    {
+        status = init_elite_pool(n_deployment_input.elite_pool_size, n_deployment_input.number_of_rsus,
+        n_deployment_input.grid.num_cells, &elite_pool, output_error_msg);
+        if (status == 0)
+        {
+            round_solution_cells = (int*) malloc(sizeof(int) * ELITE_POOL_ROUND_SIZE * n_deployment_input.number_of_rsus);
+            if (round_solution_cells == NULL)
+            {
+                sprintf(output_error_msg, "can't allocate memory for the solutions of a round");
+                free_elite_pool(&elite_pool);
+                status = 1;
+            }
+        }
+        if (status != 0)
+        {
+            free(rcl_draws);
+            free(iteration_results);
+            free(workers);
+            free(threads);
+            return 1;
+        }
+    }
+
+    struct timespec begin_timer;
+    int next_iteration = 0;
+    int round_end_iteration = 0;
+    int stop_requested = 0;
+    int num_ready_workers;
+    for (num_ready_workers = 0; num_ready_workers < num_threads; num_ready_workers++)
+    {
+        struct_n_deployment_worker* worker = &(workers[num_ready_workers]);
+        worker->indexes = indexes;
+        worker->bitsets = bitsets;
+        worker->input = &n_deployment_input;
+        worker->rcl_draws = rcl_draws;
+        worker->round_size = round_size;
+        worker->next_iteration = &next_iteration;
+        worker->round_end_iteration = &round_end_iteration;
+        worker->iteration_results = iteration_results;
+        worker->elite_pool = (n_deployment_input.elite_pool_size > 0) ? &elite_pool : NULL;
+        worker->round_solution_cells = round_solution_cells;
+        worker->begin_timer = &begin_timer;
+        worker->stop_requested = &stop_requested;
+
+        status = init_n_deployment_worker(worker, output_error_msg);
+        if (status != 0)
+        {
+            break;
+        }
+    }
+
+    int is_anytime = (n_deployment_input.time_limit_in_secs > 0 || n_deployment_input.target_coverage > 0);
+    int num_iterations_run = 0;
+    int coverage_best_solution = 0;
+    long long ls_num_moves = 0;
+    double ls_execution_time = 0;
+    long long num_gain_evaluations = 0;
+    long long pr_num_improvements = 0;
+    double pr_execution_time = 0;
+    double construction_execution_time = 0;
+    double evaluation_execution_time = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &begin_timer);
+
+    int num_started_threads = 0;
+    while (num_ready_workers == num_threads && round_end_iteration < num_iterations)
+    {
+        // Iterations taken past the end of the previous round weren't run;
+        int round_begin_iteration = round_end_iteration;
+        next_iteration = round_begin_iteration;
+        round_end_iteration = (num_iterations - round_begin_iteration > round_size) ?
+        round_begin_iteration + round_size : num_iterations;
+
+        if (n_deployment_input.grasp_rng == GRASP_RNG_LIBC)
+        {
+            size_t num_round_draws = (size_t) (round_end_iteration - round_begin_iteration)
+            * (size_t) n_deployment_input.number_of_rsus;
+            size_t d;
+            for (d = 0; d < num_round_draws; d++)
+            {
+                rcl_draws[d] = rand();
+            }
+        }
+
+        // The calling thread is worker 0;
+        for (num_started_threads = 1; num_started_threads < num_threads; num_started_threads++)
+        {
+            if (pthread_create(&(threads[num_started_threads]), NULL, run_n_deployment_worker,
+            &(workers[num_started_threads])) != 0)
+            {
+                sprintf(output_error_msg, "can't start thread %d of %d", num_started_threads + 1, num_threads);
+                break;
+            }
+        }
+
+        run_n_deployment_worker(&(workers[0]));
+
+        int t;
+        for (t = 1; t < num_started_threads; t++)
+        {
+            pthread_join(threads[t], NULL);
+        }
+
+        if (num_started_threads != num_threads)
+        {
+            break;
+        }
+
+        // Iterations taken once a stop was requested weren't run;
+        int round_run_end_iteration = (next_iteration < round_end_iteration) ? next_iteration : round_end_iteration;
+
+        // Log in iteration order, as a single thread would;
+        int i;
+        for (i = round_begin_iteration; i < round_run_end_iteration; i++)
+        {
+            struct_iteration_result result = iteration_results[i % round_size];
+            ls_num_moves += result.num_moves;
+            ls_execution_time += result.ls_execution_time;
+            num_gain_evaluations += result.num_gain_evaluations;
+            pr_num_improvements += result.is_improved_by_relinking;
+            pr_execution_time += result.pr_execution_time;
+            construction_execution_time += result.construction_execution_time;
+            evaluation_execution_time += result.evaluation_execution_time;
+
+            if (result.coverage > coverage_best_solution)
+            {
+                coverage_best_solution = result.coverage;
+
+                if (n_deployment_input.local_search != LOCAL_SEARCH_NONE)
+                {
+                    fprintf(best_coverage_log_file, "%d,%d,%d,%d,%.06f", n_deployment_input.first_iteration + i,
+                    result.coverage, result.construction_coverage, result.num_moves, result.ls_execution_time);
+                }
+                else
+                {
+                    fprintf(best_coverage_log_file, "%d,%d", n_deployment_input.first_iteration + i, result.coverage);
+                }
+
+                // Time to target curves, in anytime mode only so fixed runs keep their log;
+                if (is_anytime)
+                {
+                    fprintf(best_coverage_log_file, ",%.06f", result.elapsed_time);
+                }
+                fprintf(best_coverage_log_file, "\n");
+            }
+        }
+        num_iterations_run = round_run_end_iteration;
+
+        if (round_run_end_iteration < round_end_iteration)
+        {
+            break;
+        }
+
+        // In iteration order, so the pool doesn't depend on the number of threads;
+        if (n_deployment_input.elite_pool_size > 0)
+        {
+            for (i = round_begin_iteration; i < round_end_iteration; i++)
+            {
+                update_elite_pool(&elite_pool, round_solution_cells
+                + (size_t) (i % ELITE_POOL_ROUND_SIZE) * n_deployment_input.number_of_rsus,
+                iteration_results[i % round_size].coverage);
+            }
+        }
+    }
+
+    struct timespec end_timer;
+    clock_gettime(CLOCK_MONOTONIC, &end_timer);
+    double execution_time_in_secs = (end_timer.tv_sec - begin_timer.tv_sec)
+    + (end_timer.tv_nsec - begin_timer.tv_nsec) / 1e9;
+
+    status = (num_ready_workers == num_threads && num_started_threads == num_threads) ? 0 : 1;
+    if (status == 0)
+    {
+        num_iterations = num_iterations_run;
+
+        // Best solution is the one of the first iteration reaching the best coverage;
+        int best_worker = 0;
+        int t;
+        for (t = 1; t < num_threads; t++)
+        {
+            if (workers[t].best_coverage > workers[best_worker].best_coverage
+            || (workers[t].best_coverage == workers[best_worker].best_coverage
+            && workers[t].best_iteration < workers[best_worker].best_iteration))
+            {
+                best_worker = t;
+            }
+        }
+
+        memcpy(output_n_deployment_output->best_solution, workers[best_worker].best_solution,
+        sizeof(pos_2d) * n_deployment_input.number_of_rsus);
+
+        enum_grasp_stop stop = GRASP_STOP_ITERATIONS;
+        if (received_signal != 0)
+        {
+            stop = GRASP_STOP_SIGNAL;
+        }
+        else if (num_iterations < n_deployment_input.n_deploy_num_ite)
+        {
+            stop = (n_deployment_input.target_coverage > 0 && coverage_best_solution >= n_deployment_input.target_coverage) ?
+            GRASP_STOP_TARGET_COVERAGE : GRASP_STOP_TIME_LIMIT;
+        }
+
+        output_n_deployment_output->num_iterations = num_iterations;
+        output_n_deployment_output->stop = stop;
+        output_n_deployment_output->mean_ite_execution_time = execution_time_in_secs / num_iterations;
+        output_n_deployment_output->ite_execution_time = execution_time_in_secs;
+        output_n_deployment_output->best_solution_obj_f_value = coverage_best_solution;
+        output_n_deployment_output->ls_num_moves = ls_num_moves;
+        output_n_deployment_output->ls_execution_time = ls_execution_time;
+        output_n_deployment_output->num_gain_evaluations = num_gain_evaluations;
+        output_n_deployment_output->pr_num_improvements = pr_num_improvements;
+        output_n_deployment_output->pr_execution_time = pr_execution_time;
+        output_n_deployment_output->construction_execution_time = construction_execution_time;
+        output_n_deployment_output->evaluation_execution_time = evaluation_execution_time;
+    }
+
+    int t;
+    for (t = 0; t < num_ready_workers; t++)
+    {
+        free_n_deployment_worker(&(workers[t]));
+    }
+    if (n_deployment_input.elite_pool_size > 0)
+    {
+        free_elite_pool(&elite_pool);
+        free(round_solution_cells);
+    }
+    free(rcl_draws);
+    free(iteration_results);
+    free(workers);
+    free(threads);
+
+    return status;
+}
+
+int init_n_deployment_worker(struct_n_deployment_worker *worker, char* output_error_msg)
+{
+    int status = init_coverage_state(worker->indexes, worker->input->number_of_contacts,
+    &(worker->coverage_state), output_error_msg);
+    if (status != 0)
+    {
+        return 1;
+    }
+
+    worker->contact_counters.num_of_contacts = NULL;
+    worker->contact_counters.cell_is_counted = NULL;
+    if (worker->input->eval_kernel == COVERAGE_KERNEL_CONTACTS)
+    {
+        status = init_contact_counters(worker->indexes, &(worker->contact_counters), output_error_msg);
+        if (status != 0)
+        {
+            free_coverage_state(&(worker->coverage_state));
+            return 1;
+        }
+    }
+
+    int num_ranked_cells = worker->input->num_ranked_cells;
+    worker->cell_has_rsu = (unsigned char*) calloc((size_t) worker->input->grid.num_cells, sizeof(unsigned char));
+    worker->rcl = (int*) malloc(sizeof(int) * worker->input->grasp_rcl_len);
+    worker->rcl_rank = (int*) malloc(sizeof(int) * worker->input->grasp_rcl_len);
+    worker->ranked_next = (int*) malloc(sizeof(int) * (num_ranked_cells + 1));
+    worker->ranked_prev = (int*) malloc(sizeof(int) * (num_ranked_cells + 1));
+    if (!worker->cell_has_rsu || !worker->rcl || !worker->rcl_rank || !worker->ranked_next || !worker->ranked_prev)
+    {
+        sprintf(output_error_msg, "can't allocate memory for the RSU cells");
+        free(worker->cell_has_rsu);
+        free(worker->rcl);
+        free(worker->rcl_rank);
+        free(worker->ranked_next);
+        free(worker->ranked_prev);
+        free_coverage_state(&(worker->coverage_state));
+        free_contact_counters(&(worker->contact_counters));
+        return 1;
+    }
+
+    // Path relinking walks with the swaps of the local search;
+    worker->swap_search.candidate_cells = NULL;
+    if (worker->input->local_search != LOCAL_SEARCH_NONE || worker->input->elite_pool_size > 0)
+    {
+        status = init_swap_search(worker->indexes, &(worker->swap_search), output_error_msg);
+        if (status != 0)
+        {
+            free(worker->cell_has_rsu);
+            free(worker->rcl);
+            free(worker->rcl_rank);
+            free(worker->ranked_next);
+            free(worker->ranked_prev);
+            free_coverage_state(&(worker->coverage_state));
+            free_contact_counters(&(worker->contact_counters));
+            return 1;
+        }
+    }
+
+    worker->best_coverage = -1;
+    worker->best_iteration = -1;
+
+    return 0;
+}
+
+void free_n_deployment_worker(struct_n_deployment_worker *worker)
+{
+    free_coverage_state(&(worker->coverage_state));
+    free_contact_counters(&(worker->contact_counters));
+    free(worker->cell_has_rsu);
+    free(worker->rcl);
+    free(worker->rcl_rank);
+    free(worker->ranked_next);
+    free(worker->ranked_prev);
+    if (worker->swap_search.candidate_cells != NULL)
+    {
+        free_swap_search(&(worker->swap_search));
+    }
+
+    worker->cell_has_rsu = NULL;
+    worker->rcl = NULL;
+    worker->rcl_rank = NULL;
+    worker->ranked_next = NULL;
+    worker->ranked_prev = NULL;
+}
+
+void* run_n_deployment_worker(void* arg)
+{
+    struct_n_deployment_worker* worker = (struct_n_deployment_worker*) arg;
+
+    struct_n_deployment_input* n_deployment_input = worker->input;
+    while (1)
+    {
+        // Checked before taking an iteration, not after, so the iterations run are the first ones;
+        // The first iteration is always run, there is a best solution to write;
+        if (__atomic_load_n(worker->next_iteration, __ATOMIC_RELAXED) > 0)
+        {
+            if (received_signal != 0 || __atomic_load_n(worker->stop_requested, __ATOMIC_RELAXED))
+            {
+                break;
+            }
+
+            if (n_deployment_input->time_limit_in_secs > 0)
+            {
+                struct timespec timer;
+                clock_gettime(CLOCK_MONOTONIC, &timer);
+                if ((timer.tv_sec - worker->begin_timer->tv_sec) + (timer.tv_nsec - worker->begin_timer->tv_nsec) / 1e9
+                >= n_deployment_input->time_limit_in_secs)
+                {
+                    break;
+                }
+            }
+        }
+
+        int iteration_index = __atomic_fetch_add(worker->next_iteration, 1, __ATOMIC_RELAXED);
+        if (iteration_index >= *(worker->round_end_iteration))
+        {
+            break;
+        }
+
+        struct_iteration_result* result = &(worker->iteration_results[iteration_index % worker->round_size]);
+        run_grasp_iteration(worker, iteration_index, result);
+
+        if (worker->round_solution_cells != NULL)
+        {
+            memcpy(worker->round_solution_cells + (size_t) (iteration_index % ELITE_POOL_ROUND_SIZE) * n_deployment_input->number_of_rsus,
+            worker->solution_cells, sizeof(int) * n_deployment_input->number_of_rsus);
+        }
+
+        struct timespec end_timer;
+        clock_gettime(CLOCK_MONOTONIC, &end_timer);
+        result->elapsed_time = (end_timer.tv_sec - worker->begin_timer->tv_sec)
+        + (end_timer.tv_nsec - worker->begin_timer->tv_nsec) / 1e9;
+
+        if (n_deployment_input->target_coverage > 0 && result->coverage >= n_deployment_input->target_coverage)
+        {
+            __atomic_store_n(worker->stop_requested, 1, __ATOMIC_RELAXED);
+        }
+
+        // Iterations of a worker are increasing, so ties keep the first one;
+        if (result->coverage > worker->best_coverage)
+        {
+            worker->best_coverage = result->coverage;
+            worker->best_iteration = iteration_index;
+            memcpy(worker->best_solution, worker->solution, sizeof(pos_2d) * worker->input->number_of_rsus);
+        }
+    }
+
+    return NULL;
+}
+
+void handle_stop_signal(int signal_number)
+{
+    received_signal = signal_number;
+}
+
+const char* get_grasp_stop_name(enum_grasp_stop stop)
+{
+    switch (stop)
+    {
+        case GRASP_STOP_TIME_LIMIT:
+            return "time limit";
+        case GRASP_STOP_TARGET_COVERAGE:
+            return "target coverage";
+        case GRASP_STOP_SIGNAL:
+            return "signal";
+        default:
+            return "all iterations run";
+    }
+}
+
+void run_grasp_iteration(struct_n_deployment_worker *worker, int iteration_index,
+struct_iteration_result *output_result)
+{
+    struct_n_deployment_input* n_deployment_input = worker->input;
+    enum_coverage_kernel eval_kernel = n_deployment_input->eval_kernel;
+    enum_local_search local_search = n_deployment_input->local_search;
+    // The local search and the path relinking move on the coverage state, whatever the kernel;
+    const struct_elite_pool* elite_pool = worker->elite_pool;
+    int use_coverage_state = (eval_kernel == COVERAGE_KERNEL_INCREMENTAL) || (local_search != LOCAL_SEARCH_NONE)
+    || (elite_pool != NULL);
+
+    const int* rcl_draws = worker->rcl_draws + ((n_deployment_input->grasp_rng == GRASP_RNG_LIBC) ?
+    (size_t) (iteration_index % worker->round_size) * n_deployment_input->number_of_rsus : 0);
+    // Philox stream of the iteration, numbered from the first iteration of all runs;
+    uint32_t rng_stream = (uint32_t) (n_deployment_input->first_iteration + iteration_index);
+    pos_2d* solution = worker->solution;
+    int* solution_cells = worker->solution_cells;
+    int* rcl = worker->rcl;
+    struct_cell_grid* grid = &(n_deployment_input->grid);
+    int* rcl_rank = worker->rcl_rank;
+    int* ranked_next = worker->ranked_next;
+    int* ranked_prev = worker->ranked_prev;
+    int solution_size = 0;
+
+    struct timespec construction_begin_timer;
+    clock_gettime(CLOCK_MONOTONIC, &construction_begin_timer);
+
+    // every ranked cell is available again
+    int head = n_deployment_input->num_ranked_cells;
+    int position;
+    for (position = 0; position <= head; position++)
+    {
+        ranked_next[position] = (position == head) ? 0 : position + 1;
+        ranked_prev[position] = (position == 0) ? head : position - 1;
+    }
+
+    while (solution_size < n_deployment_input->number_of_rsus)
+    {
+        // lets get the "rcl-len" best cells not in the solution
+        int i = 0;
+        for (position = ranked_next[head]; i < n_deployment_input->grasp_rcl_len && position != head;
+        position = ranked_next[position], i++)
+        {
+            rcl[i] = n_deployment_input->ranked_cells[position];
+            rcl_rank[i] = position;
+        }
+        // once every positive score cell is used, the highest score cell of the grid is its first cell, (0,0)
+        for (; i < n_deployment_input->grasp_rcl_len; i++)
+        {
+            rcl[i] = n_deployment_input->padding_cell;
+            rcl_rank[i] = -1;
+        }
+
+        // pick random number between 0..rcl_len
+        int selected = (n_deployment_input->grasp_rng == GRASP_RNG_LIBC) ?
+        rcl_draws[solution_size] % n_deployment_input->grasp_rcl_len :
+        (int) get_bounded_random((uint32_t) n_deployment_input->grasp_rng_seed, rng_stream,
+        (uint32_t) solution_size, (uint32_t) n_deployment_input->grasp_rcl_len);
+
+        // selected cell is no longer available
+        position = rcl_rank[selected];
+        if (position >= 0)
+        {
+            ranked_next[ ranked_prev[position] ] = ranked_next[position];
+            ranked_prev[ ranked_next[position] ] = ranked_prev[position];
+        }
+        
+        // add selected rsu to the solution
+        solution_cells[solution_size] = rcl[selected];
+        solution[solution_size] = get_cell_position(grid, rcl[selected]);
+        if (use_coverage_state)
+        {
+            add_rsu(&(worker->coverage_state), solution_cells[solution_size]);
+        }
+        solution_size++;
+    }
+
+    struct timespec evaluation_begin_timer;
+    clock_gettime(CLOCK_MONOTONIC, &evaluation_begin_timer);
+
+    int coverage = evaluate_solution(eval_kernel, &(worker->coverage_state), worker->indexes,
+    &(worker->contact_counters), worker->bitsets, worker->bitset_rows, worker->cell_has_rsu,
+    solution_cells, solution_size);
+
+    struct timespec evaluation_end_timer;
+    clock_gettime(CLOCK_MONOTONIC, &evaluation_end_timer);
+    output_result->construction_execution_time = (evaluation_begin_timer.tv_sec - construction_begin_timer.tv_sec)
+    + (evaluation_begin_timer.tv_nsec - construction_begin_timer.tv_nsec) / 1e9;
+    output_result->evaluation_execution_time = (evaluation_end_timer.tv_sec - evaluation_begin_timer.tv_sec)
+    + (evaluation_end_timer.tv_nsec - evaluation_begin_timer.tv_nsec) / 1e9;
+
+    output_result->construction_coverage = coverage;
+    output_result->num_moves = 0;
+    output_result->ls_execution_time = 0;
+    worker->swap_search.num_gain_evaluations = 0;
+    if (local_search != LOCAL_SEARCH_NONE)
+    {
+        struct timespec ls_begin_timer;
+        clock_gettime(CLOCK_MONOTONIC, &ls_begin_timer);
+
+        output_result->num_moves = swap_local_search(&(worker->swap_search), &(worker->coverage_state),
+        &(worker->indexes->vehicle_cells), solution_cells, solution_size, local_search,
+        n_deployment_input->ls_max_moves);
+
+        struct timespec ls_end_timer;
+        clock_gettime(CLOCK_MONOTONIC, &ls_end_timer);
+        output_result->ls_execution_time = (ls_end_timer.tv_sec - ls_begin_timer.tv_sec)
+        + (ls_end_timer.tv_nsec - ls_begin_timer.tv_nsec) / 1e9;
+
+        coverage = current_coverage(&(worker->coverage_state));
+
+        int i;
+        for (i = 0; i < solution_size; i++)
+        {
+            solution[i] = get_cell_position(grid, solution_cells[i]);
+        }
+    }
+
+    output_result->is_improved_by_relinking = 0;
+    output_result->pr_execution_time = 0;
+    if (elite_pool != NULL && elite_pool->size > 0)
+    {
+        struct timespec pr_begin_timer;
+        clock_gettime(CLOCK_MONOTONIC, &pr_begin_timer);
+
+        // Guide drawn from the iteration's Philox stream, past its RCL picks;
+        int guide = (int) get_bounded_random((uint32_t) n_deployment_input->grasp_rng_seed, rng_stream,
+        (uint32_t) solution_size, (uint32_t) elite_pool->size);
+
+        int* path_cells = worker->path_cells;
+        memcpy(path_cells, solution_cells, sizeof(int) * solution_size);
+        int relinking_coverage = path_relinking(&(worker->swap_search), &(worker->coverage_state),
+        &(worker->indexes->vehicle_cells), path_cells, solution_size,
+        elite_pool->solution_cells + (size_t) guide * elite_pool->solution_size, worker->relinking_cells);
+
+        // Back to the iteration's solution, or on to the best one of the path;
+        int i;
+        for (i = 0; i < solution_size; i++)
+        {
+            remove_rsu(&(worker->coverage_state), path_cells[i]);
+        }
+        if (relinking_coverage > coverage)
+        {
+            memcpy(solution_cells, worker->relinking_cells, sizeof(int) * solution_size);
+        }
+        for (i = 0; i < solution_size; i++)
+        {
+            add_rsu(&(worker->coverage_state), solution_cells[i]);
+        }
+
+        if (relinking_coverage > coverage)
+        {
+            if (local_search != LOCAL_SEARCH_NONE)
+            {
+                output_result->num_moves += swap_local_search(&(worker->swap_search), &(worker->coverage_state),
+                &(worker->indexes->vehicle_cells), solution_cells, solution_size, local_search,
+                n_deployment_input->ls_max_moves);
+            }
+            coverage = current_coverage(&(worker->coverage_state));
+            output_result->is_improved_by_relinking = 1;
+
+            for (i = 0; i < solution_size; i++)
+            {
+                solution[i] = get_cell_position(grid, solution_cells[i]);
+            }
+        }
+
+        struct timespec pr_end_timer;
+        clock_gettime(CLOCK_MONOTONIC, &pr_end_timer);
+        output_result->pr_execution_time = (pr_end_timer.tv_sec - pr_begin_timer.tv_sec)
+        + (pr_end_timer.tv_nsec - pr_begin_timer.tv_nsec) / 1e9;
+    }
+    output_result->num_gain_evaluations = worker->swap_search.num_gain_evaluations;
+    output_result->coverage = coverage;
+
+    // Empty the coverage state for the next iteration;
+    if (use_coverage_state)
+    {
+        int i;
+        for (i = 0; i < solution_size; i++)
+        {
+            remove_rsu(&(worker->coverage_state), solution_cells[i]);
+        }
+    }
+}
+
+int evaluate_solution(enum_coverage_kernel eval_kernel, struct_coverage_state *coverage_state,
+struct_coverage_indexes *indexes, struct_contact_counters *contact_counters, struct_cell_bitsets *bitsets,
+const uint64_t **bitset_rows, unsigned char *cell_has_rsu, int *solution_cells, int solution_size)
+{
+    if (eval_kernel == COVERAGE_KERNEL_INCREMENTAL)
+    {
+        return current_coverage(coverage_state);
+    }
+
+    if (eval_kernel == COVERAGE_KERNEL_CONTACTS)
     {
-        fprintf(stderr, "N-DEPLOYMENT: MEMORY ERROR: can't allocate memory"
-        " for %d trace lines (MAX_TRACE_SIZE)\n", MAX_TRACE_SIZE);
-        return 1;
+        return count_covered_vehicles_by_cells(&(indexes->cell_vehicles), contact_counters,
+        solution_cells, solution_size, coverage_state->number_of_contacts);
     }
 
-    int trace_size;
-    status = read_trace(input_file_path, trace, &trace_size, error_msg);
-    if (status != 0)
+    if (is_bitset_kernel(eval_kernel))
     {
-        fprintf(stderr, "N-DEPLOYMENT: INPUT TRACE FILE ERROR: %s\n", error_msg);
-        free(trace);
-        return 1;
+        return count_covered_vehicles_bitset(bitsets, solution_cells, solution_size, eval_kernel, bitset_rows);
     }
 
-    fill_scores_in_cells(trace, trace_size, 
-    n_deployment_input.cells, n_deployment_input.contacts_time_threshold, n_deployment_input.number_of_contacts);
+    int i;
+    for (i = 0; i < solution_size; i++)
+    {
+        if (solution_cells[i] != NO_CELL)
+        {
+            cell_has_rsu[ solution_cells[i] ] = 1;
+        }
+    }
 
-    // ==================== 2 - RUN AND WRITE COVERAGE LOG =========================== //
-    char best_coverage_log_file_name[MAX_INPUT_FILE_PATH_SIZE + 250];
-    sprintf(best_coverage_log_file_name, "rsu=%d_tau=%d_rcl=%d_iter=%d_cont=%d_best_coverage_log.csv", 
-    n_deployment_input.number_of_rsus, n_deployment_input.contacts_time_threshold, 
-    n_deployment_input.grasp_rcl_len, n_deployment_input.n_deploy_num_ite, n_deployment_input.number_of_contacts);
+    int coverage = count_covered_vehicles(&(indexes->vehicle_cells), cell_has_rsu, coverage_state->number_of_contacts);
 
-    FILE* best_coverage_log_file = fopen(best_coverage_log_file_name, "w");
-    if (best_coverage_log_file == NULL)
+    for (i = 0; i < solution_size; i++)
     {
-        fprintf(stderr, "N-DEPLOYMENT: OUTPUT FILE ERROR: can't write coverage log file\n");
-        free(trace);
-        return 1;
+        if (solution_cells[i] != NO_CELL)
+        {
+            cell_has_rsu[ solution_cells[i] ] = 0;
+        }
     }
 
-    struct_n_deployment_output n_deployment_output;
-    n_deployment(trace, trace_size, n_deployment_input, &n_deployment_output, best_coverage_log_file);
+    return coverage;
+}
 
-    fclose(best_coverage_log_file);
-    // ==================== 3 - WRITE OTHER RESULTS: SUMMARY AND RSUS ================= //
-    status = write_summary_to_file(n_deployment_input, n_deployment_output, error_msg);
-    if (status != 0)
+int init_swap_search(struct_coverage_indexes *indexes, struct_swap_search *output_search,
+char* output_error_msg)
+{
+    size_t num_cells = (size_t) indexes->cell_vehicles.num_cells;
+    output_search->candidate_cells = (int*) malloc(sizeof(int) * num_cells);
+    output_search->base_gain = (int*) malloc(sizeof(int) * num_cells);
+    output_search->extra_gain = (int*) calloc(num_cells, sizeof(int));
+    output_search->touched_cells = (int*) malloc(sizeof(int) * num_cells);
+    output_search->is_touched = (unsigned char*) calloc(num_cells, sizeof(unsigned char));
+    output_search->is_guiding = (unsigned char*) calloc(num_cells, sizeof(unsigned char));
+    if (!output_search->candidate_cells || !output_search->base_gain || !output_search->extra_gain
+    || !output_search->touched_cells || !output_search->is_touched || !output_search->is_guiding)
     {
-        fprintf(stderr, "N-DEPLOYMENT: OUTPUT FILE ERROR: %s\n", error_msg);
-        free(trace);
+        sprintf(output_error_msg, "can't allocate memory for the local search");
+        free_swap_search(output_search);
         return 1;
     }
 
-    status = write_rsus_to_file(n_deployment_input, n_deployment_output.best_solution,  n_deployment_input.number_of_rsus, error_msg);
-    if (status != 0)
+    struct_cell_vehicles_index* cell_vehicles = &(indexes->cell_vehicles);
+    int num_candidate_cells = 0;
+    int c;
+    for (c = 0; c < cell_vehicles->num_cells; c++)
     {
-        fprintf(stderr, "N-DEPLOYMENT: OUTPUT FILE ERROR: %s\n", error_msg);
-        free(trace);
-        return 1;
+        if (cell_vehicles->cell_offsets[c + 1] > cell_vehicles->cell_offsets[c])
+        {
+            output_search->candidate_cells[num_candidate_cells++] = c;
+        }
     }
+    output_search->num_candidate_cells = num_candidate_cells;
+    output_search->num_gain_evaluations = 0;
 
-    // ==================== 4 - FREE REMAINING RESOURCES ====== //
-    free(trace);
-    
     return 0;
 }
 
-int read_commandline_args(int argc, char **argv, struct_n_deployment_input *output_n_deployment_input, 
-char* output_input_file_path, char* output_error_msg)
+void free_swap_search(struct_swap_search *search)
+{
+    free(search->candidate_cells);
+    free(search->base_gain);
+    free(search->extra_gain);
+    free(search->touched_cells);
+    free(search->is_touched);
+    free(search->is_guiding);
+
+    search->candidate_cells = NULL;
+    search->base_gain = NULL;
+    search->extra_gain = NULL;
+    search->touched_cells = NULL;
+    search->is_touched = NULL;
+    search->is_guiding = NULL;
+}
+
+// Swap (r -> c) changes coverage by gain(c | S - r) - loss(r | S),
+// and gain(c | S - r) = gain(c | S) + extra_gain[c], where extra_gain only involves the vehicles reaching r;
+int swap_local_search(struct_swap_search *search, struct_coverage_state *coverage_state,
+struct_vehicle_cells_index *vehicle_cells, int *solution_cells, int solution_size,
+enum_local_search local_search, int max_moves)
 {
-    if (argc != 8)
+    int num_moves = 0;
+    while (max_moves == 0 || num_moves < max_moves)
     {
-        strcpy(output_error_msg, "wrong number of arguments");
-        return 1;
+        int k;
+        for (k = 0; k < search->num_candidate_cells; k++)
+        {
+            int c = search->candidate_cells[k];
+            search->base_gain[c] = gain_if_added(coverage_state, c);
+        }
+        search->num_gain_evaluations += search->num_candidate_cells;
+
+        int best_delta = 0;
+        int best_position = -1;
+        int best_cell = -1;
+        int i;
+        for (i = 0; i < solution_size && !(local_search == LOCAL_SEARCH_FIRST && best_position >= 0); i++)
+        {
+            int loss = loss_if_removed(coverage_state, solution_cells[i]);
+            int num_touched_cells = fill_extra_gains(search, coverage_state, vehicle_cells, solution_cells[i]);
+            search->num_gain_evaluations++;
+
+            for (k = 0; k < search->num_candidate_cells; k++)
+            {
+                int c = search->candidate_cells[k];
+                if (coverage_state->cell_num_rsus[c] > 0)
+                {
+                    continue;
+                }
+
+                int delta = search->base_gain[c] + search->extra_gain[c] - loss;
+                if (delta > best_delta)
+                {
+                    best_delta = delta;
+                    best_position = i;
+                    best_cell = c;
+
+                    if (local_search == LOCAL_SEARCH_FIRST)
+                    {
+                        break;
+                    }
+                }
+            }
+
+            for (k = 0; k < num_touched_cells; k++)
+            {
+                search->extra_gain[ search->touched_cells[k] ] = 0;
+                search->is_touched[ search->touched_cells[k] ] = 0;
+            }
+        }
+
+        if (best_position < 0)
+        {
+            break;
+        }
+
+        remove_rsu(coverage_state, solution_cells[best_position]);
+        add_rsu(coverage_state, best_cell);
+        solution_cells[best_position] = best_cell;
+        num_moves++;
     }
 
-    // ========== Try to convert all arguments to correct numeric values; ========== //
-    int status;
+    return num_moves;
+}
 
-    status = try_to_get_positive_int_from_arg(argv[1], "<num of rsus>", 
-    &(output_n_deployment_input->number_of_rsus), output_error_msg);
-    if (status != 0)
+int fill_extra_gains(struct_swap_search *search, struct_coverage_state *coverage_state,
+struct_vehicle_cells_index *vehicle_cells, int cell)
+{
+    // Another RSU stays at the cell, removing this one changes nothing;
+    if (cell == NO_CELL || coverage_state->cell_num_rsus[cell] != 1)
     {
-        return 1;
-    }
-    if (output_n_deployment_input->number_of_rsus > MAX_NUMBER_OF_RSUS)
-    {        
-        sprintf(output_error_msg, "number of RSUs must be at most %d", MAX_NUMBER_OF_RSUS);
-        return 1;
+        return 0;
     }
-    
-    status = try_to_get_positive_int_from_arg(argv[2], "<contacts time threshold>", 
-    &(output_n_deployment_input->contacts_time_threshold), output_error_msg);
-    if (status != 0)
+
+    struct_cell_vehicles_index* cell_vehicles = coverage_state->index;
+    int number_of_contacts = coverage_state->number_of_contacts;
+    int num_touched_cells = 0;
+    int e, f;
+    for (e = cell_vehicles->cell_offsets[cell]; e < cell_vehicles->cell_offsets[cell + 1]; e++)
     {
-        return 1;
+        int v = cell_vehicles->vehicle[e];
+        int contacts = coverage_state->num_of_contacts[v];
+        int contacts_without_cell = contacts - cell_vehicles->num_records[e];
+
+        for (f = vehicle_cells->vehicle_offsets[v]; f < vehicle_cells->vehicle_offsets[v + 1]; f++)
+        {
+            int c = vehicle_cells->cell[f];
+            int records = vehicle_cells->num_records[f];
+
+            int gain_with = (contacts < number_of_contacts) & (contacts + records >= number_of_contacts);
+            int gain_without = (contacts_without_cell < number_of_contacts)
+            & (contacts_without_cell + records >= number_of_contacts);
+            if (gain_with == gain_without)
+            {
+                continue;
+            }
+
+            if (!search->is_touched[c])
+            {
+                search->is_touched[c] = 1;
+                search->touched_cells[num_touched_cells++] = c;
+            }
+            search->extra_gain[c] += gain_without - gain_with;
+        }
     }
-    status = try_to_get_positive_int_from_arg(argv[3], "<GRASP's rcl length>", 
-    &(output_n_deployment_input->grasp_rcl_len), output_error_msg);
-    if (status != 0)
+
+    return num_touched_cells;
+}
+
+// Same swap deltas as swap_local_search(), over the cells to remove and the guide cells to add only;
+int path_relinking(struct_swap_search *search, struct_coverage_state *coverage_state,
+struct_vehicle_cells_index *vehicle_cells, int *path_cells, int solution_size,
+const int *guiding_cells, int *output_best_cells)
+{
+    int positions_to_remove[MAX_NUMBER_OF_RSUS];
+    int cells_to_add[MAX_NUMBER_OF_RSUS];
+    int num_to_remove = 0;
+    int num_to_add = 0;
+    int i, k;
+    // Padding RSUs (NO_CELL) are never added, and are removed like any cell out of the guide;
+    for (i = 0; i < solution_size; i++)
     {
-        return 1;
+        if (guiding_cells[i] != NO_CELL)
+        {
+            search->is_guiding[ guiding_cells[i] ] = 1;
+        }
     }
-    status = try_to_get_positive_int_from_arg(argv[4], "<n-deploy num iterations>", 
-    &(output_n_deployment_input->n_deploy_num_ite), output_error_msg);
-    if (status != 0)
+    for (i = 0; i < solution_size; i++)
     {
-        return 1;
+        if (path_cells[i] == NO_CELL || !search->is_guiding[ path_cells[i] ])
+        {
+            positions_to_remove[num_to_remove++] = i;
+        }
     }
-    status = try_to_get_positive_int_from_arg(argv[5], "<num of contacts>", 
-    &(output_n_deployment_input->number_of_contacts), output_error_msg);
-    if (status != 0)
+    // A cell repeated in the guide is added once;
+    for (i = 0; i < solution_size; i++)
     {
-        return 1;
+        int c = guiding_cells[i];
+        if (c != NO_CELL && search->is_guiding[c] == 1 && coverage_state->cell_num_rsus[c] == 0)
+        {
+            cells_to_add[num_to_add++] = c;
+            search->is_guiding[c] = 2;
+        }
     }
-    status = try_to_get_positive_int_from_arg(argv[6], "<GRASP's seed>", 
-    &(output_n_deployment_input->grasp_rng_seed), output_error_msg);
-    if (status != 0)
+    for (i = 0; i < solution_size; i++)
     {
-        return 1;
+        if (guiding_cells[i] != NO_CELL)
+        {
+            search->is_guiding[ guiding_cells[i] ] = 0;
+        }
     }
 
-    // ========== try to get input file path ========== //
-    if (strlen(argv[7]) > MAX_INPUT_FILE_PATH_SIZE)
+    // The last swap would reach the guide, which is already an elite solution;
+    int best_coverage = -1;
+    while (num_to_remove > 1 && num_to_add > 1)
     {
-        sprintf(output_error_msg, "file path is bigger than %d bytes", MAX_INPUT_FILE_PATH_SIZE);
-        return 1;
-    }
-    else {
+        for (k = 0; k < num_to_add; k++)
+        {
+            search->base_gain[ cells_to_add[k] ] = gain_if_added(coverage_state, cells_to_add[k]);
+        }
+        search->num_gain_evaluations += num_to_add;
 
-        strcpy(output_input_file_path, argv[7]);
+        int best_delta = 0;
+        int best_remove = -1;
+        int best_add = -1;
+        int r;
+        for (r = 0; r < num_to_remove; r++)
+        {
+            int cell = path_cells[ positions_to_remove[r] ];
+            int loss = loss_if_removed(coverage_state, cell);
+            int num_touched_cells = fill_extra_gains(search, coverage_state, vehicle_cells, cell);
+            search->num_gain_evaluations++;
+
+            for (k = 0; k < num_to_add; k++)
+            {
+                int c = cells_to_add[k];
+                int delta = search->base_gain[c] + search->extra_gain[c] - loss;
+                if (best_remove < 0 || delta > best_delta)
+                {
+                    best_delta = delta;
+                    best_remove = r;
+                    best_add = k;
+                }
+            }
+
+            for (k = 0; k < num_touched_cells; k++)
+            {
+                search->extra_gain[ search->touched_cells[k] ] = 0;
+                search->is_touched[ search->touched_cells[k] ] = 0;
+            }
+        }
+
+        int position = positions_to_remove[best_remove];
+        remove_rsu(coverage_state, path_cells[position]);
+        add_rsu(coverage_state, cells_to_add[best_add]);
+        path_cells[position] = cells_to_add[best_add];
+        positions_to_remove[best_remove] = positions_to_remove[--num_to_remove];
+        cells_to_add[best_add] = cells_to_add[--num_to_add];
+
+        int coverage = current_coverage(coverage_state);
+        if (coverage > best_coverage)
+        {
+            best_coverage = coverage;
+            memcpy(output_best_cells, path_cells, sizeof(int) * solution_size);
+        }
     }
 
-    return 0;
+    return best_coverage;
 }
 
-// Get int from command line argument;
-// IMPORTANT: Assumes int is big enough for converted value;
-int try_to_get_positive_int_from_arg(char* arg, char* var_name, int* output, 
+int init_elite_pool(int max_size, int solution_size, int num_cells, struct_elite_pool *output_pool,
 char* output_error_msg)
 {
-    int value = atoi(arg);
-    if (value <= 0)
+    output_pool->max_size = max_size;
+    output_pool->size = 0;
+    output_pool->solution_size = solution_size;
+    output_pool->solution_cells = (int*) malloc(sizeof(int) * (size_t) max_size * (size_t) solution_size);
+    output_pool->coverage = (int*) malloc(sizeof(int) * (size_t) max_size);
+    output_pool->is_marked = (unsigned char*) calloc((size_t) num_cells, sizeof(unsigned char));
+    if (!output_pool->solution_cells || !output_pool->coverage || !output_pool->is_marked)
     {
-        sprintf(output_error_msg, "%s must be a positive integer", var_name);
+        sprintf(output_error_msg, "can't allocate memory for an elite pool of %d solutions", max_size);
+        free_elite_pool(output_pool);
         return 1;
     }
 
-    *output = value;
-
     return 0;
 }
 
-// IMPORTANT: 
-// Assumes, for each vehicle, its trace is composed by adjacent lines,
-// int is big enough for every value, no line is bigger than 200 bytes,
-// and fields are integers separated only by ';' and line ends with ';';
-int read_trace(const char* trace_file_name, trace_line* output_trace, int *output_trace_size, 
-char* output_error_msg)
+void free_elite_pool(struct_elite_pool *pool)
 {
-    int num_seen_vehicles = 0;
-    int last_seen_vehicle_id = -1;
+    free(pool->solution_cells);
+    free(pool->coverage);
+    free(pool->is_marked);
 
-    FILE* f_stream = fopen(trace_file_name, "r");
+    pool->solution_cells = NULL;
+    pool->coverage = NULL;
+    pool->is_marked = NULL;
+}
 
-    if (f_stream == NULL)
+int update_elite_pool(struct_elite_pool *pool, const int *solution_cells, int coverage)
+{
+    int solution_size = pool->solution_size;
+    int i;
+    for (i = 0; i < solution_size; i++)
     {
-        sprintf(output_error_msg, "can't open file \"%s\"", trace_file_name);
-        return 1;
+        if (solution_cells[i] != NO_CELL)
+        {
+            pool->is_marked[ solution_cells[i] ] = 1;
+        }
     }
 
-    char line_buffer[201];
-    trace_line aux;
-    int num_read_lines = 0;
-    while (fgets(line_buffer, sizeof(line_buffer), f_stream) != NULL)
+    // Difference to an elite solution: its cells missing from the solution;
+    int min_difference = solution_size + 1;
+    int best_coverage = -1;
+    int replaced = -1;
+    int replaced_difference = solution_size + 1;
+    int e;
+    for (e = 0; e < pool->size; e++)
     {
-        if (num_read_lines == MAX_TRACE_SIZE)
-        {   
-            sprintf(output_error_msg, "file \"%s\" is too big (max is %d lines)", 
-            trace_file_name, MAX_TRACE_SIZE);
-            fclose(f_stream);
-            return 1;
+        const int* elite_cells = pool->solution_cells + (size_t) e * solution_size;
+        int difference = 0;
+        for (i = 0; i < solution_size; i++)
+        {
+            difference += (elite_cells[i] != NO_CELL) && !pool->is_marked[ elite_cells[i] ];
         }
 
-        sscanf(line_buffer, "%d;%d;%d;%d;%d;",
-        &(aux.vehicle_id), &(aux.time), &(aux.grid_x_pos), &(aux.grid_y_pos), &(aux.r));
-     
-        if (aux.vehicle_id != last_seen_vehicle_id)
+        if (difference < min_difference)
         {
-            num_seen_vehicles++;
-            last_seen_vehicle_id = aux.vehicle_id;
+            min_difference = difference;
         }
-
-        if (num_seen_vehicles > MAX_NUMBER_OF_VEHICLES)
-        {   
-            sprintf(output_error_msg, 
-            "file \"%s\" contains a vehicle with id equal or bigger than %d in line %d (limit is %d vehicles)",
-            trace_file_name, MAX_NUMBER_OF_VEHICLES - 1, num_read_lines + 1, MAX_NUMBER_OF_VEHICLES);
-            fclose(f_stream);
-            return 1;
+        if (pool->coverage[e] > best_coverage)
+        {
+            best_coverage = pool->coverage[e];
+        }
+        // Most similar among the worse ones;
+        if (pool->coverage[e] < coverage && difference < replaced_difference)
+        {
+            replaced = e;
+            replaced_difference = difference;
         }
+    }
 
-        if (!(
-            ((0 <= aux.grid_x_pos) && (aux.grid_x_pos < MAX_CELL_GRID_WIDTH)) && 
-            ((0 <= aux.grid_y_pos) && (aux.grid_y_pos < MAX_CELL_GRID_HEIGHT))
-            ))
+    for (i = 0; i < solution_size; i++)
+    {
+        if (solution_cells[i] != NO_CELL)
         {
-            sprintf(output_error_msg, 
-            "file \"%s\" contains a cell with coordinates out of bounds in line %d." 
-            " Allowed: (0 <= x < %d) (0 <= y < %d)", 
-            trace_file_name, num_read_lines + 1, MAX_CELL_GRID_WIDTH, MAX_CELL_GRID_HEIGHT);
-            fclose(f_stream);
-            return 1;
+            pool->is_marked[ solution_cells[i] ] = 0;
         }
+    }
 
-        output_trace[num_read_lines] = aux;
-        num_read_lines++;
+    int required_difference = solution_size * ELITE_POOL_MIN_DIFFERENCE / 100;
+    if (required_difference < 1 || coverage > best_coverage)
+    {
+        required_difference = 1;
+    }
+    if (min_difference < required_difference)
+    {
+        return 0;
     }
 
-    if (num_read_lines == 0)
+    if (pool->size < pool->max_size)
     {
-        sprintf(output_error_msg, "file \"%s\" is empty", trace_file_name);
-        fclose(f_stream);
-        return 1;
+        replaced = pool->size++;
+    }
+    else if (replaced < 0)
+    {
+        return 0;
     }
 
-    *output_trace_size = num_read_lines;
+    memcpy(pool->solution_cells + (size_t) replaced * solution_size, solution_cells, sizeof(int) * solution_size);
+    pool->coverage[replaced] = coverage;
 
-    fclose(f_stream);
-    return 0;
+    return 1;
 }
 
-void n_deployment(trace_line *trace, int trace_size, struct_n_deployment_input n_deployment_input, struct_n_deployment_output* output_n_deployment_output, FILE* best_coverage_log_file)
+int init_cells_scores(struct_cell_grid *grid, struct_n_deployment_input *n_deployment_input,
+char* output_error_msg)
 {
-    int coverage_best_solution = 0;
-
-    // Used to check itermediate solutions coverage (check_coverage());
-    int num_of_contacts[MAX_NUMBER_OF_VEHICLES];
-
-    // Used to build the intermediate solutions and then check their objective function values;
-	int cells[ MAX_CELL_GRID_WIDTH ][ MAX_CELL_GRID_HEIGHT ];
-
-    clock_t begin_timer = clock();
-    int iteration_index = 0;
-    srand(n_deployment_input.grasp_rng_seed);
-    for (iteration_index = 0; iteration_index < n_deployment_input.n_deploy_num_ite; iteration_index++)
-    {
-
-        pos_2d solution[MAX_NUMBER_OF_RSUS];
-		int solution_size = 0;
-
-		while (solution_size < n_deployment_input.number_of_rsus)
-		{
-		    // fill score for each urban cell
-            memcpy(&cells, &(n_deployment_input.cells), sizeof cells);
-	    
-		    // if cell has rsu, score goes to 0
-		    reset_score_of_cells_having_rsu(cells, solution, solution_size);
-
-		    // lets get the "rcl-len" best cells
-            pos_2d* rcl = (pos_2d*) malloc(n_deployment_input.grasp_rcl_len * sizeof(pos_2d));
-            int i = 0;
-		    for (; i < n_deployment_input.grasp_rcl_len; i++)
-			{
-				get_cell_with_highest_score(cells, &rcl[i].x, &rcl[i].y);
-			} 
-
-		    // pick random number between 0..rcl_len
-		    int selected = rand() % n_deployment_input.grasp_rcl_len;
-		    
-		    // add selected rsu to the solution
-		    solution[solution_size] = rcl[selected];
-		    solution_size++;
-
-            free(rcl);
-		}
-
-        int coverage = check_coverage(trace, trace_size, solution, solution_size, 
-        num_of_contacts, cells, 
-        n_deployment_input.contacts_time_threshold, n_deployment_input.number_of_contacts);
-		
-        // If current coverage is better, update best solution;
-		if (coverage > coverage_best_solution)
-		{
-			coverage_best_solution = coverage;
-
-            fprintf(best_coverage_log_file, "%d,%d\n", iteration_index, coverage);
-
-            int i = 0;
-            for (; i < solution_size; i++)
-            {
-                output_n_deployment_output->best_solution[i] = solution[i];
-            }
-		}
-	}
+    int status = copy_cell_grid(grid, &(n_deployment_input->grid), output_error_msg);
+    if (status != 0)
+    {
+        return 1;
+    }
 
-    clock_t end_timer = clock();
-    double execution_time_in_secs = (double) (end_timer - begin_timer) / CLOCKS_PER_SEC;
+    size_t num_cells = (size_t) grid->num_cells;
+    n_deployment_input->cells = (int*) malloc(sizeof(int) * num_cells);
+    n_deployment_input->ranked_cells = (int*) malloc(sizeof(int) * num_cells);
+    n_deployment_input->cell_rank = (int*) malloc(sizeof(int) * num_cells);
+    n_deployment_input->num_ranked_cells = 0;
+    if (!n_deployment_input->cells || !n_deployment_input->ranked_cells || !n_deployment_input->cell_rank)
+    {
+        sprintf(output_error_msg, "can't allocate memory for the scores of %d cells", grid->num_cells);
+        free_cells_scores(n_deployment_input);
+        return 1;
+    }
 
-    output_n_deployment_output->mean_ite_execution_time = 
-    execution_time_in_secs / n_deployment_input.n_deploy_num_ite;
-    
-    output_n_deployment_output->ite_execution_time = execution_time_in_secs;
+    return 0;
+}
 
-    output_n_deployment_output->best_solution_obj_f_value = coverage_best_solution;
+void free_cells_scores(struct_n_deployment_input *n_deployment_input)
+{
+    free(n_deployment_input->cells);
+    free(n_deployment_input->ranked_cells);
+    free(n_deployment_input->cell_rank);
+    free_cell_grid(&(n_deployment_input->grid));
+
+    n_deployment_input->cells = NULL;
+    n_deployment_input->ranked_cells = NULL;
+    n_deployment_input->cell_rank = NULL;
 }
 
-void fill_scores_in_cells(trace_line *trace, int tam, 
-int cells[ MAX_CELL_GRID_WIDTH ][ MAX_CELL_GRID_HEIGHT ], int time_interval, int number_of_contacts)
+void fill_scores_in_cells(struct_trace *trace, int tam, 
+int *cells, int time_interval, int number_of_contacts)
 {
-    reset_cells(cells);
+    reset_cells(cells, trace->grid.num_cells);
     int current_time = 0;
     int current_vehicle = -1;
 
 	int i;
     for (i = 0; i < tam; i++)
     {
-        if (current_vehicle == trace[i].vehicle_id)
+        if (current_vehicle == trace->vehicle_id[i])
         {
             // if the vehicle reaches the rsu within the given time threshold
             if (current_time <= time_interval)
             {
                 // viable location
                 {
-	                cells[ trace[i].grid_x_pos ][ trace[i].grid_y_pos ]+=1;
+	                cells[ trace->cell[i] ]+=1;
                     // if (cells[ trace[i].x ][ trace[i].y ] >= number_of_contacts)
 	                //    current_vehicle_is_covered = 1;
 				}
@@ -485,95 +2382,99 @@ int cells[ MAX_CELL_GRID_WIDTH ][ MAX_CELL_GRID_HEIGHT ], int time_interval, int
         else
         {
             current_time = 0;
-            current_vehicle = trace[i].vehicle_id;
-            cells[ trace[i].grid_x_pos ][ trace[i].grid_y_pos ]+=1;
+            current_vehicle = trace->vehicle_id[i];
+            cells[ trace->cell[i] ]+=1;
+        }
+        current_time = current_time + 10 * trace->r[i];
+    }
+}
+
+void fill_contact_scores_in_cells(struct_cell_vehicles_index *index,
+int *cells, int number_of_contacts)
+{
+    int c;
+    for (c = 0; c < index->num_cells; c++)
+    {
+        int score = 0;
+        int k;
+        for (k = index->cell_offsets[c]; k < index->cell_offsets[c + 1]; k++)
+        {
+            score += (index->num_records[k] < number_of_contacts) ? index->num_records[k] : number_of_contacts;
         }
-        current_time = current_time + 10 * trace[i].r;
+
+        cells[c] = score;
     }
 }
 
-void reset_cells(int cells[ MAX_CELL_GRID_WIDTH ][ MAX_CELL_GRID_HEIGHT ])
+pos_2d get_cell_position(const struct_cell_grid *grid, int cell)
 {
-	int i, j;
-    for (i = 0; i< MAX_CELL_GRID_WIDTH; i++)
-        for (j = 0; j < MAX_CELL_GRID_HEIGHT; j++)
-            cells[i][j]=0;
+    pos_2d position;
+    position.x = (cell == NO_CELL) ? 0 : grid->cell_x[cell];
+    position.y = (cell == NO_CELL) ? 0 : grid->cell_y[cell];
+
+    return position;
 }
 
-void reset_score_of_cells_having_rsu(int cells[ MAX_CELL_GRID_WIDTH ][ MAX_CELL_GRID_HEIGHT ], 
-pos_2d *solution, int solution_size)
+void reset_cells(int *cells, int num_cells)
 {
 	int i;
-	for (i = 0; i < solution_size; i++)
-	{
-		cells[ solution[i].x ][ solution[i].y ] = 0;
-	}
-}
-
-void get_cell_with_highest_score(int cells[ MAX_CELL_GRID_WIDTH ][ MAX_CELL_GRID_HEIGHT ], int *_x, int *_y)
-{
-	int max_x = 0;
-	int max_y = 0;
-	int i, j;
-	for (i = 0; i < MAX_CELL_GRID_WIDTH; i++)
-	{
-		for (j = 0; j < MAX_CELL_GRID_HEIGHT; j++)
-		{
-			if (cells[i][j] > cells[max_x][max_y])
-			{
-				max_x = i;
-				max_y = j;
-			}
-		}
-	}
-	
-	cells[max_x][max_y] = 0;
-	*_x = max_x;
-	*_y = max_y;
-}
-
-int check_coverage(trace_line *trace, int trace_size, pos_2d *solution, int solution_size, 
-int *num_of_contacts, int cells[MAX_CELL_GRID_WIDTH][MAX_CELL_GRID_HEIGHT],
-int time_interval, int number_of_contacts)
-{
-    reset_vehicles (num_of_contacts, MAX_NUMBER_OF_VEHICLES);
-    reset_cells(cells);
+    for (i = 0; i < num_cells; i++)
+        cells[i]=0;
+}
 
-    int i;
-    for (i = 0; i < solution_size; i++) cells[ solution[i].x ][ solution[i].y ] = 1;
-    
-	int start_time = -1;
-	int current_vehicle = -1;
-	for (i = 0; i < trace_size; i++)
-	{
-		if (current_vehicle == trace[i].vehicle_id)
-		{
-			// check if it is inside rsu
-			if ( cells[ trace[i].grid_x_pos ][ trace[i].grid_y_pos ] == 1 
-            && (trace[i].time <= (start_time + time_interval)) ) 
-			{
-				num_of_contacts[ trace[i].vehicle_id ] += 1;
-			}
-		}
-		else
-		{
-			current_vehicle = trace[i].vehicle_id;
-            start_time = trace[i].time;
-			i--;
-		}
-	}
-	
-	int covered = 0;
-	for (i = 0; i < MAX_NUMBER_OF_VEHICLES; i++)
-		if (num_of_contacts[i] >= number_of_contacts) covered++;
-	
-	return covered;
-}
-
-void reset_vehicles(int *vehicles, int tam)
+int rank_cells_by_score(int *cells, int num_cells,
+int *ranked_cells, int *cell_rank, int *output_num_ranked_cells,
+char* output_error_msg)
 {
-	int i;
-	for (i=0; i<tam; i++) vehicles[i]=0;
+    // (score, cell) pairs, sorted together;
+    int* ranking = (int*) malloc(sizeof(int) * 2 * (size_t) num_cells);
+    if (ranking == NULL)
+    {
+        sprintf(output_error_msg, "can't allocate memory to rank the cells");
+        return 1;
+    }
+
+    int num_ranked_cells = 0;
+    int c;
+    for (c = 0; c < num_cells; c++)
+    {
+        cell_rank[c] = -1;
+        if (cells[c] > 0)
+        {
+            ranking[2 * num_ranked_cells] = cells[c];
+            ranking[2 * num_ranked_cells + 1] = c;
+            num_ranked_cells++;
+        }
+    }
+
+    qsort(ranking, num_ranked_cells, 2 * sizeof(int), compare_ranked_cells);
+
+    int position;
+    for (position = 0; position < num_ranked_cells; position++)
+    {
+        ranked_cells[position] = ranking[2 * position + 1];
+        cell_rank[ ranked_cells[position] ] = position;
+    }
+
+    free(ranking);
+
+    *output_num_ranked_cells = num_ranked_cells;
+
+    return 0;
+}
+
+// Decreasing score, then increasing cell id (row-major order);
+int compare_ranked_cells(const void* a, const void* b)
+{
+    const int* cell_a = (const int*) a;
+    const int* cell_b = (const int*) b;
+
+    if (cell_a[0] != cell_b[0])
+    {
+        return (cell_a[0] > cell_b[0]) ? -1 : 1;
+    }
+
+    return (cell_a[1] > cell_b[1]) - (cell_a[1] < cell_b[1]);
 }
 
 int write_summary_to_file(
@@ -601,13 +2502,53 @@ int write_summary_to_file(
     fprintf(output_file, "CONTACTS TIME INTERVAL: %d\n", n_deployment_input.contacts_time_threshold);
 
     fprintf(output_file, "GRASP RNG SEED: %d\n", n_deployment_input.grasp_rng_seed);
+    fprintf(output_file, "GRASP RNG: %s\n", (n_deployment_input.grasp_rng == GRASP_RNG_LIBC) ? "libc" : "philox");
+    fprintf(output_file, "N-DEPLOY FIRST ITERATION: %d\n", n_deployment_input.first_iteration);
     fprintf(output_file, "N-DEPLOY N. ITERATIONS: %d\n", n_deployment_input.n_deploy_num_ite);
+    if (n_deployment_input.time_limit_in_secs > 0)
+    {
+        fprintf(output_file, "N-DEPLOY TIME LIMIT (S): %d\n", n_deployment_input.time_limit_in_secs);
+    }
+    if (n_deployment_input.target_coverage > 0)
+    {
+        fprintf(output_file, "N-DEPLOY TARGET COVERAGE: %d\n", n_deployment_input.target_coverage);
+    }
+    if (n_deployment_output.stop != GRASP_STOP_ITERATIONS
+    || n_deployment_input.time_limit_in_secs > 0 || n_deployment_input.target_coverage > 0)
+    {
+        fprintf(output_file, "N-DEPLOY N. ITERATIONS RUN: %d\n", n_deployment_output.num_iterations);
+        fprintf(output_file, "N-DEPLOY STOP: %s\n", get_grasp_stop_name(n_deployment_output.stop));
+    }
     fprintf(output_file, "GRASP RCL LENGTH: %d\n", n_deployment_input.grasp_rcl_len);
+    fprintf(output_file, "GRASP CELLS SCORING: %s\n",
+    (n_deployment_input.cell_scoring == CELL_SCORING_CONTACTS) ? "contacts" : "visits");
+    fprintf(output_file, "N. THREADS: %d\n", n_deployment_input.num_threads);
+    if (n_deployment_input.stream_chunk_size_in_mb > 0)
+    {
+        fprintf(output_file, "TRACE STREAM CHUNK SIZE (MB): %d\n", n_deployment_input.stream_chunk_size_in_mb);
+    }
 
     fprintf(output_file, "N-DEPLOY AVERAGE ITERATION EXECUTION TIME: %.06f\n", 
     n_deployment_output.mean_ite_execution_time);
-    fprintf(output_file, "N-DEPLOY TOTAL EXECUTION TIME (ITERATIONS): %.06f\n\n", 
+    fprintf(output_file, "N-DEPLOY TOTAL EXECUTION TIME (ITERATIONS): %.06f\n", 
     n_deployment_output.ite_execution_time);
+    fprintf(output_file, "PEAK RSS SO FAR (MB): %.1f\n", get_peak_rss_in_mb());
+
+    if (n_deployment_input.local_search != LOCAL_SEARCH_NONE)
+    {
+        fprintf(output_file, "LOCAL SEARCH: %s\n",
+        (n_deployment_input.local_search == LOCAL_SEARCH_FIRST) ? "first improvement" : "best improvement");
+        fprintf(output_file, "LOCAL SEARCH MAX MOVES PER ITERATION: %d\n", n_deployment_input.ls_max_moves);
+        fprintf(output_file, "LOCAL SEARCH N. MOVES: %lld\n", n_deployment_output.ls_num_moves);
+        fprintf(output_file, "LOCAL SEARCH TIME (ITERATIONS): %.06f\n", n_deployment_output.ls_execution_time);
+    }
+    if (n_deployment_input.elite_pool_size > 0)
+    {
+        fprintf(output_file, "ELITE POOL SIZE: %d\n", n_deployment_input.elite_pool_size);
+        fprintf(output_file, "PATH RELINKING N. IMPROVEMENTS: %lld\n", n_deployment_output.pr_num_improvements);
+        fprintf(output_file, "PATH RELINKING TIME (ITERATIONS): %.06f\n", n_deployment_output.pr_execution_time);
+    }
+    fprintf(output_file, "\n");
 
     fprintf(output_file, "-------------------- BEST SOLUTION ---------------------------\n\n");
 
@@ -648,3 +2589,61 @@ int write_rsus_to_file(
 
     return 0;
 }
+
+int write_coverage_by_tau_to_file(
+    FILE* coverage_by_tau_file,
+    struct_coverage_indexes *tau_indexes,
+    struct_n_deployment_input n_deployment_input, 
+    pos_2d* rsus_pos, int num_rsus,
+    char *output_error_msg
+)
+{
+    int num_taus = n_deployment_input.taus.num_budgets;
+    int solution_cells[MAX_NUMBER_OF_RSUS];
+    // Coverage of every prefix, only the whole solution is written;
+    int* curve = (int*) malloc(sizeof(int) * (size_t) num_rsus * num_taus);
+    if (curve == NULL)
+    {
+        sprintf(output_error_msg, "can't allocate memory for the coverage by tau of %d RSUs", num_rsus);
+        return 1;
+    }
+
+    int i, t;
+    for (i = 0; i < num_rsus; i++)
+    {
+        solution_cells[i] = get_cell_id(&(n_deployment_input.grid), rsus_pos[i].x, rsus_pos[i].y);
+    }
+
+    int status = fill_coverage_curve_by_tau(tau_indexes, n_deployment_input.number_of_contacts,
+    n_deployment_input.taus.budgets, num_taus, solution_cells, num_rsus, curve, output_error_msg);
+    if (status != 0)
+    {
+        free(curve);
+        return 1;
+    }
+
+    fprintf(coverage_by_tau_file, "%d", num_rsus);
+    for (t = 0; t < num_taus; t++)
+    {
+        fprintf(coverage_by_tau_file, ",%d", curve[(size_t) (num_rsus - 1) * num_taus + t]);
+    }
+    fprintf(coverage_by_tau_file, "\n");
+
+    free(curve);
+
+    return 0;
+}
+
+int write_n_deployment_metrics_to_file(
+    struct_n_deployment_input n_deployment_input, 
+    struct_run_metrics *metrics,
+    char *output_error_msg
+)
+{
+    char output_file_name[MAX_INPUT_FILE_PATH_SIZE + 250];
+    sprintf(output_file_name, "rsu=%d_tau=%d_rcl=%d_iter=%d_cont=%d_metrics.json", 
+    n_deployment_input.number_of_rsus, n_deployment_input.contacts_time_threshold, 
+    n_deployment_input.grasp_rcl_len, n_deployment_input.n_deploy_num_ite, n_deployment_input.number_of_contacts);
+
+    return write_metrics_to_file(output_file_name, "n-deployment", metrics, output_error_msg);
+}
@@ -4,50 +4,96 @@
 #include <assert.h>
 #include <time.h>
 
-#define MAX_CELL_GRID_WIDTH         100
-#define MAX_CELL_GRID_HEIGHT        100
+#include "../common_src/trace.h"
+#include "../common_src/coverage.h"
+#include "../common_src/coverage_bitset.h"
+#include "../common_src/coverage_stream.h"
+#include "../common_src/budgets.h"
+#include "../common_src/metrics.h"
 
-#define MAX_TRACE_SIZE              2200000
-#define MAX_NUMBER_OF_VEHICLES      80000
-// max solution size;
-#define MAX_NUMBER_OF_RSUS          1500
+#define MAX_NUMBER_OF_RSUS          MAX_SOLUTION_SIZE
 
 #define MAX_INPUT_FILE_PATH_SIZE    100
 
-typedef struct trace_ 
-{
-    int vehicle_id;
-    int time;
-    int grid_x_pos;
-    int grid_y_pos;
-    int r;
-
-} struct_trace;
+#define NUM_POSITIONAL_ARGS         4
 
 typedef struct solution_
 {
     int x;
     int y;
+    // Dense cell of (x, y), see struct_cell_grid;
+    int cell;
 
 } struct_solution;
 
+// How the next RSU is chosen (--strategy);
+typedef enum greedy_strategy_
+{
+    // Cell with the highest visit count, computed once from the trace;
+    GREEDY_STRATEGY_STATIC,
+    // Cell covering the most still uncovered vehicles, re-evaluated lazily (CELF);
+    GREEDY_STRATEGY_CELF
+
+} enum_greedy_strategy;
+
 typedef struct greedy_input_ 
 {
     int number_of_rsus;
     int number_of_contacts;
     int contacts_time_threshold;
 
+    // How the solution is evaluated (--eval-kernel);
+    enum_coverage_kernel eval_kernel;
+
+    enum_greedy_strategy strategy;
+
+    // Sweep mode (--budgets): every budget is solved in turn instead of <num of rsus>;
+    int is_sweep;
+    struct_budgets budgets;
+
+    // Thresholds of the coverage curve (--tau), <contacts time threshold> alone by default;
+    struct_budgets taus;
+
+    // Trace reduced in chunks of about this many MB instead of read whole (--stream), 0 to read it whole;
+    int stream_chunk_size_in_mb;
+
+    // Frequented cells of the trace;
+    struct_cell_grid grid;
+
+    // Static strategy: visit counts of the dense cells, computed once for all budgets;
+    int *cells_scores;
+    // Wall clock and CPU time of computing them (static) or of building the coverage index (CELF),
+    // added to the time of every budget (0 with --stream, where they come with the reduced trace);
+    double scoring_execution_time;
+    double scoring_cpu_time;
+
 } struct_greedy_input;
 
 typedef struct greedy_output_
 {
+    // Wall clock and CPU time of scoring (cells scores, or the coverage index with CELF), picking and evaluating;
     double total_execution_time;
+    double cpu_execution_time;
     int solution_size;
     struct_solution solution[MAX_NUMBER_OF_RSUS];
     int solution_obj_f_value;
 
+    // CELF only: vehicles newly covered by each RSU, in order of choice,
+    // and number of marginal gains computed (initial ones included);
+    int marginal_gain[MAX_NUMBER_OF_RSUS];
+    long long num_gain_evaluations;
+
 } struct_greedy_output;
 
+// Entry of the CELF priority queue: gain of the cell computed when the solution had gain_round RSUs;
+typedef struct celf_candidate_
+{
+    int gain;
+    int cell;
+    int gain_round;
+
+} struct_celf_candidate;
+
 // ==================== INPUT FUNCTIONS ==================== //
 // If succeedes, returns 0 and output_baseline_input can be used;
 // Otherwise, returns 1 and error_msg can be used;
@@ -63,48 +109,83 @@ int try_to_get_positive_int_from_arg(
     char* output_error_msg
 );
 
-// If succeedes, returns 0 and output_trace and output_trace_size can be used;
+// Options are "--name value" pairs accepted anywhere among the positional arguments;
+// If succeedes, returns 0 and the option's value is stored in output_greedy_input;
 // Otherwise, returns 1 and error_msg can be used;
-int read_trace(
-    const char* trace_file_name, 
-    struct_trace *output_trace, int *output_trace_size, 
+int read_commandline_option(
+    char* name, char* value,
+    struct_greedy_input *output_greedy_input,
     char* output_error_msg
 );
 // ==================== INPUT FUNCTIONS ==================== //
 
 
 // ==================== GREEDY FUNTCIONS ================= //
-void greedy(
-    struct_trace* trace, int trace_size, 
+// Picking and evaluating times are added to the construct and evaluate phases of metrics;
+// If succeedes, returns 0 and output_greedy_output can be used;
+// Otherwise, returns 1 and error_msg can be used;
+int greedy(
+    struct_coverage_indexes *indexes,
+    struct_cell_bitsets *bitsets,
     struct_greedy_input greedy_input,
-    struct_greedy_output* output_greedy_output
+    struct_greedy_output* output_greedy_output,
+    struct_run_metrics *metrics,
+    char* output_error_msg
 );
 
+// Picks the solution RSU by RSU, by marginal gain in covered vehicles, without evaluating it;
+// Gains of earlier rounds are upper bounds of the current ones (coverage is submodular with 1 contact),
+// so a candidate is only recomputed when it reaches the top of the queue with an outdated gain;
+// If succeedes, returns 0 and output_greedy_output's solution and marginal gains can be used;
+// Otherwise, returns 1 and error_msg can be used;
+int celf_greedy(
+    struct_coverage_indexes *indexes,
+    struct_greedy_input greedy_input,
+    struct_greedy_output* output_greedy_output,
+    char* output_error_msg
+);
+
+// Max-heap order: higher gain first, then lower cell id (same tie break as the static greedy);
+int celf_candidate_precedes(struct_celf_candidate a, struct_celf_candidate b);
+
+void celf_sift_down(struct_celf_candidate *heap, int heap_size, int position);
+
 int get_num_frequented_cells(
-    int matrix[MAX_CELL_GRID_WIDTH][MAX_CELL_GRID_HEIGHT]
+    int *matrix, int num_cells
 );
 
 void fill_scores_in_cells(
     struct_trace *trace, 
-    int tam, int cells[ MAX_CELL_GRID_WIDTH ][ MAX_CELL_GRID_HEIGHT ], 
+    int tam, int *cells, 
     int time_interval, int number_of_contacts
 );
 
-void reset_cells(int cells[ MAX_CELL_GRID_WIDTH ][ MAX_CELL_GRID_HEIGHT ]);
+void reset_cells(int *cells, int num_cells);
 
-void get_max_cell_coords_and_zero_it(
-    int matrix[MAX_CELL_GRID_WIDTH][MAX_CELL_GRID_HEIGHT], 
-    int *output_x_coord, int* output_y_coord
+// Cells are scanned in row-major order, so ties go to the first (x, y) as in the grid scan;
+int get_max_cell_and_zero_it(
+    int *matrix, int num_cells
 );
 
 int check_coverage(
-    struct_trace *trace, int trace_size, 
+    struct_vehicle_cells_index *index, 
     struct_solution *solution, int solution_size, 
-    int *num_of_contacts, int cells[MAX_CELL_GRID_WIDTH][MAX_CELL_GRID_HEIGHT],
-    int time_interval, int number_of_contacts
+    unsigned char *cell_has_rsu, 
+    int number_of_contacts
 );
 
-void reset_vehicles(int *vehicles, int tam);
+// Same result as check_coverage() with the given kernel, bitsets are only read by the bitset kernels;
+// If succeedes, returns 0 and output_coverage can be used;
+// Otherwise, returns 1 and error_msg can be used;
+int evaluate_solution(
+    enum_coverage_kernel eval_kernel,
+    struct_coverage_indexes *indexes,
+    struct_cell_bitsets *bitsets,
+    struct_solution *solution, int solution_size,
+    int number_of_contacts,
+    int *output_coverage,
+    char* output_error_msg
+);
 // ==================== GREEDY FUNCTIONS ================= //
 
 
@@ -117,6 +198,28 @@ int write_rsus_to_file(
     struct_solution* rsus_pos, int num_rsus,
     char *output_error_msg
 );
+
+int write_marginal_gains_to_file(
+    struct_greedy_input greedy_input, 
+    struct_greedy_output* greedy_output,
+    char *output_error_msg
+);
+
+// Solutions of smaller budgets are prefixes of this one, so the file gives the coverage of every budget
+// up to the solution size; coverage is counted on curve_indexes;
+int write_coverage_curve_to_file(
+    struct_greedy_input greedy_input, 
+    struct_greedy_output* greedy_output,
+    struct_coverage_indexes *curve_indexes,
+    char *output_error_msg
+);
+
+// Per phase wall and CPU times and counters of the run, named as the summary file;
+int write_greedy_metrics_to_file(
+    struct_greedy_input greedy_input,
+    struct_run_metrics *metrics,
+    char *output_error_msg
+);
 // ==================== OUTPUT FUNCTIONS ==================== //
 
 
@@ -130,7 +233,10 @@ int main(int argc, char** argv)
     // ==================== 1 - READ INPUT ==================== //
 
     const char* correct_input_format = "USAGE: greedy <num of rsus>"
-    " <contacts time threshold> <num of contacts> <trace file path>";
+    " <contacts time threshold> <num of contacts> <trace file path>"
+    " [--eval-kernel auto|incremental|index|contacts|bitset|bitset-scalar|bitset-avx2|bitset-neon]"
+    " [--strategy static|celf] [--budgets <min:max:step or list b1,b2,...> in place of <num of rsus>]"
+    " [--tau <curve thresholds, min:max:step or list t1,t2,...>] [--stream <chunk size in MB>]";
 
     // -------------------- 1.1 COMMAND LINE ------------------ //
 
@@ -142,81 +248,449 @@ int main(int argc, char** argv)
     {
         fprintf(stderr, "GREEDY: COMMAND LINE ERROR: %s\n\n%s\n", 
         error_msg, correct_input_format);
+        free_budgets(&(greedy_input.budgets));
+        free_budgets(&(greedy_input.taus));
         return 1;
     }
 
     // -------------------- 1.2 TRACE FILE -------------------- //
 
-    struct_trace *trace = (struct_trace *) malloc(sizeof(struct_trace) * MAX_TRACE_SIZE);
-    if (!trace)
+    // The coverage curve counts contacts up to (first record time + threshold) included,
+    // as n-deployment and results1 do, so the curves of all solvers compare;
+    // One index up to the biggest threshold scores all of them;
+    int max_tau = 0;
+    int t;
+    for (t = 0; t < greedy_input.taus.num_budgets; t++)
     {
-        fprintf(stderr, "GREEDY: MEMORY ERROR: can't allocate memory"
-        " for %d trace lines (MAX_TRACE_SIZE)\n", MAX_TRACE_SIZE);
-        return 1;
+        if (greedy_input.taus.budgets[t] > max_tau)
+        {
+            max_tau = greedy_input.taus.budgets[t];
+        }
     }
 
-    int trace_size;
-    status = read_trace(input_file_path, trace, &trace_size, error_msg);
-    if (status != 0)
+    struct_run_metrics metrics;
+    init_run_metrics(&metrics);
+    greedy_input.scoring_execution_time = 0;
+    greedy_input.scoring_cpu_time = 0;
+
+    // Greedy counts contacts strictly before (first record time + threshold), so the index
+    // keeps records with time <= (first record time + threshold - 1);
+    struct_coverage_indexes indexes;
+    struct_coverage_indexes curve_indexes;
+    struct_trace_read_stats trace_read_stats;
+    begin_metrics_phase(&metrics, METRICS_PHASE_LOAD);
+    if (greedy_input.stream_chunk_size_in_mb > 0)
     {
-        fprintf(stderr, "GREEDY: INPUT TRACE FILE ERROR: %s\n", error_msg);
-        free(trace);
-        return 1;
+        // The trace is reduced chunk by chunk, it's never whole in memory;
+        struct_reduced_trace reduced_trace;
+        int time_intervals[MAX_REDUCED_TRACE_INDEXES] = { greedy_input.contacts_time_threshold - 1, max_tau };
+        status = reduce_trace_in_chunks(input_file_path, (size_t) greedy_input.stream_chunk_size_in_mb * 1000000,
+        greedy_input.contacts_time_threshold, time_intervals, 2, &reduced_trace, &trace_read_stats, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "GREEDY: INPUT TRACE FILE ERROR: %s\n", error_msg);
+            free_budgets(&(greedy_input.budgets));
+            free_budgets(&(greedy_input.taus));
+            return 1;
+        }
+
+        printf("GREEDY: TRACE FILE: %lld lines, %.1f MB %s reduced in %d chunks of up to %d lines in %.3f s (%.1f MB/s)\n",
+        reduced_trace.size, trace_read_stats.file_size_in_bytes / 1e6,
+        trace_read_stats.is_binary_format ? "binary" : "text", reduced_trace.num_chunks, reduced_trace.max_chunk_size,
+        trace_read_stats.read_time_in_secs, trace_read_stats.throughput_in_mb_per_sec);
+
+        // Everything the solver needs is taken, the rest of the reduced trace goes;
+        greedy_input.grid = reduced_trace.grid;
+        greedy_input.cells_scores = reduced_trace.cell_visits;
+        indexes = reduced_trace.indexes[0];
+        curve_indexes = reduced_trace.indexes[1];
+        free(reduced_trace.cell_records);
+        end_metrics_phase(&metrics, METRICS_PHASE_LOAD);
+        add_metrics_counter(&metrics, METRICS_COUNTER_RECORDS_SCANNED, reduced_trace.size);
+        begin_metrics_phase(&metrics, METRICS_PHASE_INDEX);
     }
+    else
+    {
+        struct_trace trace;
+        status = read_trace(input_file_path, &trace, &trace_read_stats, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "GREEDY: INPUT TRACE FILE ERROR: %s\n", error_msg);
+            free_budgets(&(greedy_input.budgets));
+            free_budgets(&(greedy_input.taus));
+            return 1;
+        }
 
-    // ==================== 2 - RUN =========================== //
+        printf("GREEDY: TRACE FILE: %d lines, %.1f MB %s read in %.3f s (%.1f MB/s)\n",
+        trace.size, trace_read_stats.file_size_in_bytes / 1e6,
+        trace_read_stats.is_binary_format ? "binary" : "text",
+        trace_read_stats.read_time_in_secs, trace_read_stats.throughput_in_mb_per_sec);
+        end_metrics_phase(&metrics, METRICS_PHASE_LOAD);
+        add_metrics_counter(&metrics, METRICS_COUNTER_RECORDS_SCANNED, trace.size);
+        begin_metrics_phase(&metrics, METRICS_PHASE_INDEX);
+
+        greedy_input.cells_scores = (int*) malloc(sizeof(int) * (size_t) trace.grid.num_cells);
+        status = (greedy_input.cells_scores == NULL) ? 1 : copy_cell_grid(&(trace.grid), &(greedy_input.grid), error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "GREEDY: MEMORY ERROR: can't allocate memory for the scores of %d cells\n", trace.grid.num_cells);
+            free(greedy_input.cells_scores);
+            free_trace(&trace);
+            free_budgets(&(greedy_input.budgets));
+            free_budgets(&(greedy_input.taus));
+            return 1;
+        }
 
-    struct_greedy_output greedy_output;
-    greedy(trace, trace_size, greedy_input, &greedy_output);
+        // Static greedy picks by the cells scores, CELF by the gains on the coverage index,
+        // so each strategy's time includes the scoring it needs;
+        struct_metrics_timer scoring_timer;
+        if (greedy_input.strategy == GREEDY_STRATEGY_STATIC)
+        {
+            start_metrics_timer(&scoring_timer);
+            fill_scores_in_cells(
+                &trace, trace.size, greedy_input.cells_scores, 
+                greedy_input.contacts_time_threshold, 
+                greedy_input.number_of_contacts);
+            read_metrics_timer(&scoring_timer, &(greedy_input.scoring_execution_time), &(greedy_input.scoring_cpu_time));
+        }
 
-    // ==================== 3 - WRITE RESULTS ================= //
+        start_metrics_timer(&scoring_timer);
+        status = build_coverage_indexes(&trace, greedy_input.contacts_time_threshold - 1, &indexes, error_msg);
+        if (greedy_input.strategy == GREEDY_STRATEGY_CELF)
+        {
+            read_metrics_timer(&scoring_timer, &(greedy_input.scoring_execution_time), &(greedy_input.scoring_cpu_time));
+        }
+        if (status != 0)
+        {
+            fprintf(stderr, "GREEDY: MEMORY ERROR: %s\n", error_msg);
+            free_trace(&trace);
+            free(greedy_input.cells_scores);
+            free_cell_grid(&(greedy_input.grid));
+            free_budgets(&(greedy_input.budgets));
+            free_budgets(&(greedy_input.taus));
+            return 1;
+        }
 
-    status = write_summary_to_file(greedy_input, greedy_output, error_msg);
-    if (status != 0)
+        status = build_coverage_indexes(&trace, max_tau, &curve_indexes, error_msg);
+        free_trace(&trace);
+        if (status != 0)
+        {
+            fprintf(stderr, "GREEDY: MEMORY ERROR: %s\n", error_msg);
+            free_coverage_indexes(&indexes);
+            free(greedy_input.cells_scores);
+            free_cell_grid(&(greedy_input.grid));
+            free_budgets(&(greedy_input.budgets));
+            free_budgets(&(greedy_input.taus));
+            return 1;
+        }
+    }
+
+    // Bitsets only answer "reaches at least one RSU cell", i.e. 1 contact;
+    if (greedy_input.eval_kernel == COVERAGE_KERNEL_AUTO)
     {
-        fprintf(stderr, "GREEDY: OUTPUT SUMMARY FILE ERROR: %s\n", error_msg);
-        free(trace);
+        if (greedy_input.number_of_contacts == 1)
+        {
+            greedy_input.eval_kernel = get_best_bitset_kernel();
+        }
+        else
+        {
+            greedy_input.eval_kernel = (greedy_input.number_of_contacts <= MAX_SATURATING_CONTACTS) ?
+            COVERAGE_KERNEL_CONTACTS : COVERAGE_KERNEL_INDEX;
+        }
+    }
+    else if (is_bitset_kernel(greedy_input.eval_kernel) && greedy_input.number_of_contacts != 1)
+    {
+        fprintf(stderr, "GREEDY: COMMAND LINE ERROR: evaluation kernel %s needs <num of contacts> = 1\n",
+        get_coverage_kernel_name(greedy_input.eval_kernel));
+        free_coverage_indexes(&indexes);
+        free(greedy_input.cells_scores);
+        free_cell_grid(&(greedy_input.grid));
+        free_coverage_indexes(&curve_indexes);
+        free_budgets(&(greedy_input.budgets));
+        free_budgets(&(greedy_input.taus));
         return 1;
     }
-
-    status = write_rsus_to_file(
-        greedy_input, greedy_output.solution, 
-        greedy_output.solution_size, error_msg);
-    if (status != 0)
+    else if (greedy_input.eval_kernel == COVERAGE_KERNEL_CONTACTS
+    && greedy_input.number_of_contacts > MAX_SATURATING_CONTACTS)
     {
-        fprintf(stderr, "GREEDY: OUTPUT RSUS FILE ERROR: %s\n", error_msg);
-        free(trace);
+        fprintf(stderr, "GREEDY: COMMAND LINE ERROR: evaluation kernel contacts needs <num of contacts> <= %d\n",
+        MAX_SATURATING_CONTACTS);
+        free_coverage_indexes(&indexes);
+        free(greedy_input.cells_scores);
+        free_cell_grid(&(greedy_input.grid));
+        free_coverage_indexes(&curve_indexes);
+        free_budgets(&(greedy_input.budgets));
+        free_budgets(&(greedy_input.taus));
         return 1;
     }
 
-    // ==================== 4 - FREE REMAINING RESOURCES ====== //
-    free(trace);
+    printf("GREEDY: EVALUATION KERNEL: %s\n", get_coverage_kernel_name(greedy_input.eval_kernel));
+
+    struct_cell_bitsets bitsets;
+    bitsets.cell_row = NULL;
+    bitsets.words = NULL;
+    if (is_bitset_kernel(greedy_input.eval_kernel))
+    {
+        status = build_cell_bitsets(&indexes, &bitsets, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "GREEDY: MEMORY ERROR: %s\n", error_msg);
+            free_coverage_indexes(&indexes);
+            free(greedy_input.cells_scores);
+            free_cell_grid(&(greedy_input.grid));
+            free_coverage_indexes(&curve_indexes);
+            free_budgets(&(greedy_input.budgets));
+            free_budgets(&(greedy_input.taus));
+            return 1;
+        }
+    }
+    end_metrics_phase(&metrics, METRICS_PHASE_INDEX);
+
+    // ==================== 2 - RUN AND WRITE RESULTS ============ //
+
+    // Sweep table: one line per budget;
+    FILE* sweep_file = NULL;
+    if (greedy_input.is_sweep)
+    {
+        char sweep_file_name[MAX_BUDGETS_LABEL_SIZE + 100];
+        sprintf(sweep_file_name, "rsu=%s_tau=%d_cont=%d_sweep.csv", greedy_input.budgets.label,
+        greedy_input.contacts_time_threshold, greedy_input.number_of_contacts);
+
+        sweep_file = fopen(sweep_file_name, "w");
+        if (sweep_file == NULL)
+        {
+            fprintf(stderr, "GREEDY: OUTPUT SWEEP FILE ERROR: can't write sweep file\n");
+            free_coverage_indexes(&indexes);
+            free(greedy_input.cells_scores);
+            free_cell_grid(&(greedy_input.grid));
+            free_coverage_indexes(&curve_indexes);
+            free_cell_bitsets(&bitsets);
+            free_budgets(&(greedy_input.budgets));
+            free_budgets(&(greedy_input.taus));
+            return 1;
+        }
+        fprintf(sweep_file, "budget,n_rsus,obj_f_value,execution_time,cpu_time,sweep_wall_clock_time\n");
+    }
+
+    struct timespec sweep_begin_timer;
+    clock_gettime(CLOCK_MONOTONIC, &sweep_begin_timer);
+
+    // Too big for the stack;
+    struct_greedy_output* greedy_output = (struct_greedy_output*) malloc(sizeof(struct_greedy_output));
+    if (greedy_output == NULL)
+    {
+        fprintf(stderr, "GREEDY: MEMORY ERROR: can't allocate memory for the output\n");
+        status = 1;
+    }
+
+    int num_budgets = greedy_input.is_sweep ? greedy_input.budgets.num_budgets : 1;
+    int b;
+
+    // Smaller solutions are prefixes of the biggest one, so only its coverage curve is written;
+    int curve_budget = greedy_input.number_of_rsus;
+    if (greedy_input.is_sweep)
+    {
+        curve_budget = 0;
+        for (b = 0; b < num_budgets; b++)
+        {
+            if (greedy_input.budgets.budgets[b] > curve_budget)
+            {
+                curve_budget = greedy_input.budgets.budgets[b];
+            }
+        }
+    }
+
+    for (b = 0; b < num_budgets && status == 0; b++)
+    {
+        if (greedy_input.is_sweep)
+        {
+            greedy_input.number_of_rsus = greedy_input.budgets.budgets[b];
+        }
+
+        // Each budget gets the shared load and index phases, as a run with that budget would;
+        struct_run_metrics budget_metrics = metrics;
+
+        status = greedy(&indexes, &bitsets, greedy_input, greedy_output, &budget_metrics, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "GREEDY: MEMORY ERROR: %s\n", error_msg);
+            break;
+        }
+
+        begin_metrics_phase(&budget_metrics, METRICS_PHASE_OUTPUT);
+        status = write_summary_to_file(greedy_input, *greedy_output, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "GREEDY: OUTPUT SUMMARY FILE ERROR: %s\n", error_msg);
+            break;
+        }
+
+        status = write_rsus_to_file(
+            greedy_input, greedy_output->solution, 
+            greedy_output->solution_size, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "GREEDY: OUTPUT RSUS FILE ERROR: %s\n", error_msg);
+            break;
+        }
+
+        if (greedy_input.number_of_rsus == curve_budget)
+        {
+            status = write_coverage_curve_to_file(greedy_input, greedy_output, &curve_indexes, error_msg);
+            if (status != 0)
+            {
+                fprintf(stderr, "GREEDY: OUTPUT CURVE FILE ERROR: %s\n", error_msg);
+                break;
+            }
+            // Once, even if the biggest budget is listed twice;
+            curve_budget = 0;
+        }
+
+        if (greedy_input.strategy == GREEDY_STRATEGY_CELF)
+        {
+            status = write_marginal_gains_to_file(greedy_input, greedy_output, error_msg);
+            if (status != 0)
+            {
+                fprintf(stderr, "GREEDY: OUTPUT GAINS FILE ERROR: %s\n", error_msg);
+                break;
+            }
+        }
+        end_metrics_phase(&budget_metrics, METRICS_PHASE_OUTPUT);
+
+        status = write_greedy_metrics_to_file(greedy_input, &budget_metrics, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "GREEDY: OUTPUT METRICS FILE ERROR: %s\n", error_msg);
+            break;
+        }
+
+        if (greedy_input.is_sweep)
+        {
+            struct timespec sweep_timer;
+            clock_gettime(CLOCK_MONOTONIC, &sweep_timer);
+
+            fprintf(sweep_file, "%d,%d,%d,%.06f,%.06f,%.06f\n", greedy_input.number_of_rsus,
+            greedy_output->solution_size, greedy_output->solution_obj_f_value,
+            greedy_output->total_execution_time, greedy_output->cpu_execution_time,
+            (sweep_timer.tv_sec - sweep_begin_timer.tv_sec) + (sweep_timer.tv_nsec - sweep_begin_timer.tv_nsec) / 1e9);
+        }
+    }
+
+    if (greedy_input.is_sweep)
+    {
+        if (status == 0)
+        {
+            struct timespec sweep_end_timer;
+            clock_gettime(CLOCK_MONOTONIC, &sweep_end_timer);
+
+            printf("GREEDY: SWEEP: %d budgets solved in %.3f s\n", num_budgets,
+            (sweep_end_timer.tv_sec - sweep_begin_timer.tv_sec) + (sweep_end_timer.tv_nsec - sweep_begin_timer.tv_nsec) / 1e9);
+        }
+
+        fclose(sweep_file);
+        free_budgets(&(greedy_input.budgets));
+    }
+
+    printf("GREEDY: PEAK RSS: %.1f MB\n", get_peak_rss_in_mb());
+
+    // ==================== 3 - FREE REMAINING RESOURCES ====== //
+    free(greedy_output);
+    free_coverage_indexes(&indexes);
+    free(greedy_input.cells_scores);
+    free_cell_grid(&(greedy_input.grid));
+    free_coverage_indexes(&curve_indexes);
+    free_cell_bitsets(&bitsets);
+    free_budgets(&(greedy_input.taus));
     
-    return 0;
+    return status;
 }
 
 int read_commandline_args(int argc, char **argv, struct_greedy_input *output_greedy_input, 
 char* output_input_file_path, char* output_error_msg)
 {
-    if (argc != 5)
+    int status;
+
+    // ========== Split options from positional arguments; ========== //
+    output_greedy_input->eval_kernel = COVERAGE_KERNEL_AUTO;
+    output_greedy_input->strategy = GREEDY_STRATEGY_STATIC;
+    output_greedy_input->is_sweep = 0;
+    // Without --budgets nothing is allocated, free_budgets() still applies;
+    output_greedy_input->budgets.num_budgets = 0;
+    output_greedy_input->budgets.budgets = NULL;
+    output_greedy_input->taus.num_budgets = 0;
+    output_greedy_input->taus.budgets = NULL;
+    output_greedy_input->stream_chunk_size_in_mb = 0;
+
+    // argv-like: program name, then the positional arguments in order;
+    char* positional_args[NUM_POSITIONAL_ARGS + 1];
+    positional_args[0] = argv[0];
+    int num_positional_args = 0;
+    int i;
+    for (i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--", 2) == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                sprintf(output_error_msg, "option %s needs a value", argv[i]);
+                return 1;
+            }
+
+            status = read_commandline_option(argv[i], argv[i + 1], output_greedy_input, output_error_msg);
+            if (status != 0)
+            {
+                return 1;
+            }
+            i++;
+        }
+        else if (num_positional_args < NUM_POSITIONAL_ARGS)
+        {
+            positional_args[++num_positional_args] = argv[i];
+        }
+        else
+        {
+            strcpy(output_error_msg, "wrong number of arguments");
+            return 1;
+        }
+    }
+
+    // In sweep mode, --budgets takes the place of <num of rsus>;
+    if (output_greedy_input->is_sweep)
+    {
+        if (num_positional_args != NUM_POSITIONAL_ARGS - 1)
+        {
+            strcpy(output_error_msg, "wrong number of arguments");
+            return 1;
+        }
+
+        for (i = NUM_POSITIONAL_ARGS; i > 1; i--)
+        {
+            positional_args[i] = positional_args[i - 1];
+        }
+        positional_args[1] = NULL;
+    }
+    else if (num_positional_args != NUM_POSITIONAL_ARGS)
     {
         strcpy(output_error_msg, "wrong number of arguments");
         return 1;
     }
+    argv = positional_args;
 
     // ========== Try to convert all arguments to correct numeric values; ========== //
-    int status;
 
-    status = try_to_get_positive_int_from_arg(argv[1], "<num of rsus>", 
-    &(output_greedy_input->number_of_rsus), output_error_msg);
-    if (status != 0)
+    if (!output_greedy_input->is_sweep)
     {
-        return 1;
-    }
-    if (output_greedy_input->number_of_rsus > MAX_NUMBER_OF_RSUS)
-    {        
-        sprintf(output_error_msg, "number of RSUs must be at most %d", MAX_NUMBER_OF_RSUS);
-        return 1;
+        status = try_to_get_positive_int_from_arg(argv[1], "<num of rsus>", 
+        &(output_greedy_input->number_of_rsus), output_error_msg);
+        if (status != 0)
+        {
+            return 1;
+        }
+        if (output_greedy_input->number_of_rsus > MAX_NUMBER_OF_RSUS)
+        {        
+            sprintf(output_error_msg, "number of RSUs must be at most %d", MAX_NUMBER_OF_RSUS);
+            return 1;
+        }
     }
     
     status = try_to_get_positive_int_from_arg(argv[2], "<contacts time threshold>", 
@@ -233,6 +707,23 @@ char* output_input_file_path, char* output_error_msg)
         return 1;
     }
 
+    if (output_greedy_input->taus.num_budgets == 0)
+    {
+        char tau_spec[20];
+        sprintf(tau_spec, "%d", output_greedy_input->contacts_time_threshold);
+        status = parse_taus(tau_spec, output_greedy_input->contacts_time_threshold, 
+        &(output_greedy_input->taus), output_error_msg);
+        if (status != 0)
+        {
+            return 1;
+        }
+    }
+    else if (output_greedy_input->taus.num_budgets > 1 && output_greedy_input->number_of_contacts != 1)
+    {
+        strcpy(output_error_msg, "a list of --tau thresholds needs <num of contacts> = 1");
+        return 1;
+    }
+
     // ========== try to get input file path ========== //
     if (strlen(argv[4]) > MAX_INPUT_FILE_PATH_SIZE)
     {
@@ -247,6 +738,72 @@ char* output_input_file_path, char* output_error_msg)
     return 0;
 }
 
+int read_commandline_option(char* name, char* value,
+struct_greedy_input *output_greedy_input, char* output_error_msg)
+{
+    if (strcmp(name, "--eval-kernel") == 0)
+    {
+        return get_coverage_kernel_from_name(value, &(output_greedy_input->eval_kernel), output_error_msg);
+    }
+
+    if (strcmp(name, "--budgets") == 0)
+    {
+        if (output_greedy_input->is_sweep)
+        {
+            strcpy(output_error_msg, "option --budgets given twice");
+            return 1;
+        }
+
+        int status = parse_budgets(value, MAX_NUMBER_OF_RSUS, &(output_greedy_input->budgets), output_error_msg);
+        if (status != 0)
+        {
+            return 1;
+        }
+        output_greedy_input->is_sweep = 1;
+
+        return 0;
+    }
+
+    if (strcmp(name, "--tau") == 0)
+    {
+        if (output_greedy_input->taus.num_budgets > 0)
+        {
+            strcpy(output_error_msg, "option --tau given twice");
+            return 1;
+        }
+
+        return parse_taus(value, MAX_TAU_LIST_VALUE, &(output_greedy_input->taus), output_error_msg);
+    }
+
+    if (strcmp(name, "--strategy") == 0)
+    {
+        if (strcmp(value, "static") == 0)
+        {
+            output_greedy_input->strategy = GREEDY_STRATEGY_STATIC;
+        }
+        else if (strcmp(value, "celf") == 0)
+        {
+            output_greedy_input->strategy = GREEDY_STRATEGY_CELF;
+        }
+        else
+        {
+            sprintf(output_error_msg, "unknown strategy \"%s\" (expected static or celf)", value);
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if (strcmp(name, "--stream") == 0)
+    {
+        return try_to_get_positive_int_from_arg(value, "--stream",
+        &(output_greedy_input->stream_chunk_size_in_mb), output_error_msg);
+    }
+
+    sprintf(output_error_msg, "unknown option %s", name);
+    return 1;
+}
+
 // Get int from command line argument;
 // IMPORTANT: Assumes int is big enough for converted value;
 int try_to_get_positive_int_from_arg(char* arg, char* var_name, int* output, 
@@ -264,148 +821,213 @@ char* output_error_msg)
     return 0;
 }
 
-// IMPORTANT: 
-// Assumes, for each vehicle, its trace is composed by adjacent lines,
-// int is big enough for every value, no line is bigger than 200 bytes,
-// and fields are integers separated only by ';' and line ends with ';';
-int read_trace(const char* trace_file_name, struct_trace* output_trace, int *output_trace_size, 
-char* output_error_msg)
+int greedy(
+    struct_coverage_indexes *indexes,
+    struct_cell_bitsets *bitsets,
+    struct_greedy_input greedy_input,
+    struct_greedy_output* output_greedy_output,
+    struct_run_metrics *metrics,
+    char* output_error_msg)
 {
-    int num_seen_vehicles = 0;
-    int last_seen_vehicle_id = -1;
+    int status;
+    int solution_size = 0;
 
-    FILE* f_stream = fopen(trace_file_name, "r");
+    // From the copy of the scores on, the scores themselves are timed once in main();
+    struct_metrics_timer timer;
+    start_metrics_timer(&timer);
+    begin_metrics_phase(metrics, METRICS_PHASE_CONSTRUCT);
 
-    if (f_stream == NULL)
+    if (greedy_input.strategy == GREEDY_STRATEGY_CELF)
     {
-        sprintf(output_error_msg, "can't open file \"%s\"", trace_file_name);
-        return 1;
-    }
-
-    char line_buffer[201];
-    struct_trace aux;
-    int num_read_lines = 0;
-    while (fgets(line_buffer, sizeof(line_buffer), f_stream) != NULL)
-    {
-        if (num_read_lines == MAX_TRACE_SIZE)
-        {   
-            sprintf(output_error_msg, "file \"%s\" is too big (max is %d lines)", 
-            trace_file_name, MAX_TRACE_SIZE);
-            fclose(f_stream);
+        status = celf_greedy(indexes, greedy_input, output_greedy_output, output_error_msg);
+        if (status != 0)
+        {
             return 1;
         }
+        solution_size = output_greedy_output->solution_size;
+        add_metrics_counter(metrics, METRICS_COUNTER_GAIN_EVALUATIONS, output_greedy_output->num_gain_evaluations);
+    }
+    else
+    {
+        int number_of_rsus_to_pick = greedy_input.number_of_rsus;
 
-        sscanf(line_buffer, "%d;%d;%d;%d;%d;",
-        &(aux.vehicle_id), &(aux.time), &(aux.grid_x_pos), &(aux.grid_y_pos), &(aux.r));
-     
-        if (aux.vehicle_id != last_seen_vehicle_id)
+        // Scores are zeroed as cells are picked, so each budget works on a copy;
+        int num_cells = greedy_input.grid.num_cells;
+        int* cells_scores = (int*) malloc(sizeof(int) * (size_t) num_cells);
+        if (cells_scores == NULL)
         {
-            num_seen_vehicles++;
-            last_seen_vehicle_id = aux.vehicle_id;
-        }
-
-        if (num_seen_vehicles > MAX_NUMBER_OF_VEHICLES)
-        {   
-            sprintf(output_error_msg, 
-            "file \"%s\" contains a vehicle with id equal or bigger than %d in line %d (limit is %d vehicles)",
-            trace_file_name, MAX_NUMBER_OF_VEHICLES - 1, num_read_lines + 1, MAX_NUMBER_OF_VEHICLES);
-            fclose(f_stream);
+            sprintf(output_error_msg, "can't allocate memory for the scores of %d cells", num_cells);
             return 1;
         }
+        memcpy(cells_scores, greedy_input.cells_scores, sizeof(int) * (size_t) num_cells);
+
+        int number_of_frequented_cells = get_num_frequented_cells(cells_scores, num_cells);
 
-        if (!(
-            ((0 <= aux.grid_x_pos) && (aux.grid_x_pos < MAX_CELL_GRID_WIDTH)) && 
-            ((0 <= aux.grid_y_pos) && (aux.grid_y_pos < MAX_CELL_GRID_HEIGHT))
-            ))
+        int solution_size_to_achieve = 
+        (number_of_rsus_to_pick > number_of_frequented_cells) ? 
+        number_of_frequented_cells : number_of_rsus_to_pick;
+
+        while (solution_size < solution_size_to_achieve)
         {
-            sprintf(output_error_msg, 
-            "file \"%s\" contains a cell with coordinates out of bounds in line %d." 
-            " Allowed: (0 <= x < %d) (0 <= y < %d)", 
-            trace_file_name, num_read_lines + 1, MAX_CELL_GRID_WIDTH, MAX_CELL_GRID_HEIGHT);
-            fclose(f_stream);
-            return 1;
+            struct_solution chosen_position;
+            chosen_position.cell = get_max_cell_and_zero_it(cells_scores, num_cells);
+            chosen_position.x = greedy_input.grid.cell_x[chosen_position.cell];
+            chosen_position.y = greedy_input.grid.cell_y[chosen_position.cell];
+
+            output_greedy_output->solution[solution_size] = chosen_position;
+            solution_size += 1;
         }
 
-        output_trace[num_read_lines] = aux;
-        num_read_lines++;
+        free(cells_scores);
     }
+    end_metrics_phase(metrics, METRICS_PHASE_CONSTRUCT);
 
-    if (num_read_lines == 0)
+    begin_metrics_phase(metrics, METRICS_PHASE_EVALUATE);
+    int coverage;
+    status = evaluate_solution(
+        greedy_input.eval_kernel, indexes, bitsets,
+        output_greedy_output->solution, solution_size,
+        greedy_input.number_of_contacts,
+        &coverage, output_error_msg
+    );
+    if (status != 0)
     {
-        sprintf(output_error_msg, "file \"%s\" is empty", trace_file_name);
-        fclose(f_stream);
         return 1;
     }
+    
+    end_metrics_phase(metrics, METRICS_PHASE_EVALUATE);
+    add_metrics_counter(metrics, METRICS_COUNTER_EVALUATIONS, 1);
+
+    double execution_time_in_secs;
+    double cpu_time_in_secs;
+    read_metrics_timer(&timer, &execution_time_in_secs, &cpu_time_in_secs);
 
-    *output_trace_size = num_read_lines;
+    output_greedy_output->total_execution_time = greedy_input.scoring_execution_time + execution_time_in_secs;
+    output_greedy_output->cpu_execution_time = greedy_input.scoring_cpu_time + cpu_time_in_secs;
+
+    output_greedy_output->solution_size = solution_size;
+
+    output_greedy_output->solution_obj_f_value = coverage;
 
-    fclose(f_stream);
     return 0;
 }
 
-void greedy(
-    struct_trace* trace, int trace_size, 
+int celf_greedy(
+    struct_coverage_indexes *indexes,
     struct_greedy_input greedy_input,
-    struct_greedy_output* output_greedy_output)
+    struct_greedy_output* output_greedy_output,
+    char* output_error_msg)
 {
-    int number_of_rsus_to_pick = greedy_input.number_of_rsus;
+    struct_cell_vehicles_index* cell_vehicles = &(indexes->cell_vehicles);
 
-    int cells_scores[MAX_CELL_GRID_WIDTH][MAX_CELL_GRID_HEIGHT] = {0};
-
-    fill_scores_in_cells(
-        trace, trace_size, cells_scores, 
-        greedy_input.contacts_time_threshold, 
-        greedy_input.number_of_contacts);
+    struct_coverage_state coverage_state;
+    int status = init_coverage_state(indexes, greedy_input.number_of_contacts, &coverage_state, output_error_msg);
+    if (status != 0)
+    {
+        return 1;
+    }
 
-    int solution_size = 0;
-    int number_of_frequented_cells = get_num_frequented_cells(cells_scores);
+    struct_celf_candidate* heap = (struct_celf_candidate*) malloc(sizeof(struct_celf_candidate) * (size_t) cell_vehicles->num_cells);
+    if (heap == NULL)
+    {
+        sprintf(output_error_msg, "can't allocate memory for the CELF queue");
+        free_coverage_state(&coverage_state);
+        return 1;
+    }
 
-    int solution_size_to_achieve = 
-    (number_of_rsus_to_pick > number_of_frequented_cells) ? 
-    number_of_frequented_cells : number_of_rsus_to_pick;
+    // Candidates are the cells some vehicle reaches within the threshold,
+    // the same ones the static greedy counts as frequented;
+    long long num_gain_evaluations = 0;
+    int heap_size = 0;
+    int c;
+    for (c = 0; c < cell_vehicles->num_cells; c++)
+    {
+        if (cell_vehicles->cell_offsets[c + 1] > cell_vehicles->cell_offsets[c])
+        {
+            heap[heap_size].gain = gain_if_added(&coverage_state, c);
+            heap[heap_size].cell = c;
+            heap[heap_size].gain_round = 0;
+            heap_size++;
+            num_gain_evaluations++;
+        }
+    }
 
-    clock_t begin_timer = clock();
+    int i;
+    for (i = heap_size / 2 - 1; i >= 0; i--)
+    {
+        celf_sift_down(heap, heap_size, i);
+    }
 
-    while (solution_size < solution_size_to_achieve)
+    int solution_size = 0;
+    while (solution_size < greedy_input.number_of_rsus && heap_size > 0)
     {
-        struct_solution chosen_position;
-        get_max_cell_coords_and_zero_it(cells_scores, &(chosen_position.x), &(chosen_position.y));
+        // Gain of the top is up to date, no other candidate can do better;
+        if (heap[0].gain_round == solution_size)
+        {
+            int cell = heap[0].cell;
+            output_greedy_output->solution[solution_size].x = greedy_input.grid.cell_x[cell];
+            output_greedy_output->solution[solution_size].y = greedy_input.grid.cell_y[cell];
+            output_greedy_output->solution[solution_size].cell = cell;
+            output_greedy_output->marginal_gain[solution_size] = add_rsu(&coverage_state, cell);
+            solution_size++;
+
+            heap[0] = heap[--heap_size];
+            celf_sift_down(heap, heap_size, 0);
+            continue;
+        }
 
-        output_greedy_output->solution[solution_size] = chosen_position;
-        solution_size += 1;
+        heap[0].gain = gain_if_added(&coverage_state, heap[0].cell);
+        heap[0].gain_round = solution_size;
+        celf_sift_down(heap, heap_size, 0);
+        num_gain_evaluations++;
     }
 
-    int num_of_contacts[MAX_NUMBER_OF_VEHICLES];
-    int coverage = check_coverage(
-        trace, trace_size, 
-        output_greedy_output->solution, solution_size,
-        num_of_contacts, cells_scores, 
-        greedy_input.contacts_time_threshold,
-        greedy_input.number_of_contacts
-    );
-    
-    clock_t end_timer = clock();
-    double execution_time_in_secs = (double) (end_timer - begin_timer) / CLOCKS_PER_SEC;
+    output_greedy_output->solution_size = solution_size;
+    output_greedy_output->num_gain_evaluations = num_gain_evaluations;
 
-    output_greedy_output->total_execution_time = execution_time_in_secs;
+    free(heap);
+    free_coverage_state(&coverage_state);
 
-    output_greedy_output->solution_size = solution_size;
+    return 0;
+}
 
-    output_greedy_output->solution_obj_f_value = coverage;
+int celf_candidate_precedes(struct_celf_candidate a, struct_celf_candidate b)
+{
+    return (a.gain > b.gain) || (a.gain == b.gain && a.cell < b.cell);
 }
 
-int get_num_frequented_cells(int matrix[MAX_CELL_GRID_WIDTH][MAX_CELL_GRID_HEIGHT])
+void celf_sift_down(struct_celf_candidate *heap, int heap_size, int position)
+{
+    while (1)
+    {
+        int highest = position;
+        int left = 2 * position + 1;
+        int right = left + 1;
+
+        if (left < heap_size && celf_candidate_precedes(heap[left], heap[highest])) highest = left;
+        if (right < heap_size && celf_candidate_precedes(heap[right], heap[highest])) highest = right;
+
+        if (highest == position)
+        {
+            return;
+        }
+
+        struct_celf_candidate aux = heap[position];
+        heap[position] = heap[highest];
+        heap[highest] = aux;
+        position = highest;
+    }
+}
+
+int get_num_frequented_cells(int *matrix, int num_cells)
 {
     int num_frequented_cells = 0;
-    int i, j;
-    for (i = 0; i < MAX_CELL_GRID_WIDTH; i++)
+    int i;
+    for (i = 0; i < num_cells; i++)
     {
-        for (j = 0; j < MAX_CELL_GRID_HEIGHT; j++)
+        if (matrix[i] != 0)
         {
-            if (matrix[i][j] != 0)
-            {
-                num_frequented_cells += 1;
-            }
+            num_frequented_cells += 1;
         }
     }
 
@@ -413,23 +1035,23 @@ int get_num_frequented_cells(int matrix[MAX_CELL_GRID_WIDTH][MAX_CELL_GRID_HEIGH
 }
 
 void fill_scores_in_cells(struct_trace *trace, int tam, 
-int cells[ MAX_CELL_GRID_WIDTH ][ MAX_CELL_GRID_HEIGHT ], int time_interval, int number_of_contacts)
+int *cells, int time_interval, int number_of_contacts)
 {
-    reset_cells(cells);
+    reset_cells(cells, trace->grid.num_cells);
     int current_time = 0;
     int current_vehicle = -1;
 
 	int i;
     for (i = 0; i < tam; i++)
     {
-        if (current_vehicle == trace[i].vehicle_id)
+        if (current_vehicle == trace->vehicle_id[i])
         {
             // if the vehicle reaches the rsu within the given time threshold
             if (current_time <= time_interval)
             {
                 // viable location
                 {
-	                cells[ trace[i].grid_x_pos ][ trace[i].grid_y_pos ]+=1;
+	                cells[ trace->cell[i] ]+=1;
                     // if (cells[ trace[i].x ][ trace[i].y ] >= number_of_contacts)
 	                //    current_vehicle_is_covered = 1;
 				}
@@ -438,86 +1060,119 @@ int cells[ MAX_CELL_GRID_WIDTH ][ MAX_CELL_GRID_HEIGHT ], int time_interval, int
         else
         {
             current_time = 0;
-            current_vehicle = trace[i].vehicle_id;
-            cells[ trace[i].grid_x_pos ][ trace[i].grid_y_pos ]+=1;
+            current_vehicle = trace->vehicle_id[i];
+            cells[ trace->cell[i] ]+=1;
         }
-        current_time = current_time + 10 * trace[i].r;
+        current_time = current_time + 10 * trace->r[i];
     }
 }
 
-void reset_cells(int cells[ MAX_CELL_GRID_WIDTH ][ MAX_CELL_GRID_HEIGHT ])
+void reset_cells(int *cells, int num_cells)
 {
-	int i, j;
-    for (i = 0; i< MAX_CELL_GRID_WIDTH; i++)
-        for (j = 0; j < MAX_CELL_GRID_HEIGHT; j++)
-            cells[i][j]=0;
+	int i;
+    for (i = 0; i < num_cells; i++)
+        cells[i]=0;
 }
 
-void get_max_cell_coords_and_zero_it(int matrix[MAX_CELL_GRID_WIDTH][MAX_CELL_GRID_HEIGHT], 
-int *output_x_coord, int* output_y_coord)
+int get_max_cell_and_zero_it(int *matrix, int num_cells)
 {
-    int max_x = 0;
-	int max_y = 0;
-	int i, j;
-	for (i = 0; i < MAX_CELL_GRID_WIDTH; i++)
+    int max_cell = 0;
+	int i;
+	for (i = 0; i < num_cells; i++)
 	{
-		for (j = 0; j < MAX_CELL_GRID_HEIGHT; j++)
+		if (matrix[i] > matrix[max_cell])
 		{
-			if (matrix[i][j] > matrix[max_x][max_y])
-			{
-				max_x = i;
-				max_y = j;
-			}
+			max_cell = i;
 		}
 	}
 	
-	matrix[max_x][max_y] = 0;
-	*output_x_coord = max_x;
-	*output_y_coord = max_y;
+	matrix[max_cell] = 0;
+
+	return max_cell;
 }
 
-int check_coverage(struct_trace *trace, int trace_size, struct_solution *solution, int solution_size, 
-int *num_of_contacts, int cells[MAX_CELL_GRID_WIDTH][MAX_CELL_GRID_HEIGHT],
-int time_interval, int number_of_contacts)
+// Marks the solution cells, counts covered vehicles on the index and unmarks them,
+// cell_has_rsu must be all zeros and is left that way;
+int check_coverage(struct_vehicle_cells_index *index, struct_solution *solution, int solution_size, 
+unsigned char *cell_has_rsu, int number_of_contacts)
 {
-    reset_vehicles (num_of_contacts, MAX_NUMBER_OF_VEHICLES);
-    reset_cells(cells);
-
     int i;
-    for (i = 0; i < solution_size; i++) cells[ solution[i].x ][ solution[i].y ] = 1;
-    
-	int start_time = -1;
-	int current_vehicle = -1;
-	for (i = 0; i < trace_size; i++)
-	{
-		if (current_vehicle == trace[i].vehicle_id)
-		{
-			// check if it is inside rsu
-			if ( cells[ trace[i].grid_x_pos ][ trace[i].grid_y_pos ] == 1 
-            && (trace[i].time < (start_time + time_interval)) ) 
-			{
-				num_of_contacts[ trace[i].vehicle_id ] += 1;
-			}
-		}
-		else
-		{
-			current_vehicle = trace[i].vehicle_id;
-			start_time = trace[i].time;
-			i--;
-		}
-	}
+    for (i = 0; i < solution_size; i++) cell_has_rsu[ solution[i].cell ] = 1;
 
-	int covered = 0;
-	for (i = 0; i < MAX_NUMBER_OF_VEHICLES; i++)
-		if (num_of_contacts[i] >= number_of_contacts) covered++;
+    int covered = count_covered_vehicles(index, cell_has_rsu, number_of_contacts);
 
-	return covered;
+    for (i = 0; i < solution_size; i++) cell_has_rsu[ solution[i].cell ] = 0;
+
+    return covered;
 }
 
-void reset_vehicles(int *vehicles, int tam)
+int evaluate_solution(enum_coverage_kernel eval_kernel, struct_coverage_indexes *indexes,
+struct_cell_bitsets *bitsets, struct_solution *solution, int solution_size, int number_of_contacts,
+int *output_coverage, char* output_error_msg)
 {
-	int i;
-	for (i=0; i<tam; i++) vehicles[i]=0;
+    int status;
+    int i;
+
+    if (is_bitset_kernel(eval_kernel))
+    {
+        int solution_cells[MAX_NUMBER_OF_RSUS];
+        const uint64_t* bitset_rows[MAX_NUMBER_OF_RSUS];
+        for (i = 0; i < solution_size; i++) solution_cells[i] = solution[i].cell;
+
+        *output_coverage = count_covered_vehicles_bitset(bitsets, solution_cells, solution_size, eval_kernel,
+        bitset_rows);
+
+        return 0;
+    }
+
+    if (eval_kernel == COVERAGE_KERNEL_INCREMENTAL)
+    {
+        struct_coverage_state coverage_state;
+        status = init_coverage_state(indexes, number_of_contacts, &coverage_state, output_error_msg);
+        if (status != 0)
+        {
+            return 1;
+        }
+
+        for (i = 0; i < solution_size; i++) add_rsu(&coverage_state, solution[i].cell);
+
+        *output_coverage = current_coverage(&coverage_state);
+
+        free_coverage_state(&coverage_state);
+        return 0;
+    }
+
+    if (eval_kernel == COVERAGE_KERNEL_CONTACTS)
+    {
+        struct_contact_counters contact_counters;
+        status = init_contact_counters(indexes, &contact_counters, output_error_msg);
+        if (status != 0)
+        {
+            return 1;
+        }
+
+        int solution_cells[MAX_NUMBER_OF_RSUS];
+        for (i = 0; i < solution_size; i++) solution_cells[i] = solution[i].cell;
+
+        *output_coverage = count_covered_vehicles_by_cells(&(indexes->cell_vehicles), &contact_counters,
+        solution_cells, solution_size, number_of_contacts);
+
+        free_contact_counters(&contact_counters);
+        return 0;
+    }
+
+    unsigned char* cell_has_rsu = (unsigned char*) calloc((size_t) indexes->vehicle_cells.num_cells, 1);
+    if (cell_has_rsu == NULL)
+    {
+        sprintf(output_error_msg, "can't allocate memory for the RSU cells");
+        return 1;
+    }
+
+    *output_coverage = check_coverage(&(indexes->vehicle_cells), solution, solution_size,
+    cell_has_rsu, number_of_contacts);
+
+    free(cell_has_rsu);
+    return 0;
 }
 
 int write_summary_to_file(
@@ -550,8 +1205,27 @@ int write_summary_to_file(
     fprintf(output_file, "CONTACTS TIME INTERVAL: %d\n",
         greedy_input.contacts_time_threshold);
 
-    fprintf(output_file, "TOTAL EXECUTION TIME: %.06f\n\n", 
+    fprintf(output_file, "STRATEGY: %s\n",
+        (greedy_input.strategy == GREEDY_STRATEGY_CELF) ? "celf" : "static");
+    fprintf(output_file, "EVALUATION KERNEL: %s\n",
+        get_coverage_kernel_name(greedy_input.eval_kernel));
+    if (greedy_input.stream_chunk_size_in_mb > 0)
+    {
+        fprintf(output_file, "TRACE STREAM CHUNK SIZE (MB): %d\n",
+            greedy_input.stream_chunk_size_in_mb);
+    }
+    if (greedy_input.strategy == GREEDY_STRATEGY_CELF)
+    {
+        fprintf(output_file, "N. MARGINAL GAIN EVALUATIONS: %lld\n",
+            greedy_output.num_gain_evaluations);
+    }
+
+    fprintf(output_file, "TOTAL EXECUTION TIME: %.06f\n", 
         greedy_output.total_execution_time);
+    fprintf(output_file, "CPU TIME: %.06f\n", 
+        greedy_output.cpu_execution_time);
+    fprintf(output_file, "PEAK RSS SO FAR (MB): %.1f\n\n", 
+        get_peak_rss_in_mb());
 
     fprintf(output_file, "-------------------- BEST SOLUTION ---------------------------\n\n");
 
@@ -593,3 +1267,112 @@ int write_rsus_to_file(
 
     return 0;
 }
+
+int write_marginal_gains_to_file(
+    struct_greedy_input greedy_input, 
+    struct_greedy_output* greedy_output,
+    char *output_error_msg
+)
+{
+    char output_file_name[MAX_INPUT_FILE_PATH_SIZE + 100];
+    sprintf(output_file_name, "rsu=%d_tau=%d_cont=%d_gains.csv", 
+    greedy_input.number_of_rsus, 
+    greedy_input.contacts_time_threshold, 
+    greedy_input.number_of_contacts);
+
+    FILE* gains_file = fopen(output_file_name, "w");
+    if (gains_file == NULL)
+    {
+        sprintf(output_error_msg, "can't write gains file");
+        return 1;
+    }
+
+    int coverage = 0;
+    int i;
+    for (i = 0; i < greedy_output->solution_size; i++)
+    {
+        coverage += greedy_output->marginal_gain[i];
+        fprintf(gains_file, "%d,%d,%d,%d,%d\n", i + 1, 
+        greedy_output->solution[i].x, greedy_output->solution[i].y, 
+        greedy_output->marginal_gain[i], coverage);
+    }
+
+    fclose(gains_file);
+
+    return 0;
+}
+
+int write_coverage_curve_to_file(
+    struct_greedy_input greedy_input, 
+    struct_greedy_output* greedy_output,
+    struct_coverage_indexes *curve_indexes,
+    char *output_error_msg
+)
+{
+    int solution_size = greedy_output->solution_size;
+    int num_taus = greedy_input.taus.num_budgets;
+    int solution_cells[MAX_NUMBER_OF_RSUS];
+    int* curve = (int*) malloc(sizeof(int) * (size_t) (solution_size > 0 ? solution_size : 1) * num_taus);
+    if (curve == NULL)
+    {
+        sprintf(output_error_msg, "can't allocate memory for the curve of %d RSUs", solution_size);
+        return 1;
+    }
+
+    int i, t;
+    for (i = 0; i < solution_size; i++)
+    {
+        solution_cells[i] = greedy_output->solution[i].cell;
+    }
+
+    int status = fill_coverage_curve_by_tau(curve_indexes, greedy_input.number_of_contacts,
+    greedy_input.taus.budgets, num_taus, solution_cells, solution_size, curve, output_error_msg);
+    if (status != 0)
+    {
+        free(curve);
+        return 1;
+    }
+
+    char output_file_name[MAX_INPUT_FILE_PATH_SIZE + MAX_BUDGETS_LABEL_SIZE + 100];
+    sprintf(output_file_name, "rsu=%d_tau=%s_cont=%d_curve.csv", 
+    greedy_input.number_of_rsus, 
+    greedy_input.taus.label, 
+    greedy_input.number_of_contacts);
+
+    FILE* curve_file = fopen(output_file_name, "w");
+    if (curve_file == NULL)
+    {
+        sprintf(output_error_msg, "can't write curve file");
+        free(curve);
+        return 1;
+    }
+
+    // One coverage column per threshold, in the order of --tau;
+    for (i = 0; i < solution_size; i++)
+    {
+        fprintf(curve_file, "%d,%d,%d", i + 1, 
+        greedy_output->solution[i].x, greedy_output->solution[i].y);
+        for (t = 0; t < num_taus; t++)
+        {
+            fprintf(curve_file, ",%d", curve[(size_t) i * num_taus + t]);
+        }
+        fprintf(curve_file, "\n");
+    }
+
+    fclose(curve_file);
+    free(curve);
+
+    return 0;
+}
+int write_greedy_metrics_to_file(
+    struct_greedy_input greedy_input,
+    struct_run_metrics *metrics,
+    char *output_error_msg
+)
+{
+    char output_file_name[MAX_INPUT_FILE_PATH_SIZE + 100];
+    sprintf(output_file_name, "rsu=%d_tau=%d_cont=%d_metrics.json", 
+    greedy_input.number_of_rsus, greedy_input.contacts_time_threshold, greedy_input.number_of_contacts);
+
+    return write_metrics_to_file(output_file_name, "greedy", metrics, output_error_msg);
+}
@@ -0,0 +1,685 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../common_src/trace.h"
+#include "../common_src/coverage.h"
+#include "../common_src/coverage_stream.h"
+#include "../common_src/budgets.h"
+
+#define MAX_INPUT_FILE_PATH_SIZE    100
+
+#define NUM_POSITIONAL_ARGS         2
+
+// Budgets of run_ilp.ipynb: int(total cells * rho) RSUs for each rho;
+#define MAX_NUMBER_OF_RHOS          100
+#define DEFAULT_RHOS                "0.01,0.05,0.10,0.15,0.20,0.25,0.30,0.35,0.40,0.45,0.50"
+
+// The trace is always reduced in chunks, this is the chunk memory without --stream;
+#define DEFAULT_STREAM_CHUNK_SIZE_IN_MB     64
+
+#define CELLS_PER_VEHICLE_FILE_NAME "cells_per_vehicle.csv"
+
+// Terms per line of the LP file, readers limit line lengths;
+#define LP_TERMS_PER_LINE           8
+
+typedef enum model_format_
+{
+    // Free MPS, with an OBJSENSE section;
+    MODEL_FORMAT_MPS,
+    // CPLEX LP;
+    MODEL_FORMAT_LP
+
+} enum_model_format;
+
+typedef struct ilp_export_input_
+{
+    int contacts_time_threshold;
+
+    enum_model_format format;
+
+    // One model per rho (--rho, the 11 of run_ilp.ipynb by default) or per budget (--budgets);
+    int num_rhos;
+    double rhos[MAX_NUMBER_OF_RHOS];
+    char rho_labels[MAX_NUMBER_OF_RHOS][20];
+    int is_sweep;
+    struct_budgets budgets;
+
+    // Cells the rhos are fractions of (--total-cells), the frequented cells of the trace by default;
+    int total_cells;
+
+    int stream_chunk_size_in_mb;
+
+} struct_ilp_export_input;
+
+// ==================== INPUT FUNCTIONS ==================== //
+// If succeedes, returns 0 and output_ilp_export_input can be used;
+// Otherwise, returns 1 and error_msg can be used;
+int read_commandline_args(
+    int argc, char **argv,
+    struct_ilp_export_input *output_ilp_export_input,
+    char* output_input_file_path, char* output_error_msg
+);
+
+int try_to_get_positive_int_from_arg(
+    char* arg, char* var_name,
+    int* output,
+    char* output_error_msg
+);
+
+// Options are "--name value" pairs accepted anywhere among the positional arguments;
+// If succeedes, returns 0 and the option's value is stored in output_ilp_export_input;
+// Otherwise, returns 1 and error_msg can be used;
+int read_commandline_option(
+    char* name, char* value,
+    struct_ilp_export_input *output_ilp_export_input,
+    char* output_error_msg
+);
+
+// spec is a list "r1,r2,...", each rho in (0, 1];
+// If succeedes, returns 0 and the rhos are stored in output_ilp_export_input;
+// Otherwise, returns 1 and error_msg can be used;
+int parse_rhos(
+    const char* spec,
+    struct_ilp_export_input *output_ilp_export_input,
+    char* output_error_msg
+);
+// ==================== INPUT FUNCTIONS ==================== //
+
+
+// ==================== OUTPUT FUNCTIONS ==================== //
+// Same lines as get_cells_within_tau.ipynb: one line per vehicle, its distinct cells within the threshold
+// in order of first visit, as "x_y" separated by ";";
+int write_cells_per_vehicle_to_file(
+    struct_coverage_indexes *indexes,
+    struct_cell_grid *grid,
+    char* output_error_msg
+);
+
+// Model of run_ilp.ipynb, everything but the budget's right hand side, which is the only difference
+// between the models of a sweep;
+// head_part gets everything before the right hand side, tail_part everything after it;
+int write_shared_model_parts(
+    enum_model_format format,
+    struct_coverage_indexes *indexes,
+    struct_cell_grid *grid,
+    FILE* head_part, FILE* tail_part
+);
+
+// If succeedes, returns 0;
+// Otherwise, returns 1 and error_msg can be used;
+int write_model_to_file(
+    enum_model_format format,
+    const char* model_name, int number_of_rsus,
+    FILE* head_part, FILE* tail_part,
+    char* output_error_msg
+);
+
+// Appends the whole of part to output_file, from its start;
+int copy_model_part(FILE* part, FILE* output_file);
+// ==================== OUTPUT FUNCTIONS ==================== //
+
+
+int main(int argc, char** argv)
+{
+    // In case any specified error below occurs;
+    int status;
+    char error_msg[300];
+    error_msg[0] = '\0';
+
+    // ==================== 1 - READ INPUT ==================== //
+
+    const char* correct_input_format = "USAGE: ilp-export <contacts time threshold> <trace file path>"
+    " [--rho <list r1,r2,...>] [--budgets <min:max:step or list b1,b2,...> in place of --rho]"
+    " [--total-cells <num of cells>] [--format mps|lp] [--stream <chunk size in MB>]";
+
+    // -------------------- 1.1 COMMAND LINE ------------------ //
+
+    char input_file_path[MAX_INPUT_FILE_PATH_SIZE + 1];
+    input_file_path[0] = '\0';
+    struct_ilp_export_input ilp_export_input;
+    status = read_commandline_args(argc, argv, &ilp_export_input, input_file_path, error_msg);
+    if (status != 0)
+    {
+        fprintf(stderr, "ILP-EXPORT: COMMAND LINE ERROR: %s\n\n%s\n",
+        error_msg, correct_input_format);
+        return 1;
+    }
+
+    // -------------------- 1.2 TRACE FILE -------------------- //
+
+    // Same filter as get_cells_within_tau.ipynb: records with (time - vehicle's first record time) <= threshold,
+    // reduced chunk by chunk to the distinct cells of each vehicle;
+    struct_reduced_trace reduced_trace;
+    struct_trace_read_stats trace_read_stats;
+    status = reduce_trace_in_chunks(input_file_path, (size_t) ilp_export_input.stream_chunk_size_in_mb * 1000000,
+    ilp_export_input.contacts_time_threshold, &(ilp_export_input.contacts_time_threshold), 1,
+    &reduced_trace, &trace_read_stats, error_msg);
+    if (status != 0)
+    {
+        fprintf(stderr, "ILP-EXPORT: INPUT TRACE FILE ERROR: %s\n", error_msg);
+        if (ilp_export_input.is_sweep)
+        {
+            free_budgets(&(ilp_export_input.budgets));
+        }
+        return 1;
+    }
+
+    printf("ILP-EXPORT: TRACE FILE: %lld lines, %d vehicles, %.1f MB %s reduced in %d chunks in %.3f s (%.1f MB/s)\n",
+    reduced_trace.size, reduced_trace.num_vehicles, trace_read_stats.file_size_in_bytes / 1e6,
+    trace_read_stats.is_binary_format ? "binary" : "text", reduced_trace.num_chunks,
+    trace_read_stats.read_time_in_secs, trace_read_stats.throughput_in_mb_per_sec);
+
+    struct_coverage_indexes* indexes = &(reduced_trace.indexes[0]);
+    if (ilp_export_input.total_cells == 0)
+    {
+        ilp_export_input.total_cells = reduced_trace.grid.num_cells;
+    }
+
+    // ==================== 2 - WRITE FILES ==================== //
+
+    struct timespec begin_timer;
+    clock_gettime(CLOCK_MONOTONIC, &begin_timer);
+
+    status = write_cells_per_vehicle_to_file(indexes, &(reduced_trace.grid), error_msg);
+    if (status != 0)
+    {
+        fprintf(stderr, "ILP-EXPORT: OUTPUT CELLS PER VEHICLE FILE ERROR: %s\n", error_msg);
+        free_reduced_trace(&reduced_trace);
+        if (ilp_export_input.is_sweep)
+        {
+            free_budgets(&(ilp_export_input.budgets));
+        }
+        return 1;
+    }
+
+    // Written once, then copied into every model;
+    FILE* head_part = tmpfile();
+    FILE* tail_part = tmpfile();
+    if (head_part == NULL || tail_part == NULL
+    || write_shared_model_parts(ilp_export_input.format, indexes, &(reduced_trace.grid), head_part, tail_part) != 0)
+    {
+        fprintf(stderr, "ILP-EXPORT: OUTPUT MODEL FILE ERROR: can't write the model to a temporary file\n");
+        status = 1;
+    }
+
+    // The model is all the solver needs from here on;
+    int num_vehicles = reduced_trace.num_vehicles;
+    int num_model_cells = 0;
+    int c;
+    for (c = 0; c < indexes->cell_vehicles.num_cells; c++)
+    {
+        num_model_cells += (indexes->cell_vehicles.cell_offsets[c + 1] > indexes->cell_vehicles.cell_offsets[c]);
+    }
+    int num_entries = indexes->vehicle_cells.num_entries;
+    free_reduced_trace(&reduced_trace);
+
+    const char* extension = (ilp_export_input.format == MODEL_FORMAT_LP) ? "lp" : "mps";
+    int num_models = ilp_export_input.is_sweep ? ilp_export_input.budgets.num_budgets : ilp_export_input.num_rhos;
+    int m;
+    for (m = 0; m < num_models && status == 0; m++)
+    {
+        char model_name[100];
+        int number_of_rsus;
+        if (ilp_export_input.is_sweep)
+        {
+            number_of_rsus = ilp_export_input.budgets.budgets[m];
+            sprintf(model_name, "ILP_rsu=%d_tau=%d", number_of_rsus, ilp_export_input.contacts_time_threshold);
+        }
+        else
+        {
+            // Same rounding as run_ilp.ipynb's int(total_cells * p);
+            number_of_rsus = (int) (ilp_export_input.total_cells * ilp_export_input.rhos[m]);
+            sprintf(model_name, "ILP_rho_%s_tau=%d", ilp_export_input.rho_labels[m], ilp_export_input.contacts_time_threshold);
+        }
+
+        char model_file_name[150];
+        sprintf(model_file_name, "%s_model.%s", model_name, extension);
+
+        status = write_model_to_file(ilp_export_input.format, model_file_name, number_of_rsus,
+        head_part, tail_part, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "ILP-EXPORT: OUTPUT MODEL FILE ERROR: %s\n", error_msg);
+            break;
+        }
+        printf("ILP-EXPORT: MODEL: %s (%d RSUs)\n", model_file_name, number_of_rsus);
+    }
+
+    if (status == 0)
+    {
+        struct timespec end_timer;
+        clock_gettime(CLOCK_MONOTONIC, &end_timer);
+
+        printf("ILP-EXPORT: %d models of %d cell and %d vehicle variables, %d coverage entries, written in %.3f s"
+        " (total cells %d)\n", num_models, num_model_cells, num_vehicles, num_entries,
+        (end_timer.tv_sec - begin_timer.tv_sec) + (end_timer.tv_nsec - begin_timer.tv_nsec) / 1e9,
+        ilp_export_input.total_cells);
+    }
+
+    // ==================== 3 - FREE REMAINING RESOURCES ====== //
+    if (head_part != NULL) fclose(head_part);
+    if (tail_part != NULL) fclose(tail_part);
+    if (ilp_export_input.is_sweep)
+    {
+        free_budgets(&(ilp_export_input.budgets));
+    }
+
+    return status;
+}
+
+int read_commandline_args(int argc, char **argv, struct_ilp_export_input *output_ilp_export_input,
+char* output_input_file_path, char* output_error_msg)
+{
+    int status;
+
+    // ========== Split options from positional arguments; ========== //
+    output_ilp_export_input->format = MODEL_FORMAT_MPS;
+    output_ilp_export_input->num_rhos = 0;
+    output_ilp_export_input->is_sweep = 0;
+    output_ilp_export_input->total_cells = 0;
+    output_ilp_export_input->stream_chunk_size_in_mb = DEFAULT_STREAM_CHUNK_SIZE_IN_MB;
+
+    // argv-like: program name, then the positional arguments in order;
+    char* positional_args[NUM_POSITIONAL_ARGS + 1];
+    positional_args[0] = argv[0];
+    int num_positional_args = 0;
+    int i;
+    for (i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--", 2) == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                sprintf(output_error_msg, "option %s needs a value", argv[i]);
+                status = 1;
+            }
+            else
+            {
+                status = read_commandline_option(argv[i], argv[i + 1], output_ilp_export_input, output_error_msg);
+            }
+            if (status != 0)
+            {
+                if (output_ilp_export_input->is_sweep)
+                {
+                    free_budgets(&(output_ilp_export_input->budgets));
+                }
+                return 1;
+            }
+            i++;
+        }
+        else if (num_positional_args < NUM_POSITIONAL_ARGS)
+        {
+            positional_args[++num_positional_args] = argv[i];
+        }
+        else
+        {
+            num_positional_args = NUM_POSITIONAL_ARGS + 1;
+        }
+    }
+
+    status = 0;
+    if (num_positional_args != NUM_POSITIONAL_ARGS)
+    {
+        strcpy(output_error_msg, "wrong number of arguments");
+        status = 1;
+    }
+    else if (output_ilp_export_input->is_sweep && output_ilp_export_input->num_rhos > 0)
+    {
+        strcpy(output_error_msg, "--rho and --budgets can't be used together");
+        status = 1;
+    }
+    else if (!output_ilp_export_input->is_sweep && output_ilp_export_input->num_rhos == 0)
+    {
+        status = parse_rhos(DEFAULT_RHOS, output_ilp_export_input, output_error_msg);
+    }
+    argv = positional_args;
+
+    // ========== Try to convert all arguments to correct numeric values; ========== //
+
+    if (status == 0)
+    {
+        status = try_to_get_positive_int_from_arg(argv[1], "<contacts time threshold>",
+        &(output_ilp_export_input->contacts_time_threshold), output_error_msg);
+    }
+    if (status == 0 && strlen(argv[2]) > MAX_INPUT_FILE_PATH_SIZE)
+    {
+        sprintf(output_error_msg, "file path is bigger than %d bytes", MAX_INPUT_FILE_PATH_SIZE);
+        status = 1;
+    }
+    if (status != 0)
+    {
+        if (output_ilp_export_input->is_sweep)
+        {
+            free_budgets(&(output_ilp_export_input->budgets));
+        }
+        return 1;
+    }
+
+    // ========== try to get input file path ========== //
+    strcpy(output_input_file_path, argv[2]);
+
+    return 0;
+}
+
+int read_commandline_option(char* name, char* value,
+struct_ilp_export_input *output_ilp_export_input, char* output_error_msg)
+{
+    if (strcmp(name, "--rho") == 0)
+    {
+        if (output_ilp_export_input->num_rhos > 0)
+        {
+            strcpy(output_error_msg, "option --rho given twice");
+            return 1;
+        }
+
+        return parse_rhos(value, output_ilp_export_input, output_error_msg);
+    }
+
+    if (strcmp(name, "--budgets") == 0)
+    {
+        if (output_ilp_export_input->is_sweep)
+        {
+            strcpy(output_error_msg, "option --budgets given twice");
+            return 1;
+        }
+
+        int status = parse_budgets(value, 1 << 30, &(output_ilp_export_input->budgets), output_error_msg);
+        if (status != 0)
+        {
+            return 1;
+        }
+        output_ilp_export_input->is_sweep = 1;
+
+        return 0;
+    }
+
+    if (strcmp(name, "--total-cells") == 0)
+    {
+        return try_to_get_positive_int_from_arg(value, "--total-cells",
+        &(output_ilp_export_input->total_cells), output_error_msg);
+    }
+
+    if (strcmp(name, "--format") == 0)
+    {
+        if (strcmp(value, "mps") == 0)
+        {
+            output_ilp_export_input->format = MODEL_FORMAT_MPS;
+        }
+        else if (strcmp(value, "lp") == 0)
+        {
+            output_ilp_export_input->format = MODEL_FORMAT_LP;
+        }
+        else
+        {
+            sprintf(output_error_msg, "unknown format \"%s\" (expected mps or lp)", value);
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if (strcmp(name, "--stream") == 0)
+    {
+        return try_to_get_positive_int_from_arg(value, "--stream",
+        &(output_ilp_export_input->stream_chunk_size_in_mb), output_error_msg);
+    }
+
+    sprintf(output_error_msg, "unknown option %s", name);
+    return 1;
+}
+
+// Get int from command line argument;
+// IMPORTANT: Assumes int is big enough for converted value;
+int try_to_get_positive_int_from_arg(char* arg, char* var_name, int* output,
+char* output_error_msg)
+{
+    int value = atoi(arg);
+    if (value <= 0)
+    {
+        sprintf(output_error_msg, "%s must be a positive integer", var_name);
+        return 1;
+    }
+
+    *output = value;
+
+    return 0;
+}
+
+int parse_rhos(const char* spec, struct_ilp_export_input *output_ilp_export_input, char* output_error_msg)
+{
+    int num_rhos = 0;
+    const char* item = spec;
+    while (1)
+    {
+        const char* item_end = strchr(item, ',');
+        size_t item_length = (item_end != NULL) ? (size_t) (item_end - item) : strlen(item);
+
+        char* number_end;
+        double rho = strtod(item, &number_end);
+        if (item_length == 0 || item_length >= sizeof(output_ilp_export_input->rho_labels[0])
+        || number_end != item + item_length || !(rho > 0.0 && rho <= 1.0))
+        {
+            sprintf(output_error_msg, "--rho must be a list r1,r2,... of numbers in (0, 1]");
+            return 1;
+        }
+        if (num_rhos == MAX_NUMBER_OF_RHOS)
+        {
+            sprintf(output_error_msg, "--rho has more than %d values", MAX_NUMBER_OF_RHOS);
+            return 1;
+        }
+
+        output_ilp_export_input->rhos[num_rhos] = rho;
+        // File names show rho as run_ilp.ipynb writes it, with 2 decimals;
+        sprintf(output_ilp_export_input->rho_labels[num_rhos], "%.2f", rho);
+        num_rhos++;
+
+        if (item_end == NULL)
+        {
+            break;
+        }
+        item = item_end + 1;
+    }
+
+    output_ilp_export_input->num_rhos = num_rhos;
+
+    return 0;
+}
+
+int write_cells_per_vehicle_to_file(struct_coverage_indexes *indexes, struct_cell_grid *grid,
+char* output_error_msg)
+{
+    FILE* output_file = fopen(CELLS_PER_VEHICLE_FILE_NAME, "w");
+    if (output_file == NULL)
+    {
+        sprintf(output_error_msg, "can't write file \"%s\"", CELLS_PER_VEHICLE_FILE_NAME);
+        return 1;
+    }
+
+    struct_vehicle_cells_index* vehicle_cells = &(indexes->vehicle_cells);
+    int v, e;
+    for (v = 0; v < vehicle_cells->num_vehicles; v++)
+    {
+        for (e = vehicle_cells->vehicle_offsets[v]; e < vehicle_cells->vehicle_offsets[v + 1]; e++)
+        {
+            int cell = vehicle_cells->cell[e];
+            fprintf(output_file, (e > vehicle_cells->vehicle_offsets[v]) ? ";%d_%d" : "%d_%d",
+            grid->cell_x[cell], grid->cell_y[cell]);
+        }
+        fputc('\n', output_file);
+    }
+
+    if (fclose(output_file) != 0)
+    {
+        sprintf(output_error_msg, "can't write file \"%s\"", CELLS_PER_VEHICLE_FILE_NAME);
+        return 1;
+    }
+
+    return 0;
+}
+
+int write_shared_model_parts(enum_model_format format, struct_coverage_indexes *indexes, struct_cell_grid *grid,
+FILE* head_part, FILE* tail_part)
+{
+    struct_vehicle_cells_index* vehicle_cells = &(indexes->vehicle_cells);
+    struct_cell_vehicles_index* cell_vehicles = &(indexes->cell_vehicles);
+    int num_vehicles = vehicle_cells->num_vehicles;
+    int v, c, e;
+
+    // Variables and restrictions keep the names of run_ilp.ipynb: x_<x>_<y> for the cells some vehicle
+    // reaches within the threshold, in (x, y) order, then v_<k> for the k-th vehicle of cells_per_vehicle;
+    if (format == MODEL_FORMAT_MPS)
+    {
+        // -------- ROWS and COLUMNS, each column's entries together; -------- //
+        fprintf(head_part, "OBJSENSE\n    MAX\nROWS\n N obj\n");
+        for (v = 0; v < num_vehicles; v++)
+        {
+            fprintf(head_part, " G coverage_%d\n", v);
+        }
+        fprintf(head_part, " L budget\nCOLUMNS\n");
+
+        for (c = 0; c < cell_vehicles->num_cells; c++)
+        {
+            for (e = cell_vehicles->cell_offsets[c]; e < cell_vehicles->cell_offsets[c + 1]; e++)
+            {
+                fprintf(head_part, "    x_%d_%d coverage_%d 1\n", grid->cell_x[c], grid->cell_y[c], cell_vehicles->vehicle[e]);
+            }
+            if (cell_vehicles->cell_offsets[c + 1] > cell_vehicles->cell_offsets[c])
+            {
+                fprintf(head_part, "    x_%d_%d budget 1\n", grid->cell_x[c], grid->cell_y[c]);
+            }
+        }
+        for (v = 0; v < num_vehicles; v++)
+        {
+            fprintf(head_part, "    v_%d obj 1\n    v_%d coverage_%d -1\n", v, v, v);
+        }
+        fprintf(head_part, "RHS\n");
+
+        // -------- BOUNDS: every variable is binary; -------- //
+        fprintf(tail_part, "BOUNDS\n");
+        for (c = 0; c < cell_vehicles->num_cells; c++)
+        {
+            if (cell_vehicles->cell_offsets[c + 1] > cell_vehicles->cell_offsets[c])
+            {
+                fprintf(tail_part, " BV BND x_%d_%d\n", grid->cell_x[c], grid->cell_y[c]);
+            }
+        }
+        for (v = 0; v < num_vehicles; v++)
+        {
+            fprintf(tail_part, " BV BND v_%d\n", v);
+        }
+        fprintf(tail_part, "ENDATA\n");
+    }
+    else
+    {
+        // -------- Objective and coverage restrictions, then the budget up to its right hand side; -------- //
+        fprintf(head_part, "Maximize\n obj:");
+        for (v = 0; v < num_vehicles; v++)
+        {
+            fprintf(head_part, (v % LP_TERMS_PER_LINE == LP_TERMS_PER_LINE - 1) ? " + v_%d\n" : " + v_%d", v);
+        }
+        fprintf(head_part, "\nSubject To\n");
+
+        for (v = 0; v < num_vehicles; v++)
+        {
+            fprintf(head_part, " coverage_%d:", v);
+            for (e = vehicle_cells->vehicle_offsets[v]; e < vehicle_cells->vehicle_offsets[v + 1]; e++)
+            {
+                int cell = vehicle_cells->cell[e];
+                int term = e - vehicle_cells->vehicle_offsets[v];
+                fprintf(head_part, (term % LP_TERMS_PER_LINE == LP_TERMS_PER_LINE - 1) ? " + x_%d_%d\n" : " + x_%d_%d",
+                grid->cell_x[cell], grid->cell_y[cell]);
+            }
+            fprintf(head_part, " - v_%d >= 0\n", v);
+        }
+
+        fprintf(head_part, " budget:");
+        int term = 0;
+        for (c = 0; c < cell_vehicles->num_cells; c++)
+        {
+            if (cell_vehicles->cell_offsets[c + 1] > cell_vehicles->cell_offsets[c])
+            {
+                fprintf(head_part, (term % LP_TERMS_PER_LINE == LP_TERMS_PER_LINE - 1) ? " + x_%d_%d\n" : " + x_%d_%d",
+                grid->cell_x[c], grid->cell_y[c]);
+                term++;
+            }
+        }
+
+        // -------- Binary: every variable; -------- //
+        fprintf(tail_part, "Binary\n");
+        for (c = 0; c < cell_vehicles->num_cells; c++)
+        {
+            if (cell_vehicles->cell_offsets[c + 1] > cell_vehicles->cell_offsets[c])
+            {
+                fprintf(tail_part, " x_%d_%d\n", grid->cell_x[c], grid->cell_y[c]);
+            }
+        }
+        for (v = 0; v < num_vehicles; v++)
+        {
+            fprintf(tail_part, " v_%d\n", v);
+        }
+        fprintf(tail_part, "End\n");
+    }
+
+    if (fflush(head_part) != 0 || fflush(tail_part) != 0 || ferror(head_part) || ferror(tail_part))
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+int write_model_to_file(enum_model_format format, const char* model_file_name, int number_of_rsus,
+FILE* head_part, FILE* tail_part, char* output_error_msg)
+{
+    FILE* output_file = fopen(model_file_name, "w");
+    if (output_file == NULL)
+    {
+        sprintf(output_error_msg, "can't write file \"%s\"", model_file_name);
+        return 1;
+    }
+
+    int status;
+    if (format == MODEL_FORMAT_MPS)
+    {
+        fprintf(output_file, "NAME %s\n", model_file_name);
+        status = copy_model_part(head_part, output_file);
+        fprintf(output_file, "    RHS budget %d\n", number_of_rsus);
+    }
+    else
+    {
+        fprintf(output_file, "\\ %s\n", model_file_name);
+        status = copy_model_part(head_part, output_file);
+        fprintf(output_file, " <= %d\n", number_of_rsus);
+    }
+    if (status == 0)
+    {
+        status = copy_model_part(tail_part, output_file);
+    }
+
+    if (fclose(output_file) != 0 || status != 0)
+    {
+        sprintf(output_error_msg, "can't write file \"%s\"", model_file_name);
+        return 1;
+    }
+
+    return 0;
+}
+
+int copy_model_part(FILE* part, FILE* output_file)
+{
+    char buffer[1 << 16];
+    size_t num_bytes;
+
+    rewind(part);
+    while ((num_bytes = fread(buffer, 1, sizeof(buffer), part)) > 0)
+    {
+        if (fwrite(buffer, 1, num_bytes, output_file) != num_bytes)
+        {
+            return 1;
+        }
+    }
+
+    return ferror(part) ? 1 : 0;
+}
@@ -0,0 +1,1057 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../common_src/trace.h"
+#include "../common_src/coverage.h"
+#include "../common_src/coverage_stream.h"
+#include "../common_src/budgets.h"
+
+#define MAX_NUMBER_OF_RSUS          MAX_SOLUTION_SIZE
+
+#define MAX_INPUT_FILE_PATH_SIZE    100
+
+#define NUM_POSITIONAL_ARGS         3
+
+#define DEFAULT_MAX_ITERATIONS      500
+
+// Polyak step factor: starts at 2 and is halved after this many iterations without a better bound,
+// the search stops once it is below the minimum;
+#define INITIAL_STEP_FACTOR         2.0
+#define STEP_FACTOR_PATIENCE        20
+#define MIN_STEP_FACTOR             0.001
+
+typedef struct solution_
+{
+    int x;
+    int y;
+    // Dense cell of (x, y), see struct_cell_grid;
+    int cell;
+
+} struct_solution;
+
+// Max coverage model of ilp_src/run_ilp.ipynb, for 1 contact:
+//   max sum_v y_v  s.t.  y_v <= sum_{c reached by v} x_c  (coverage),  sum_c x_c <= <num of rsus>  (budget);
+// The coverage restrictions are relaxed with multipliers lambda_v in [0, 1], so the relaxation
+// takes the <num of rsus> cells of highest sum of lambda_v of the vehicles reaching them;
+typedef struct lagrangian_input_
+{
+    int number_of_rsus;
+    int contacts_time_threshold;
+
+    // Subgradient iterations per budget (--iterations);
+    int max_iterations;
+
+    // Sweep mode (--budgets): every budget is bounded in turn instead of <num of rsus>;
+    int is_sweep;
+    struct_budgets budgets;
+
+    // Solution whose optimality gap is reported (--solution), e.g. a GRASP or greedy rsus file, empty if none;
+    char solution_file_path[MAX_INPUT_FILE_PATH_SIZE + 1];
+
+    // Trace reduced in chunks of about this many MB instead of read whole (--stream), 0 to read it whole;
+    int stream_chunk_size_in_mb;
+
+    // Frequented cells of the trace;
+    struct_cell_grid grid;
+
+} struct_lagrangian_input;
+
+// Bounds after each subgradient iteration;
+typedef struct bound_log_entry_
+{
+    double lagrangian_value;
+    double upper_bound;
+    int lower_bound;
+
+} struct_bound_log_entry;
+
+typedef struct lagrangian_output_
+{
+    double execution_time;
+    int num_iterations;
+
+    // Smallest value of the relaxation, rounded down: no solution covers more vehicles;
+    double lagrangian_bound;
+    int upper_bound;
+
+    // Lagrangian heuristic: best solution built from the cells of the relaxations;
+    int solution_size;
+    struct_solution solution[MAX_NUMBER_OF_RSUS];
+    int solution_obj_f_value;
+
+    // (upper bound - coverage) / upper bound, in percent;
+    double gap;
+
+    // --solution only: coverage and gap of the given solution;
+    int input_solution_size;
+    int input_solution_obj_f_value;
+    double input_solution_gap;
+
+    // num_iterations entries;
+    struct_bound_log_entry log[];
+
+} struct_lagrangian_output;
+
+// (score, cell) pair of the relaxation's ranking;
+typedef struct ranked_cell_
+{
+    double score;
+    int cell;
+
+} struct_ranked_cell;
+
+// ==================== INPUT FUNCTIONS ==================== //
+// If succeedes, returns 0 and output_lagrangian_input can be used;
+// Otherwise, returns 1 and error_msg can be used;
+int read_commandline_args(
+    int argc, char **argv,
+    struct_lagrangian_input *output_lagrangian_input,
+    char* output_input_file_path, char* output_error_msg
+);
+
+int try_to_get_positive_int_from_arg(
+    char* arg, char* var_name,
+    int* output,
+    char* output_error_msg
+);
+
+// Options are "--name value" pairs accepted anywhere among the positional arguments;
+// If succeedes, returns 0 and the option's value is stored in output_lagrangian_input;
+// Otherwise, returns 1 and error_msg can be used;
+int read_commandline_option(
+    char* name, char* value,
+    struct_lagrangian_input *output_lagrangian_input,
+    char* output_error_msg
+);
+
+// Reads "x,y" lines, as written by every solver's rsus file;
+// Cells no record reaches have no dense cell and are stored with cell -1;
+// If succeedes, returns 0 and output_solution can be used;
+// Otherwise, returns 1 and error_msg can be used;
+int read_solution_file(
+    const char* solution_file_path,
+    struct_cell_grid *grid,
+    struct_solution *output_solution, int *output_solution_size,
+    char* output_error_msg
+);
+// ==================== INPUT FUNCTIONS ==================== //
+
+
+// ==================== LAGRANGIAN FUNCTIONS ================= //
+// Subgradient search over the multipliers of the coverage restrictions;
+// input_solution (input_solution_size RSUs) is scored against the bound, NULL for none;
+// If succeedes, returns 0 and output_lagrangian_output can be used;
+// Otherwise, returns 1 and error_msg can be used;
+int lagrangian(
+    struct_coverage_indexes *indexes,
+    struct_lagrangian_input lagrangian_input,
+    struct_solution *input_solution, int input_solution_size,
+    struct_lagrangian_output* output_lagrangian_output,
+    char* output_error_msg
+);
+
+// Decreasing score, then increasing cell id (row-major order);
+int compare_ranked_cells(const void* a, const void* b);
+
+// Takes cells in ranking order, skipping the ones that cover no new vehicle, until number_of_rsus cells;
+// coverage_state must have no RSUs and is left that way;
+// Returns the coverage of the cells taken;
+int build_heuristic_solution(
+    struct_coverage_state *coverage_state,
+    struct_ranked_cell *ranking, int num_ranked_cells,
+    int number_of_rsus,
+    int *output_cells, int *output_num_cells
+);
+
+double get_gap(int upper_bound, int coverage);
+// ==================== LAGRANGIAN FUNCTIONS ================= //
+
+
+// ==================== OUTPUT FUNCTIONS ==================== //
+int write_summary_to_file(
+    struct_lagrangian_input lagrangian_input,
+    struct_lagrangian_output* lagrangian_output,
+    char* output_error_msg
+);
+
+int write_rsus_to_file(
+    struct_lagrangian_input lagrangian_input,
+    struct_solution* rsus_pos, int num_rsus,
+    char *output_error_msg
+);
+
+int write_bound_log_to_file(
+    struct_lagrangian_input lagrangian_input,
+    struct_lagrangian_output* lagrangian_output,
+    char *output_error_msg
+);
+// ==================== OUTPUT FUNCTIONS ==================== //
+
+
+int main(int argc, char** argv)
+{
+    // In case any specified error below occurs;
+    int status;
+    char error_msg[300];
+    error_msg[0] = '\0';
+
+    // ==================== 1 - READ INPUT ==================== //
+
+    const char* correct_input_format = "USAGE: lagrangian <num of rsus>"
+    " <contacts time threshold> <trace file path>"
+    " [--iterations <max subgradient iterations>] [--solution <rsus file path>]"
+    " [--budgets <min:max:step or list b1,b2,...> in place of <num of rsus>]"
+    " [--stream <chunk size in MB>]";
+
+    // -------------------- 1.1 COMMAND LINE ------------------ //
+
+    char input_file_path[MAX_INPUT_FILE_PATH_SIZE + 1];
+    input_file_path[0] = '\0';
+    struct_lagrangian_input lagrangian_input;
+    status = read_commandline_args(argc, argv, &lagrangian_input, input_file_path, error_msg);
+    if (status != 0)
+    {
+        fprintf(stderr, "LAGRANGIAN: COMMAND LINE ERROR: %s\n\n%s\n",
+        error_msg, correct_input_format);
+        return 1;
+    }
+
+    // -------------------- 1.2 TRACE FILE -------------------- //
+
+    // Coverage counts contacts up to (first record time + threshold) included,
+    // as n-deployment and results1 do, so GRASP solutions are scored as they were built;
+    struct_coverage_indexes indexes;
+    struct_trace_read_stats trace_read_stats;
+    if (lagrangian_input.stream_chunk_size_in_mb > 0)
+    {
+        // The trace is reduced chunk by chunk, it's never whole in memory;
+        struct_reduced_trace reduced_trace;
+        status = reduce_trace_in_chunks(input_file_path, (size_t) lagrangian_input.stream_chunk_size_in_mb * 1000000,
+        lagrangian_input.contacts_time_threshold, &(lagrangian_input.contacts_time_threshold), 1,
+        &reduced_trace, &trace_read_stats, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "LAGRANGIAN: INPUT TRACE FILE ERROR: %s\n", error_msg);
+            if (lagrangian_input.is_sweep)
+            {
+                free_budgets(&(lagrangian_input.budgets));
+            }
+            return 1;
+        }
+
+        printf("LAGRANGIAN: TRACE FILE: %lld lines, %.1f MB %s reduced in %d chunks of up to %d lines in %.3f s (%.1f MB/s)\n",
+        reduced_trace.size, trace_read_stats.file_size_in_bytes / 1e6,
+        trace_read_stats.is_binary_format ? "binary" : "text", reduced_trace.num_chunks, reduced_trace.max_chunk_size,
+        trace_read_stats.read_time_in_secs, trace_read_stats.throughput_in_mb_per_sec);
+
+        // Everything the bound needs is taken, the rest of the reduced trace goes;
+        lagrangian_input.grid = reduced_trace.grid;
+        indexes = reduced_trace.indexes[0];
+        free(reduced_trace.cell_records);
+        free(reduced_trace.cell_visits);
+    }
+    else
+    {
+        struct_trace trace;
+        status = read_trace(input_file_path, &trace, &trace_read_stats, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "LAGRANGIAN: INPUT TRACE FILE ERROR: %s\n", error_msg);
+            if (lagrangian_input.is_sweep)
+            {
+                free_budgets(&(lagrangian_input.budgets));
+            }
+            return 1;
+        }
+
+        printf("LAGRANGIAN: TRACE FILE: %d lines, %.1f MB %s read in %.3f s (%.1f MB/s)\n",
+        trace.size, trace_read_stats.file_size_in_bytes / 1e6,
+        trace_read_stats.is_binary_format ? "binary" : "text",
+        trace_read_stats.read_time_in_secs, trace_read_stats.throughput_in_mb_per_sec);
+
+        status = copy_cell_grid(&(trace.grid), &(lagrangian_input.grid), error_msg);
+        if (status == 0)
+        {
+            status = build_coverage_indexes(&trace, lagrangian_input.contacts_time_threshold, &indexes, error_msg);
+            if (status != 0)
+            {
+                free_cell_grid(&(lagrangian_input.grid));
+            }
+        }
+        free_trace(&trace);
+        if (status != 0)
+        {
+            fprintf(stderr, "LAGRANGIAN: MEMORY ERROR: %s\n", error_msg);
+            if (lagrangian_input.is_sweep)
+            {
+                free_budgets(&(lagrangian_input.budgets));
+            }
+            return 1;
+        }
+    }
+
+    // -------------------- 1.3 SOLUTION FILE ----------------- //
+
+    struct_solution* input_solution = NULL;
+    int input_solution_size = 0;
+    if (lagrangian_input.solution_file_path[0] != '\0')
+    {
+        input_solution = (struct_solution*) malloc(sizeof(struct_solution) * MAX_NUMBER_OF_RSUS);
+        status = (input_solution == NULL) ? 1 : read_solution_file(lagrangian_input.solution_file_path,
+        &(lagrangian_input.grid), input_solution, &input_solution_size, error_msg);
+        if (status == 0 && input_solution_size > lagrangian_input.number_of_rsus)
+        {
+            sprintf(error_msg, "solution has %d RSUs, more than <num of rsus> = %d",
+            input_solution_size, lagrangian_input.number_of_rsus);
+            status = 1;
+        }
+        if (status != 0)
+        {
+            if (input_solution == NULL)
+            {
+                strcpy(error_msg, "can't allocate memory for the solution");
+            }
+            fprintf(stderr, "LAGRANGIAN: INPUT SOLUTION FILE ERROR: %s\n", error_msg);
+            free(input_solution);
+            free_coverage_indexes(&indexes);
+            free_cell_grid(&(lagrangian_input.grid));
+            return 1;
+        }
+    }
+
+    // ==================== 2 - RUN AND WRITE RESULTS ============ //
+
+    // Sweep table: one line per budget;
+    FILE* sweep_file = NULL;
+    if (lagrangian_input.is_sweep)
+    {
+        char sweep_file_name[MAX_BUDGETS_LABEL_SIZE + 100];
+        sprintf(sweep_file_name, "rsu=%s_tau=%d_bound_sweep.csv", lagrangian_input.budgets.label,
+        lagrangian_input.contacts_time_threshold);
+
+        sweep_file = fopen(sweep_file_name, "w");
+        if (sweep_file == NULL)
+        {
+            fprintf(stderr, "LAGRANGIAN: OUTPUT SWEEP FILE ERROR: can't write sweep file\n");
+            free_coverage_indexes(&indexes);
+            free_cell_grid(&(lagrangian_input.grid));
+            free_budgets(&(lagrangian_input.budgets));
+            return 1;
+        }
+        fprintf(sweep_file, "budget,upper_bound,heuristic_obj_f_value,gap,iterations,execution_time,sweep_wall_clock_time\n");
+    }
+
+    struct timespec sweep_begin_timer;
+    clock_gettime(CLOCK_MONOTONIC, &sweep_begin_timer);
+
+    // Too big for the stack, one log entry per iteration;
+    struct_lagrangian_output* lagrangian_output = (struct_lagrangian_output*) malloc(sizeof(struct_lagrangian_output)
+    + sizeof(struct_bound_log_entry) * (size_t) lagrangian_input.max_iterations);
+    if (lagrangian_output == NULL)
+    {
+        fprintf(stderr, "LAGRANGIAN: MEMORY ERROR: can't allocate memory for the output\n");
+        status = 1;
+    }
+
+    int num_budgets = lagrangian_input.is_sweep ? lagrangian_input.budgets.num_budgets : 1;
+    int b;
+    for (b = 0; b < num_budgets && status == 0; b++)
+    {
+        if (lagrangian_input.is_sweep)
+        {
+            lagrangian_input.number_of_rsus = lagrangian_input.budgets.budgets[b];
+        }
+
+        status = lagrangian(&indexes, lagrangian_input, input_solution, input_solution_size,
+        lagrangian_output, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "LAGRANGIAN: MEMORY ERROR: %s\n", error_msg);
+            break;
+        }
+
+        printf("LAGRANGIAN: rsu=%d: upper bound %d, heuristic %d (gap %.3f%%), %d iterations in %.3f s\n",
+        lagrangian_input.number_of_rsus, lagrangian_output->upper_bound, lagrangian_output->solution_obj_f_value,
+        lagrangian_output->gap, lagrangian_output->num_iterations, lagrangian_output->execution_time);
+        if (input_solution != NULL)
+        {
+            printf("LAGRANGIAN: SOLUTION FILE: %d RSUs cover %d vehicles (gap %.3f%%)\n",
+            lagrangian_output->input_solution_size, lagrangian_output->input_solution_obj_f_value,
+            lagrangian_output->input_solution_gap);
+        }
+
+        status = write_summary_to_file(lagrangian_input, lagrangian_output, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "LAGRANGIAN: OUTPUT SUMMARY FILE ERROR: %s\n", error_msg);
+            break;
+        }
+
+        status = write_rsus_to_file(
+            lagrangian_input, lagrangian_output->solution,
+            lagrangian_output->solution_size, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "LAGRANGIAN: OUTPUT RSUS FILE ERROR: %s\n", error_msg);
+            break;
+        }
+
+        status = write_bound_log_to_file(lagrangian_input, lagrangian_output, error_msg);
+        if (status != 0)
+        {
+            fprintf(stderr, "LAGRANGIAN: OUTPUT LOG FILE ERROR: %s\n", error_msg);
+            break;
+        }
+
+        if (lagrangian_input.is_sweep)
+        {
+            struct timespec sweep_timer;
+            clock_gettime(CLOCK_MONOTONIC, &sweep_timer);
+
+            fprintf(sweep_file, "%d,%d,%d,%.06f,%d,%.06f,%.06f\n", lagrangian_input.number_of_rsus,
+            lagrangian_output->upper_bound, lagrangian_output->solution_obj_f_value, lagrangian_output->gap,
+            lagrangian_output->num_iterations, lagrangian_output->execution_time,
+            (sweep_timer.tv_sec - sweep_begin_timer.tv_sec) + (sweep_timer.tv_nsec - sweep_begin_timer.tv_nsec) / 1e9);
+        }
+    }
+
+    if (lagrangian_input.is_sweep)
+    {
+        if (status == 0)
+        {
+            struct timespec sweep_end_timer;
+            clock_gettime(CLOCK_MONOTONIC, &sweep_end_timer);
+
+            printf("LAGRANGIAN: SWEEP: %d budgets bounded in %.3f s\n", num_budgets,
+            (sweep_end_timer.tv_sec - sweep_begin_timer.tv_sec) + (sweep_end_timer.tv_nsec - sweep_begin_timer.tv_nsec) / 1e9);
+        }
+
+        fclose(sweep_file);
+        free_budgets(&(lagrangian_input.budgets));
+    }
+
+    printf("LAGRANGIAN: PEAK RSS: %.1f MB\n", get_peak_rss_in_mb());
+
+    // ==================== 3 - FREE REMAINING RESOURCES ====== //
+    free(lagrangian_output);
+    free(input_solution);
+    free_coverage_indexes(&indexes);
+    free_cell_grid(&(lagrangian_input.grid));
+
+    return status;
+}
+
+int read_commandline_args(int argc, char **argv, struct_lagrangian_input *output_lagrangian_input,
+char* output_input_file_path, char* output_error_msg)
+{
+    int status;
+
+    // ========== Split options from positional arguments; ========== //
+    output_lagrangian_input->max_iterations = DEFAULT_MAX_ITERATIONS;
+    output_lagrangian_input->is_sweep = 0;
+    output_lagrangian_input->solution_file_path[0] = '\0';
+    output_lagrangian_input->stream_chunk_size_in_mb = 0;
+
+    // argv-like: program name, then the positional arguments in order;
+    char* positional_args[NUM_POSITIONAL_ARGS + 1];
+    positional_args[0] = argv[0];
+    int num_positional_args = 0;
+    int i;
+    for (i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--", 2) == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                sprintf(output_error_msg, "option %s needs a value", argv[i]);
+                status = 1;
+            }
+            else
+            {
+                status = read_commandline_option(argv[i], argv[i + 1], output_lagrangian_input, output_error_msg);
+            }
+            if (status != 0)
+            {
+                if (output_lagrangian_input->is_sweep)
+                {
+                    free_budgets(&(output_lagrangian_input->budgets));
+                }
+                return 1;
+            }
+            i++;
+        }
+        else if (num_positional_args < NUM_POSITIONAL_ARGS)
+        {
+            positional_args[++num_positional_args] = argv[i];
+        }
+        else
+        {
+            num_positional_args = NUM_POSITIONAL_ARGS + 1;
+        }
+    }
+
+    // In sweep mode, --budgets takes the place of <num of rsus>;
+    status = 0;
+    int num_expected_args = output_lagrangian_input->is_sweep ? NUM_POSITIONAL_ARGS - 1 : NUM_POSITIONAL_ARGS;
+    if (num_positional_args != num_expected_args)
+    {
+        strcpy(output_error_msg, "wrong number of arguments");
+        status = 1;
+    }
+    else if (output_lagrangian_input->is_sweep && output_lagrangian_input->solution_file_path[0] != '\0')
+    {
+        strcpy(output_error_msg, "--solution is scored against one budget, it can't be used with --budgets");
+        status = 1;
+    }
+    if (status != 0)
+    {
+        if (output_lagrangian_input->is_sweep)
+        {
+            free_budgets(&(output_lagrangian_input->budgets));
+        }
+        return 1;
+    }
+
+    if (output_lagrangian_input->is_sweep)
+    {
+        for (i = NUM_POSITIONAL_ARGS; i > 1; i--)
+        {
+            positional_args[i] = positional_args[i - 1];
+        }
+        positional_args[1] = NULL;
+    }
+    argv = positional_args;
+
+    // ========== Try to convert all arguments to correct numeric values; ========== //
+
+    if (!output_lagrangian_input->is_sweep)
+    {
+        status = try_to_get_positive_int_from_arg(argv[1], "<num of rsus>",
+        &(output_lagrangian_input->number_of_rsus), output_error_msg);
+        if (status != 0)
+        {
+            return 1;
+        }
+        if (output_lagrangian_input->number_of_rsus > MAX_NUMBER_OF_RSUS)
+        {
+            sprintf(output_error_msg, "number of RSUs must be at most %d", MAX_NUMBER_OF_RSUS);
+            return 1;
+        }
+    }
+
+    status = try_to_get_positive_int_from_arg(argv[2], "<contacts time threshold>",
+    &(output_lagrangian_input->contacts_time_threshold), output_error_msg);
+    if (status == 0 && strlen(argv[3]) > MAX_INPUT_FILE_PATH_SIZE)
+    {
+        sprintf(output_error_msg, "file path is bigger than %d bytes", MAX_INPUT_FILE_PATH_SIZE);
+        status = 1;
+    }
+    if (status != 0)
+    {
+        if (output_lagrangian_input->is_sweep)
+        {
+            free_budgets(&(output_lagrangian_input->budgets));
+        }
+        return 1;
+    }
+
+    // ========== try to get input file path ========== //
+    strcpy(output_input_file_path, argv[3]);
+
+    return 0;
+}
+
+int read_commandline_option(char* name, char* value,
+struct_lagrangian_input *output_lagrangian_input, char* output_error_msg)
+{
+    if (strcmp(name, "--iterations") == 0)
+    {
+        return try_to_get_positive_int_from_arg(value, "--iterations",
+        &(output_lagrangian_input->max_iterations), output_error_msg);
+    }
+
+    if (strcmp(name, "--budgets") == 0)
+    {
+        if (output_lagrangian_input->is_sweep)
+        {
+            strcpy(output_error_msg, "option --budgets given twice");
+            return 1;
+        }
+
+        int status = parse_budgets(value, MAX_NUMBER_OF_RSUS, &(output_lagrangian_input->budgets), output_error_msg);
+        if (status != 0)
+        {
+            return 1;
+        }
+        output_lagrangian_input->is_sweep = 1;
+
+        return 0;
+    }
+
+    if (strcmp(name, "--solution") == 0)
+    {
+        if (strlen(value) > MAX_INPUT_FILE_PATH_SIZE)
+        {
+            sprintf(output_error_msg, "solution file path is bigger than %d bytes", MAX_INPUT_FILE_PATH_SIZE);
+            return 1;
+        }
+
+        strcpy(output_lagrangian_input->solution_file_path, value);
+        return 0;
+    }
+
+    if (strcmp(name, "--stream") == 0)
+    {
+        return try_to_get_positive_int_from_arg(value, "--stream",
+        &(output_lagrangian_input->stream_chunk_size_in_mb), output_error_msg);
+    }
+
+    sprintf(output_error_msg, "unknown option %s", name);
+    return 1;
+}
+
+// Get int from command line argument;
+// IMPORTANT: Assumes int is big enough for converted value;
+int try_to_get_positive_int_from_arg(char* arg, char* var_name, int* output,
+char* output_error_msg)
+{
+    int value = atoi(arg);
+    if (value <= 0)
+    {
+        sprintf(output_error_msg, "%s must be a positive integer", var_name);
+        return 1;
+    }
+
+    *output = value;
+
+    return 0;
+}
+
+int read_solution_file(const char* solution_file_path, struct_cell_grid *grid,
+struct_solution *output_solution, int *output_solution_size, char* output_error_msg)
+{
+    FILE* solution_file = fopen(solution_file_path, "r");
+    if (solution_file == NULL)
+    {
+        sprintf(output_error_msg, "can't open file \"%s\"", solution_file_path);
+        return 1;
+    }
+
+    int solution_size = 0;
+    int line_number = 0;
+    char line[100];
+    while (fgets(line, sizeof(line), solution_file) != NULL)
+    {
+        line_number++;
+
+        int x, y;
+        if (line[0] == '\n' || line[0] == '\r' || line[0] == '\0')
+        {
+            continue;
+        }
+        if (sscanf(line, "%d,%d", &x, &y) != 2)
+        {
+            sprintf(output_error_msg, "line %d is not \"x,y\"", line_number);
+            fclose(solution_file);
+            return 1;
+        }
+        if (solution_size == MAX_NUMBER_OF_RSUS)
+        {
+            sprintf(output_error_msg, "more than %d RSUs", MAX_NUMBER_OF_RSUS);
+            fclose(solution_file);
+            return 1;
+        }
+
+        output_solution[solution_size].x = x;
+        output_solution[solution_size].y = y;
+        output_solution[solution_size].cell = get_cell_id(grid, x, y);
+        solution_size++;
+    }
+
+    fclose(solution_file);
+
+    *output_solution_size = solution_size;
+
+    return 0;
+}
+
+int lagrangian(
+    struct_coverage_indexes *indexes,
+    struct_lagrangian_input lagrangian_input,
+    struct_solution *input_solution, int input_solution_size,
+    struct_lagrangian_output* output_lagrangian_output,
+    char* output_error_msg)
+{
+    struct_vehicle_cells_index* vehicle_cells = &(indexes->vehicle_cells);
+    struct_cell_vehicles_index* cell_vehicles = &(indexes->cell_vehicles);
+    int num_vehicles = vehicle_cells->num_vehicles;
+    int num_cells = cell_vehicles->num_cells;
+    int number_of_rsus = lagrangian_input.number_of_rsus;
+
+    struct_coverage_state coverage_state;
+    int status = init_coverage_state(indexes, 1, &coverage_state, output_error_msg);
+    if (status != 0)
+    {
+        return 1;
+    }
+
+    double* multiplier = (double*) malloc(sizeof(double) * (size_t) (num_vehicles > 0 ? num_vehicles : 1));
+    // RSUs of the relaxation's solution reaching each vehicle;
+    int* num_reaching_rsus = (int*) calloc((size_t) (num_vehicles > 0 ? num_vehicles : 1), sizeof(int));
+    struct_ranked_cell* ranking = (struct_ranked_cell*) malloc(sizeof(struct_ranked_cell) * (size_t) (num_cells > 0 ? num_cells : 1));
+    int* heuristic_cells = (int*) malloc(sizeof(int) * MAX_NUMBER_OF_RSUS);
+    if (!multiplier || !num_reaching_rsus || !ranking || !heuristic_cells)
+    {
+        sprintf(output_error_msg, "can't allocate memory for the multipliers of %d vehicles", num_vehicles);
+        free(multiplier);
+        free(num_reaching_rsus);
+        free(ranking);
+        free(heuristic_cells);
+        free_coverage_state(&coverage_state);
+        return 1;
+    }
+
+    struct timespec begin_timer;
+    clock_gettime(CLOCK_MONOTONIC, &begin_timer);
+
+    int i, v, c, e;
+
+    // The given solution is a lower bound the step sizes can aim at from the start;
+    int lower_bound = 0;
+    output_lagrangian_output->input_solution_size = input_solution_size;
+    output_lagrangian_output->input_solution_obj_f_value = 0;
+    if (input_solution != NULL)
+    {
+        for (i = 0; i < input_solution_size; i++)
+        {
+            if (input_solution[i].cell >= 0) add_rsu(&coverage_state, input_solution[i].cell);
+        }
+        output_lagrangian_output->input_solution_obj_f_value = current_coverage(&coverage_state);
+        for (i = 0; i < input_solution_size; i++)
+        {
+            if (input_solution[i].cell >= 0) remove_rsu(&coverage_state, input_solution[i].cell);
+        }
+        lower_bound = output_lagrangian_output->input_solution_obj_f_value;
+    }
+
+    // Each vehicle's restriction starts evenly shared among the cells it reaches;
+    for (v = 0; v < num_vehicles; v++)
+    {
+        int num_vehicle_cells = vehicle_cells->vehicle_offsets[v + 1] - vehicle_cells->vehicle_offsets[v];
+        multiplier[v] = (num_vehicle_cells > 0) ? 1.0 / num_vehicle_cells : 0.0;
+    }
+
+    double best_lagrangian_value = (double) num_vehicles;
+    int best_solution_obj_f_value = -1;
+    double step_factor = INITIAL_STEP_FACTOR;
+    int num_iterations_without_improvement = 0;
+    int iteration;
+    for (iteration = 0; iteration < lagrangian_input.max_iterations; iteration++)
+    {
+        // -------- Relaxation: vehicles with multiplier < 1 are counted, cells are ranked by multipliers; -------- //
+        double lagrangian_value = 0.0;
+        for (v = 0; v < num_vehicles; v++)
+        {
+            if (multiplier[v] < 1.0) lagrangian_value += 1.0 - multiplier[v];
+        }
+
+        int num_ranked_cells = 0;
+        for (c = 0; c < num_cells; c++)
+        {
+            double score = 0.0;
+            for (e = cell_vehicles->cell_offsets[c]; e < cell_vehicles->cell_offsets[c + 1]; e++)
+            {
+                score += multiplier[ cell_vehicles->vehicle[e] ];
+            }
+            if (score > 0.0)
+            {
+                ranking[num_ranked_cells].score = score;
+                ranking[num_ranked_cells].cell = c;
+                num_ranked_cells++;
+            }
+        }
+
+        qsort(ranking, num_ranked_cells, sizeof(struct_ranked_cell), compare_ranked_cells);
+
+        int num_relaxation_rsus = (num_ranked_cells < number_of_rsus) ? num_ranked_cells : number_of_rsus;
+        for (i = 0; i < num_relaxation_rsus; i++)
+        {
+            lagrangian_value += ranking[i].score;
+        }
+
+        if (lagrangian_value < best_lagrangian_value - 1e-9)
+        {
+            best_lagrangian_value = lagrangian_value;
+            num_iterations_without_improvement = 0;
+        }
+        else if (++num_iterations_without_improvement >= STEP_FACTOR_PATIENCE)
+        {
+            step_factor /= 2;
+            num_iterations_without_improvement = 0;
+        }
+
+        // -------- Lagrangian heuristic: the ranking, skipping cells that cover no new vehicle; -------- //
+        int num_heuristic_cells;
+        int coverage = build_heuristic_solution(&coverage_state, ranking, num_ranked_cells, number_of_rsus,
+        heuristic_cells, &num_heuristic_cells);
+        if (coverage > best_solution_obj_f_value)
+        {
+            best_solution_obj_f_value = coverage;
+            output_lagrangian_output->solution_size = num_heuristic_cells;
+            for (i = 0; i < num_heuristic_cells; i++)
+            {
+                output_lagrangian_output->solution[i].cell = heuristic_cells[i];
+                output_lagrangian_output->solution[i].x = lagrangian_input.grid.cell_x[ heuristic_cells[i] ];
+                output_lagrangian_output->solution[i].y = lagrangian_input.grid.cell_y[ heuristic_cells[i] ];
+            }
+        }
+        if (best_solution_obj_f_value > lower_bound)
+        {
+            lower_bound = best_solution_obj_f_value;
+        }
+
+        output_lagrangian_output->log[iteration].lagrangian_value = lagrangian_value;
+        output_lagrangian_output->log[iteration].upper_bound = best_lagrangian_value;
+        output_lagrangian_output->log[iteration].lower_bound = lower_bound;
+
+        // Coverage is an integer, so a bound below the best solution + 1 proves it optimal;
+        if (best_lagrangian_value < lower_bound + 1 - 1e-6 || step_factor < MIN_STEP_FACTOR)
+        {
+            iteration++;
+            break;
+        }
+
+        // -------- Subgradient: (counted - reaching RSUs) of each vehicle, Polyak step towards the lower bound; -------- //
+        for (i = 0; i < num_relaxation_rsus; i++)
+        {
+            c = ranking[i].cell;
+            for (e = cell_vehicles->cell_offsets[c]; e < cell_vehicles->cell_offsets[c + 1]; e++)
+            {
+                num_reaching_rsus[ cell_vehicles->vehicle[e] ]++;
+            }
+        }
+
+        double subgradient_norm = 0.0;
+        for (v = 0; v < num_vehicles; v++)
+        {
+            double subgradient = ((multiplier[v] < 1.0) ? 1.0 : 0.0) - num_reaching_rsus[v];
+            // Multipliers stuck at a bound don't move, so they don't shorten the step;
+            if ((subgradient < 0 && multiplier[v] > 0.0) || (subgradient > 0 && multiplier[v] < 1.0))
+            {
+                subgradient_norm += subgradient * subgradient;
+            }
+        }
+
+        // The relaxation's solution is feasible and covers exactly the counted vehicles;
+        if (subgradient_norm == 0.0)
+        {
+            for (v = 0; v < num_vehicles; v++) num_reaching_rsus[v] = 0;
+            iteration++;
+            break;
+        }
+
+        double step = step_factor * (lagrangian_value - lower_bound) / subgradient_norm;
+        for (v = 0; v < num_vehicles; v++)
+        {
+            double subgradient = ((multiplier[v] < 1.0) ? 1.0 : 0.0) - num_reaching_rsus[v];
+            double value = multiplier[v] + step * subgradient;
+            multiplier[v] = (value < 0.0) ? 0.0 : ((value > 1.0) ? 1.0 : value);
+            num_reaching_rsus[v] = 0;
+        }
+    }
+
+    struct timespec end_timer;
+    clock_gettime(CLOCK_MONOTONIC, &end_timer);
+
+    output_lagrangian_output->execution_time = (end_timer.tv_sec - begin_timer.tv_sec)
+    + (end_timer.tv_nsec - begin_timer.tv_nsec) / 1e9;
+    output_lagrangian_output->num_iterations = iteration;
+    output_lagrangian_output->lagrangian_bound = best_lagrangian_value;
+    output_lagrangian_output->upper_bound = (int) (best_lagrangian_value + 1e-6);
+    if (output_lagrangian_output->upper_bound < lower_bound)
+    {
+        output_lagrangian_output->upper_bound = lower_bound;
+    }
+    if (best_solution_obj_f_value < 0)
+    {
+        best_solution_obj_f_value = 0;
+        output_lagrangian_output->solution_size = 0;
+    }
+    output_lagrangian_output->solution_obj_f_value = best_solution_obj_f_value;
+    output_lagrangian_output->gap = get_gap(output_lagrangian_output->upper_bound, best_solution_obj_f_value);
+    output_lagrangian_output->input_solution_gap = get_gap(output_lagrangian_output->upper_bound,
+    output_lagrangian_output->input_solution_obj_f_value);
+
+    free(multiplier);
+    free(num_reaching_rsus);
+    free(ranking);
+    free(heuristic_cells);
+    free_coverage_state(&coverage_state);
+
+    return 0;
+}
+
+int compare_ranked_cells(const void* a, const void* b)
+{
+    const struct_ranked_cell* cell_a = (const struct_ranked_cell*) a;
+    const struct_ranked_cell* cell_b = (const struct_ranked_cell*) b;
+
+    if (cell_a->score != cell_b->score)
+    {
+        return (cell_a->score > cell_b->score) ? -1 : 1;
+    }
+
+    return (cell_a->cell > cell_b->cell) - (cell_a->cell < cell_b->cell);
+}
+
+int build_heuristic_solution(struct_coverage_state *coverage_state, struct_ranked_cell *ranking, int num_ranked_cells,
+int number_of_rsus, int *output_cells, int *output_num_cells)
+{
+    int num_cells = 0;
+    int i;
+    for (i = 0; i < num_ranked_cells && num_cells < number_of_rsus; i++)
+    {
+        if (gain_if_added(coverage_state, ranking[i].cell) > 0)
+        {
+            add_rsu(coverage_state, ranking[i].cell);
+            output_cells[num_cells++] = ranking[i].cell;
+        }
+    }
+
+    int coverage = current_coverage(coverage_state);
+
+    for (i = 0; i < num_cells; i++)
+    {
+        remove_rsu(coverage_state, output_cells[i]);
+    }
+
+    *output_num_cells = num_cells;
+
+    return coverage;
+}
+
+double get_gap(int upper_bound, int coverage)
+{
+    if (upper_bound <= 0)
+    {
+        return 0.0;
+    }
+
+    return 100.0 * (upper_bound - coverage) / upper_bound;
+}
+
+int write_summary_to_file(
+    struct_lagrangian_input lagrangian_input,
+    struct_lagrangian_output* lagrangian_output,
+    char* output_error_msg)
+{
+    char output_file_name[MAX_INPUT_FILE_PATH_SIZE + 100];
+    sprintf(output_file_name, "rsu=%d_tau=%d_bound_summary.txt",
+    lagrangian_input.number_of_rsus,
+    lagrangian_input.contacts_time_threshold);
+
+    FILE *output_file = fopen(output_file_name, "w");
+    if (output_file == NULL)
+    {
+        sprintf(output_error_msg, "can't write summary file");
+        return 1;
+    }
+
+    fprintf(output_file, "==================== LAGRANGIAN RESULTS ====================\n\n");
+
+    fprintf(output_file, "-------------------- INPUT -----------------------------------\n\n");
+    fprintf(output_file, "N. RSUS: %d\n", lagrangian_input.number_of_rsus);
+    fprintf(output_file, "N. CONTACTS: 1\n");
+    fprintf(output_file, "CONTACTS TIME INTERVAL: %d\n", lagrangian_input.contacts_time_threshold);
+    fprintf(output_file, "MAX SUBGRADIENT ITERATIONS: %d\n", lagrangian_input.max_iterations);
+    if (lagrangian_input.stream_chunk_size_in_mb > 0)
+    {
+        fprintf(output_file, "TRACE STREAM CHUNK SIZE (MB): %d\n", lagrangian_input.stream_chunk_size_in_mb);
+    }
+
+    fprintf(output_file, "N. SUBGRADIENT ITERATIONS: %d\n", lagrangian_output->num_iterations);
+    fprintf(output_file, "BOUND EXECUTION TIME: %.06f\n", lagrangian_output->execution_time);
+    fprintf(output_file, "PEAK RSS SO FAR (MB): %.1f\n\n", get_peak_rss_in_mb());
+
+    fprintf(output_file, "-------------------- BOUND -----------------------------------\n\n");
+
+    fprintf(output_file, "LAGRANGIAN RELAXATION VALUE: %.06f\n", lagrangian_output->lagrangian_bound);
+    fprintf(output_file, "UPPER BOUND (N. COVERED VEHICLES): %d\n", lagrangian_output->upper_bound);
+    fprintf(output_file, "LAGRANGIAN HEURISTIC (N. COVERED VEHICLES): %d\n", lagrangian_output->solution_obj_f_value);
+    fprintf(output_file, "LAGRANGIAN HEURISTIC GAP (%%): %.06f\n", lagrangian_output->gap);
+    if (lagrangian_input.solution_file_path[0] != '\0')
+    {
+        fprintf(output_file, "SOLUTION FILE: %s\n", lagrangian_input.solution_file_path);
+        fprintf(output_file, "SOLUTION FILE N. RSUS: %d\n", lagrangian_output->input_solution_size);
+        fprintf(output_file, "SOLUTION FILE N. COVERED VEHICLES: %d\n", lagrangian_output->input_solution_obj_f_value);
+        fprintf(output_file, "SOLUTION FILE GAP (%%): %.06f\n", lagrangian_output->input_solution_gap);
+    }
+    fprintf(output_file, "\n");
+
+    fclose(output_file);
+
+    return 0;
+}
+
+int write_rsus_to_file(
+    struct_lagrangian_input lagrangian_input,
+    struct_solution* rsus_pos, int num_rsus,
+    char *output_error_msg
+)
+{
+    char output_file_name[MAX_INPUT_FILE_PATH_SIZE + 100];
+    sprintf(output_file_name, "rsu=%d_tau=%d_bound_rsus.csv",
+    lagrangian_input.number_of_rsus,
+    lagrangian_input.contacts_time_threshold);
+
+    FILE* rsus_file = fopen(output_file_name, "w");
+    if (rsus_file == NULL)
+    {
+        sprintf(output_error_msg, "can't write rsus file");
+        return 1;
+    }
+
+    int i;
+    for (i = 0; i < num_rsus; i++)
+    {
+        struct_solution pos = rsus_pos[i];
+        fprintf(rsus_file, "%d,%d\n", pos.x, pos.y);
+    }
+
+    fclose(rsus_file);
+
+    return 0;
+}
+
+int write_bound_log_to_file(
+    struct_lagrangian_input lagrangian_input,
+    struct_lagrangian_output* lagrangian_output,
+    char *output_error_msg
+)
+{
+    char output_file_name[MAX_INPUT_FILE_PATH_SIZE + 100];
+    sprintf(output_file_name, "rsu=%d_tau=%d_bound_log.csv",
+    lagrangian_input.number_of_rsus,
+    lagrangian_input.contacts_time_threshold);
+
+    FILE* log_file = fopen(output_file_name, "w");
+    if (log_file == NULL)
+    {
+        sprintf(output_error_msg, "can't write log file");
+        return 1;
+    }
+
+    int i;
+    for (i = 0; i < lagrangian_output->num_iterations; i++)
+    {
+        struct_bound_log_entry entry = lagrangian_output->log[i];
+        fprintf(log_file, "%d,%.06f,%.06f,%d\n", i,
+        entry.lagrangian_value, entry.upper_bound, entry.lower_bound);
+    }
+
+    fclose(log_file);
+
+    return 0;
+}
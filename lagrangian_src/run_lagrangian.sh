@@ -0,0 +1,38 @@
+#!/bin/bash
+INITIAL_WORKING_DIRECTORY=$(pwd)
+
+cd "$(dirname "$0")"
+
+LAGRANGIAN_DIR=.
+
+CONTACT_TIME=30
+
+INPUT_DIR=..
+INPUT_PATH="${INPUT_DIR}/6_to_8am.csv"
+
+# Convert the text trace once, every run below maps the binary trace instead of parsing it;
+COMMON_DIR=../common_src
+BIN_INPUT_PATH="${INPUT_PATH%.csv}.bin"
+if [ ! -f "$BIN_INPUT_PATH" ] || [ "$INPUT_PATH" -nt "$BIN_INPUT_PATH" ]
+then
+    $COMMON_DIR/trace-convert "$INPUT_PATH" "$BIN_INPUT_PATH" || exit 1
+fi
+INPUT_PATH="$BIN_INPUT_PATH"
+
+RESULTS_DIR=lagrangian_results
+
+MIN_N_RSUS=43
+MAX_N_RSUS=423
+N_RSUS_STEP=10
+
+rm -rf "$RESULTS_DIR"
+mkdir "$RESULTS_DIR"
+
+mkdir "${RESULTS_DIR}/rsu=[${MIN_N_RSUS}_${MAX_N_RSUS}_${N_RSUS_STEP}]"
+
+# One process for all budgets, the trace is read and indexed once;
+$LAGRANGIAN_DIR/lagrangian "$CONTACT_TIME" "$INPUT_PATH" --budgets "${MIN_N_RSUS}:${MAX_N_RSUS}:${N_RSUS_STEP}" || exit 1
+
+mv *bound_summary.txt *bound_rsus.csv *bound_log.csv "${RESULTS_DIR}/rsu=[${MIN_N_RSUS}_${MAX_N_RSUS}_${N_RSUS_STEP}]"
+# Upper bound and gap of every budget;
+mv *bound_sweep.csv "${RESULTS_DIR}"
\ No newline at end of file